@@ -282,6 +282,9 @@ struct hotCallbacks_ {
    at offset 0). (A file-based client would typically map this to function to
    ftell().)
 
+   The library buffers its OTF output and passes it to otfWriteN() in blocks
+   of up to several thousand bytes; otfWrite1() is no longer called.
+
    Feature file data input: */
 
     char *(*featTopLevelFile)(void *ctx);
@@ -388,13 +391,19 @@ struct hotReadFontOverrides_           /* Record for instructions to modify font
     {
     long syntheticWeight;
     unsigned long maxNumSubrs;
+    int cffSupplied;
 };
 
 /* hotReadFont() returns the font type via the low order bits of the psinfo
    argument. Whether the font specified Standard Encoding is also returned via
    this argument. The structure hotReadFontOverrides contains data to modify the font
    as it is read in. This currently only carries an override for the weight coordinate
-   of the built-in substitution MM font, for adding new glyphs. */
+   of the built-in substitution MM font, for adding new glyphs.
+
+   If cffSupplied is non-zero the PostScript font is not read or converted.
+   Instead, the CFF data is taken as already available through the cffSeek()
+   and cffRefill() callbacks, for example from a client cache of a previous
+   conversion of the same font with the same flags. */
 
 enum /* Font types */
 {
@@ -789,6 +798,8 @@ void hotConvert(hotCtx g);
 #define HOT_ADD_STUB_DSIG             (1 << 10)
 #define HOT_CONVERT_VERBOSE           (1 << 11)
 #define HOT_CONVERT_FINAL_NAMES       (1 << 12) /* When showing error messages, use final names rather than source names. */
+#define HOT_CONVERT_TIMING            (1 << 13) /* Report the time spent in each phase of hotConvert() */
+#define HOT_CONVERT_BENCH             (1 << 14) /* Benchmark glyph name lookups after feature compilation */
 
 /* hotFree() destroys the library context and all the resources allocated to
    it. It must be the last function called by a client of the library. */
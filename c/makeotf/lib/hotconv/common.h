@@ -92,14 +92,21 @@ extern void hotMemFree(hotCtx g, void *ptr);
         (p) = NULL;                 \
     } while (0)
 
-/* OTF I/O macros */
-#define OUT1(v) h->g->cb.otfWrite1(h->g->cb.ctx, (v))
+/* OTF I/O macros. Output is buffered in g->out and passed to the client's
+   otfWriteN() callback in blocks. */
+#define OUT1(v)                                    \
+    do {                                           \
+        hotCtx g_ = h->g;                          \
+        if (g_->out.cnt == HOT_OUT_SIZE)           \
+            hotFlushOut(g_);                       \
+        g_->out.buf[g_->out.cnt++] = (char)(v);    \
+    } while (0)
 #define OUT2(v) hotOut2(h->g, (v))
 #define OUT3(v) hotOut3(h->g, (v))
 #define OUT4(v) hotOut4(h->g, (v))
-#define OUTN(c, v) h->g->cb.otfWriteN(h->g->cb.ctx, (c), (v))
-#define TELL() h->g->cb.otfTell(h->g->cb.ctx)
-#define SEEK(o) h->g->cb.otfSeek(h->g->cb.ctx, (o))
+#define OUTN(c, v) hotOutN(h->g, (c), (v))
+#define TELL() hotTell(h->g)
+#define SEEK(o) hotSeek(h->g, (o))
 #define IN4(v) (v) = hotIn4(h->g)
 
 /* Specify scale normalized em units (1000/em) to font units */
@@ -360,6 +367,7 @@ typedef struct vheaCtx_ *vheaCtx;
 typedef struct vmtxCtx_ *vmtxCtx;
 
 #define ID_TEXT_SIZE 1024 /* Size of text buffer used to hold identifying info about the current feature for error messages. */
+#define HOT_OUT_SIZE 8192 /* Size of OTF output buffer */
 
 
 struct hotCtx_ {
@@ -400,6 +408,10 @@ struct hotCtx_ {
     char error_id_text[ID_TEXT_SIZE]; /* buffer for text identifying class and feature of error */
     short hadError;        /* Flags if error occurred */
     uint32_t convertFlags; /* flags for building final OTF. */
+    struct {               /* Buffered OTF output */
+        char buf[HOT_OUT_SIZE];
+        long cnt;
+    } out;
 };
 
 /* Functions */
@@ -409,6 +421,10 @@ void hotQuitOnError(hotCtx g);
 void hotOut2(hotCtx g, short value);
 void hotOut3(hotCtx g, int32_t value);
 void hotOut4(hotCtx g, int32_t value);
+void hotOutN(hotCtx g, long count, char *ptr);
+void hotFlushOut(hotCtx g);
+long hotTell(hotCtx g);
+void hotSeek(hotCtx g, long offset);
 
 void hotCalcSearchParams(unsigned unitSize, long nUnits,
                          unsigned short *searchRange,
@@ -13,6 +13,7 @@
 #include "GPOS.h"
 #include "OS_2.h"
 #include "dictops.h"
+#include "ctutil.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -87,6 +88,7 @@ hotCtx hotNew(hotCallbacks *hotcb) {
 
     g->hadError = 0;
     g->convertFlags = 0;
+    g->out.cnt = 0;
 
     /* Set version numbers. The hot library version serves to identify the      */
     /* software version that built an OTF font and is saved in the Version name */
@@ -364,12 +366,14 @@ char *hotReadFont(hotCtx g, int flags, int *psinfo, hotReadFontOverrides *fontOv
     if (flags & HOT_VERBOSE) {
         tcflags |= TC_VERBOSE; /* turn on all warnings and notes */
     }
-    tcSetMaxNumSubrsOverride(g->ctx.tc, fontOverride->maxNumSubrs);
-    tcSetWeightOverride(g->ctx.tc, fontOverride->syntheticWeight);
-    tcCompactFont(g->ctx.tc, tcflags);
+    if (!fontOverride->cffSupplied) {
+        tcSetMaxNumSubrsOverride(g->ctx.tc, fontOverride->maxNumSubrs);
+        tcSetWeightOverride(g->ctx.tc, fontOverride->syntheticWeight);
+        tcCompactFont(g->ctx.tc, tcflags);
 
-    if (g->cb.tmpClose) {
-        g->cb.tmpClose(g->cb.ctx); /* temporary hack to write out tmp cff file. */
+        if (g->cb.tmpClose) {
+            g->cb.tmpClose(g->cb.ctx); /* temporary hack to write out tmp cff file. */
+        }
     }
 
     /* Parse CFF data and get global font information */
@@ -966,9 +970,20 @@ void patch_cff_fontbbox(hotCtx g) {
     data[offset + 11] = (g->font.bbox.top & 0xFF);
 }
 
+/* Report time elapsed since *start for a hotConvert() phase and restart */
+static void reportPhaseTime(hotCtx g, const char *phase, double *start) {
+    double now = ctuWallTime();
+    if (g->convertFlags & HOT_CONVERT_TIMING) {
+        hotMsg(g, hotNOTE, "%s: %.3f sec", phase, now - *start);
+    }
+    *start = now;
+}
+
 /* Convert to OTF */
 void hotConvert(hotCtx g) {
     BBox old_bbox;
+    double start = ctuWallTime();
+    double featSecs;
 
     old_bbox = g->font.bbox;
     setBounds(g);
@@ -976,7 +991,18 @@ void hotConvert(hotCtx g) {
         patch_cff_fontbbox(g);
     }
     mapFill(g);
+    reportPhaseTime(g, "glyph mapping", &start);
+
     featFill(g);
+    featSecs = ctuWallTime() - start;
+    reportPhaseTime(g, "feature compilation", &start);
+    if (g->convertFlags & HOT_CONVERT_TIMING) {
+        mapReportNameLookups(g, featSecs);
+    }
+    if (g->convertFlags & HOT_CONVERT_BENCH) {
+        mapBenchNameLookups(g);
+        start = ctuWallTime(); /* Leave benchmark out of the next phase */
+    }
 
     prepWinData(g);
 
@@ -986,7 +1012,10 @@ void hotConvert(hotCtx g) {
         hotAddAnonTable(g, TAG('D', 'S', 'I', 'G'), refillDSIG);
 
     sfntFill(g);
+    reportPhaseTime(g, "table fill", &start);
+
     sfntWrite(g);
+    reportPhaseTime(g, "sfnt assembly", &start);
 
 #if HOT_DEBUG
     if (g->font.debug & HOT_DB_AFM) {
@@ -1506,25 +1535,69 @@ void CDECL hotMsg(hotCtx g, int level, const char *fmt, ...) {
     }
 }
 
+/* Pass buffered OTF output to client */
+void hotFlushOut(hotCtx g) {
+    if (g->out.cnt > 0) {
+        g->cb.otfWriteN(g->cb.ctx, g->out.cnt, g->out.buf);
+        g->out.cnt = 0;
+    }
+}
+
+/* Make room for count bytes of OTF output and return where to put them */
+static char *reserveOut(hotCtx g, long count) {
+    char *p;
+    if (g->out.cnt + count > HOT_OUT_SIZE) {
+        hotFlushOut(g);
+    }
+    p = &g->out.buf[g->out.cnt];
+    g->out.cnt += count;
+    return p;
+}
+
 /* Output OTF data as 2-byte number in big-endian order */
 void hotOut2(hotCtx g, int16_t value) {
-    g->cb.otfWrite1(g->cb.ctx, value >> 8);
-    g->cb.otfWrite1(g->cb.ctx, value);
+    unsigned char *p = (unsigned char *)reserveOut(g, 2);
+    p[0] = (unsigned char)(value >> 8);
+    p[1] = (unsigned char)value;
 }
 
 /* Output OTF data as 3-byte number in big-endian order */
 void hotOut3(hotCtx g, int32_t value) {
-    g->cb.otfWrite1(g->cb.ctx, value >> 16);
-    g->cb.otfWrite1(g->cb.ctx, value >> 8);
-    g->cb.otfWrite1(g->cb.ctx, value);
+    unsigned char *p = (unsigned char *)reserveOut(g, 3);
+    p[0] = (unsigned char)(value >> 16);
+    p[1] = (unsigned char)(value >> 8);
+    p[2] = (unsigned char)value;
 }
 
 /* Output OTF data as 4-byte number in big-endian order */
 void hotOut4(hotCtx g, int32_t value) {
-    g->cb.otfWrite1(g->cb.ctx, value >> 24);
-    g->cb.otfWrite1(g->cb.ctx, value >> 16);
-    g->cb.otfWrite1(g->cb.ctx, value >> 8);
-    g->cb.otfWrite1(g->cb.ctx, value);
+    unsigned char *p = (unsigned char *)reserveOut(g, 4);
+    p[0] = (unsigned char)(value >> 24);
+    p[1] = (unsigned char)(value >> 16);
+    p[2] = (unsigned char)(value >> 8);
+    p[3] = (unsigned char)value;
+}
+
+/* Output multiple bytes of OTF data. Blocks too big for the buffer are passed
+   straight to the client. */
+void hotOutN(hotCtx g, long count, char *ptr) {
+    if (count > HOT_OUT_SIZE / 2) {
+        hotFlushOut(g);
+        g->cb.otfWriteN(g->cb.ctx, count, ptr);
+    } else if (count > 0) {
+        memcpy(reserveOut(g, count), ptr, count);
+    }
+}
+
+/* Return current OTF output position */
+long hotTell(hotCtx g) {
+    return g->cb.otfTell(g->cb.ctx) + g->out.cnt;
+}
+
+/* Seek to OTF output offset */
+void hotSeek(hotCtx g, long offset) {
+    hotFlushOut(g);
+    g->cb.otfSeek(g->cb.ctx, offset);
 }
 
 /* Calculates the values of binary search table parameters */
@@ -1553,8 +1626,8 @@ void hotWritePString(hotCtx g, char *string) {
     if (length > 255) {
         hotMsg(g, hotFATAL, "string too long");
     }
-    g->cb.otfWrite1(g->cb.ctx, length);
-    g->cb.otfWriteN(g->cb.ctx, length, string);
+    *reserveOut(g, 1) = (char)length;
+    hotOutN(g, length, string);
 }
 
 /* Get string from SID */
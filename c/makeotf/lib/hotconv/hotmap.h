@@ -31,6 +31,8 @@ void mapAddUVS(hotCtx g, char *uvsName);
 void mapMakeKern(hotCtx g);
 void mapMakeVert(hotCtx g);
 void mapPrintAFM(hotCtx g);
+void mapReportNameLookups(hotCtx g, double secs);
+void mapBenchNameLookups(hotCtx g);
 
 /* Conversion functions */
 
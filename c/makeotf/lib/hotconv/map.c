@@ -22,6 +22,7 @@
 #include <limits.h>
 
 #include "pstoken.h"
+#include "ctutil.h"
 
 #define SET_BIT_ARR(a, b) (a[(b) / 32] |= 1UL << (b) % 32)
 #define TEST_BIT_ARR(a, b) (a[(b) / 32] & 1UL << (b) % 32)
@@ -275,11 +276,14 @@ struct mapCtx_ {
     struct {
         unsigned unrec; /* Num unrecognized glyph names */
         unsigned unenc; /* Num glyphs unencoded in Uni cmap */
+        unsigned long nameRefs;     /* Glyph name lookups since mapFill() */
+        unsigned long nameResolved; /* Glyph name lookups that succeeded */
     } num;
 
     /* ---- Common ---- */
     struct {
         dnaDCL(hotGlyphInfo *, gname); /* --- Sorted by glyph name/CID */
+        dnaDCL(hotGlyphInfo *, gnameHash); /* Hashed by glyph name (non-CID) */
 
         dnaDCL(hotGlyphInfo *, uv); /* --- Sorted by primary UV */
         dnaDCL(GID, glyphAddlUV);   /* GIDs that have additional UVs */
@@ -290,6 +294,8 @@ struct mapCtx_ {
         hotGlyphInfo *platEnc[256];
     } sort;
 
+    dnaDCL(short, aglHash); /* agl2uv[] index + 1, hashed by glyph name */
+
     unsigned short nSuppUV; /* num supplementary (i.e. non-BMP) UVs */
     long minBmpUV;          /* Minimum BMP UV */
     long maxBmpUV;          /* Maximum BMP UV */
@@ -302,6 +308,7 @@ struct mapCtx_ {
 /* --------------------------- Standard Functions -------------------------- */
 
 static void mapInit(hotCtx g);
+static void makeAGLHash(mapCtx h);
 
 void mapNew(hotCtx g) {
     mapCtx h = MEM_NEW(g, sizeof(struct mapCtx_));
@@ -324,6 +331,7 @@ void mapNew(hotCtx g) {
     dnaINIT(g->DnaCTX, h->uvs.entries, 15000, 500); /* Optimized for 83pv-RKSJ-H */
 
     dnaINIT(g->DnaCTX, h->sort.gname, 400, 7000);
+    dnaINIT(g->DnaCTX, h->sort.gnameHash, 1024, 16384);
     dnaINIT(g->DnaCTX, h->sort.uv, 400, 6000);
     dnaINIT(g->DnaCTX, h->sort.glyphAddlUV, 10, 60);
     h->sort.firstAddlUV = UV_UNDEF;
@@ -336,6 +344,12 @@ void mapNew(hotCtx g) {
 
     dnaINIT(g->DnaCTX, h->str, 2400, 3600);
 
+    dnaINIT(g->DnaCTX, h->aglHash, 2048, 2048);
+    makeAGLHash(h);
+
+    h->num.nameRefs = 0;
+    h->num.nameResolved = 0;
+
     /* Link contexts */
     h->g = g;
     g->ctx.map = h;
@@ -411,15 +425,102 @@ static int CDECL cmpUnrecGlyphName(const void *first, const void *second) {
 }
 #endif
 
+/* --- Glyph name hash tables */
+
+/* Glyph name lookups go through open-addressed hash tables whose size is a
+   power of 2 at least twice the number of entries, so that the linear probe
+   chains stay short. */
+
+static long nameHashSize(long cnt) {
+    long size = 64;
+    while (size < cnt * 2) {
+        size *= 2;
+    }
+    return size;
+}
+
+/* Build hash of final glyph names. Called once the glyph names are set */
+static void makeGlyphNameHash(hotCtx g) {
+    mapCtx h = g->ctx.map;
+    long mask = nameHashSize(g->font.glyphs.cnt) - 1;
+    long i;
+
+    dnaSET_CNT(h->sort.gnameHash, mask + 1);
+    memset(h->sort.gnameHash.array, 0,
+           sizeof(hotGlyphInfo *) * h->sort.gnameHash.cnt);
+
+    for (i = 0; i < g->font.glyphs.cnt; i++) {
+        hotGlyphInfo *gi = &g->font.glyphs.array[i];
+        long j = ctuHashName(gi->gname.str) & mask;
+        hotGlyphInfo *slot;
+
+        while ((slot = h->sort.gnameHash.array[j]) != NULL) {
+            if (strcmp(slot->gname.str, gi->gname.str) == 0) {
+                break; /* Keep first of duplicate names */
+            }
+            j = (j + 1) & mask;
+        }
+        if (slot == NULL) {
+            h->sort.gnameHash.array[j] = gi;
+        }
+    }
+}
+
+static hotGlyphInfo *lookupGlyphName(mapCtx h, const char *gname) {
+    long mask = h->sort.gnameHash.cnt - 1;
+    long j;
+    hotGlyphInfo *slot;
+
+    if (h->sort.gnameHash.cnt == 0) {
+        return NULL;
+    }
+    j = ctuHashName(gname) & mask;
+    while ((slot = h->sort.gnameHash.array[j]) != NULL) {
+        if (strcmp(slot->gname.str, gname) == 0) {
+            return slot;
+        }
+        j = (j + 1) & mask;
+    }
+    return NULL;
+}
+
+/* Build hash of the static AGL table; it never changes so this is done once
+   per context */
+static void makeAGLHash(mapCtx h) {
+    long mask = nameHashSize(ARRAY_LEN(agl2uv)) - 1;
+    long i;
+
+    dnaSET_CNT(h->aglHash, mask + 1);
+    memset(h->aglHash.array, 0, sizeof(short) * h->aglHash.cnt);
+
+    for (i = 0; i < (long)ARRAY_LEN(agl2uv); i++) {
+        long j = ctuHashName(agl2uv[i].glyphName) & mask;
+        while (h->aglHash.array[j] != 0) {
+            j = (j + 1) & mask;
+        }
+        h->aglHash.array[j] = (short)(i + 1);
+    }
+}
+
+static UnicodeChar *lookupAGLName(mapCtx h, const char *gname) {
+    long mask = h->aglHash.cnt - 1;
+    long j = ctuHashName(gname) & mask;
+
+    while (h->aglHash.array[j] != 0) {
+        UnicodeChar *uc = &agl2uv[h->aglHash.array[j] - 1];
+        if (strcmp(uc->glyphName, gname) == 0) {
+            return uc;
+        }
+        j = (j + 1) & mask;
+    }
+    return NULL;
+}
+
 static int CDECL cmpGlyphName(const void *a, const void *b) {
     return strcmp((*(hotGlyphInfo **)a)->gname.str,
                   (*(hotGlyphInfo **)b)->gname.str);
 }
 
-static int CDECL matchGlyphName(const void *key, const void *value) {
-    return strcmp((char *)key, (*(hotGlyphInfo **)value)->gname.str);
-}
-
 /* Map glyph name to glyph info. If useAliasDB is non-NULL and glyph alias db
    is present, it considers gname as an alias and uses the "real" name from
    the glyph alias db and sets *useAliasDB to that name. If useAliasDB is
@@ -427,7 +528,7 @@ static int CDECL matchGlyphName(const void *key, const void *value) {
 hotGlyphInfo *mapName2Glyph(hotCtx g, const char *gname, char **useAliasDB) {
     mapCtx h = g->ctx.map;
     const char *realName = gname;
-    hotGlyphInfo **found;
+    hotGlyphInfo *gi;
 
     if (IS_CID(g) && useAliasDB == NULL) {
         hotMsg(g, hotFATAL, "Not a non-CID font");
@@ -445,21 +546,30 @@ hotGlyphInfo *mapName2Glyph(hotCtx g, const char *gname, char **useAliasDB) {
         }
     }
 
+    h->num.nameRefs++;
     if (IS_CID(g)) {
         CID cid = 0;
         sscanf(realName, "cid%hd", &cid);
         if (cid == 0)
             return NULL;
-        return mapCID2Glyph(g, cid);
-    }
-    found = (hotGlyphInfo **)bsearch((char *)realName, h->sort.gname.array,
-                                     h->sort.gname.cnt, sizeof(hotGlyphInfo *),
-                                     matchGlyphName);
-    if (found != NULL) {
-        return *found;
+        gi = mapCID2Glyph(g, cid);
     } else {
-        return NULL;
+        gi = lookupGlyphName(h, realName);
+    }
+    if (gi != NULL) {
+        h->num.nameResolved++;
     }
+    return gi;
+}
+
+/* Report the glyph name references resolved since mapFill() (i.e. by the
+   feature file). secs is the time spent in feature compilation. */
+void mapReportNameLookups(hotCtx g, double secs) {
+    mapCtx h = g->ctx.map;
+
+    hotMsg(g, hotNOTE, "glyph name references: %lu (%lu resolved, %.0f/sec)",
+           h->num.nameRefs, h->num.nameResolved,
+           secs > 0 ? h->num.nameResolved / secs : 0);
 }
 
 void mapGID2Name(hotCtx g, GID gid, char *msg) {
@@ -1397,9 +1507,7 @@ static int CDECL cmpGlyphNameUC(const void *key, const void *value) {
 }
 
 static UnicodeChar *getUVFromAGL(hotCtx g, char *glyphName, int fatalErr) {
-    UnicodeChar *found =
-        (UnicodeChar *)bsearch(glyphName, agl2uv, ARRAY_LEN(agl2uv),
-                               sizeof(UnicodeChar), cmpGlyphNameUC);
+    UnicodeChar *found = lookupAGLName(g->ctx.map, glyphName);
 
     if (found == NULL && fatalErr) {
         hotMsg(g, hotFATAL, "glyphName <%s> not found in internal tables",
@@ -1409,6 +1517,87 @@ static UnicodeChar *getUVFromAGL(hotCtx g, char *glyphName, int fatalErr) {
     return found;
 }
 
+/* --- Glyph name lookup benchmark */
+
+/* Look up gname for the benchmark. Return 0 if it wasn't found. */
+typedef int (*NameLookup)(hotCtx g, const char *gname);
+
+static int CDECL matchGlyphName(const void *key, const void *value) {
+    return strcmp((char *)key, (*(hotGlyphInfo **)value)->gname.str);
+}
+
+static int aglHashLookup(hotCtx g, const char *gname) {
+    return lookupAGLName(g->ctx.map, gname) != NULL;
+}
+
+static int aglSortLookup(hotCtx g, const char *gname) {
+    return bsearch(gname, agl2uv, ARRAY_LEN(agl2uv), sizeof(UnicodeChar),
+                   cmpGlyphNameUC) != NULL;
+}
+
+static int fontHashLookup(hotCtx g, const char *gname) {
+    return lookupGlyphName(g->ctx.map, gname) != NULL;
+}
+
+static int fontSortLookup(hotCtx g, const char *gname) {
+    mapCtx h = g->ctx.map;
+    return bsearch(gname, h->sort.gname.array, h->sort.gname.cnt,
+                   sizeof(hotGlyphInfo *), matchGlyphName) != NULL;
+}
+
+/* Time lookups of names[0..cnt-1], repeated until the run lasts long enough
+   to be measured, and report the rate */
+static void benchNameLookups(hotCtx g, const char *set, const char *method,
+                             char **names, long cnt, NameLookup lookup) {
+    double start = ctuWallTime();
+    double secs = 0;
+    long n = 0;
+
+    while (secs < 0.05) {
+        long i;
+        for (i = 0; i < cnt; i++) {
+            if (!lookup(g, names[i])) {
+                hotMsg(g, hotFATAL, "glyph name lookup failed <%s>", names[i]);
+            }
+        }
+        n += cnt;
+        secs = ctuWallTime() - start;
+    }
+    hotMsg(g, hotNOTE, "glyph name lookup (%s, %s): %ld in %.3f sec (%.0f/sec)",
+           set, method, n, secs, n / secs);
+}
+
+/* Benchmark glyph name lookups through the name hashes against a binary
+   search of the sorted names, for the AGL names and for the font's glyph
+   names */
+void mapBenchNameLookups(hotCtx g) {
+    mapCtx h = g->ctx.map;
+    long cnt = ARRAY_LEN(agl2uv);
+    char **names;
+    long i;
+
+    if (h->sort.gname.cnt > cnt) {
+        cnt = h->sort.gname.cnt;
+    }
+    names = MEM_NEW(g, sizeof(char *) * cnt);
+
+    for (i = 0; i < (long)ARRAY_LEN(agl2uv); i++) {
+        names[i] = agl2uv[i].glyphName;
+    }
+    benchNameLookups(g, "AGL", "hash", names, i, aglHashLookup);
+    benchNameLookups(g, "AGL", "bsearch", names, i, aglSortLookup);
+
+    if (!IS_CID(g) && h->sort.gname.cnt > 0) {
+        for (i = 0; i < h->sort.gname.cnt; i++) {
+            names[i] = h->sort.gname.array[i]->gname.str;
+        }
+        benchNameLookups(g, "font", "hash", names, i, fontHashLookup);
+        benchNameLookups(g, "font", "bsearch", names, i, fontSortLookup);
+    }
+
+    MEM_FREE(g, names);
+}
+
 /* Checks if gname is of the form uni<CODE> or u<CODE>. If it is, returns 1 and
    sets *usv to the <CODE> */
 static int checkUniGName(hotCtx g, char *gn, uint32_t *usv) {
@@ -2607,6 +2796,10 @@ int mapFill(hotCtx g) {
     }
 #endif
 
+    /* Count glyph name references from the feature file onwards */
+    h->num.nameRefs = 0;
+    h->num.nameResolved = 0;
+
     return 1;
 }
 
@@ -2667,6 +2860,10 @@ static void initGlyphs(hotCtx g) {
     qsort(h->sort.gname.array, h->sort.gname.cnt, sizeof(hotGlyphInfo *),
           IS_CID(g) ? cmpCID : cmpGlyphName);
 
+    if (!IS_CID(g)) {
+        makeGlyphNameHash(g);
+    }
+
     /* Make custom cmap, if applicable */
     /*
     if (!IS_CID(g) && g->font.Encoding != FI_STD_ENC)
@@ -2762,6 +2959,7 @@ void mapReuse(hotCtx g) {
     }
 
     h->sort.gname.cnt = 0;
+    h->sort.gnameHash.cnt = 0;
     h->sort.uv.cnt = 0;
     h->sort.glyphAddlUV.cnt = 0;
     h->sort.firstAddlUV = UV_UNDEF;
@@ -2773,6 +2971,9 @@ void mapReuse(hotCtx g) {
     h->maxBmpUV = LONG_MIN;
 
     h->str.cnt = 0;
+
+    h->num.nameRefs = 0;
+    h->num.nameResolved = 0;
 }
 
 void mapFree(hotCtx g) {
@@ -2791,6 +2992,7 @@ void mapFree(hotCtx g) {
     }
 
     dnaFREE(h->sort.gname);
+    dnaFREE(h->sort.gnameHash);
     dnaFREE(h->sort.uv);
     dnaFREE(h->sort.glyphAddlUV);
 
@@ -338,6 +338,7 @@ void sfntWrite(hotCtx g) {
     /* Write head table checksum adjustment */
     SEEK(start + offset);
     OUT4(0xb1b0afba - sum);
+    hotFlushOut(g);
 }
 
 void sfntReuse(hotCtx g) {
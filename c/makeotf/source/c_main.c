@@ -15,6 +15,7 @@
 #include HOTCONV
 
 #include "cb.h"
+#include "ctutil.h"
 #include "file.h"
 
 #include "lstdlib.h"
@@ -28,6 +29,8 @@
 
 #include "setjmp.h"
 
+#include <errno.h>
+
 jmp_buf mark;
 
 #define MAKEOTF_VERSION "2.6.0"
@@ -44,12 +47,13 @@ static char *progname; /* Program name */
 static cbCtx cbctx;    /* Client callback context */
 
 /* Conversion data */
-static struct {
+static struct convertData_ {
     struct { /* Directory paths */
         char pfb[FILENAME_MAX + 1];
         char otf[FILENAME_MAX + 1];
         char cmap[FILENAME_MAX + 1];
         char feat[FILENAME_MAX + 1];
+        char cache[FILENAME_MAX + 1];
     } dir;
     int fontDone;
     char *features;
@@ -77,6 +81,25 @@ static struct {
     dnaDCL(char *, args); /* Argument list */
 } script;
 
+/* Batch build data */
+typedef struct {
+    long iArg; /* Index of first argument in batch.args */
+    long nArgs; /* Argument count */
+} BatchJob;
+
+typedef struct { /* Batch job result */
+    int built;   /* Font built */
+    double secs; /* Build time */
+} BatchResult;
+
+static struct {
+    char *file;             /* Batch file name; NULL if not in batch mode */
+    int workers;            /* Maximum number of concurrent builds */
+    char *buf;              /* Input buffer */
+    dnaDCL(char *, args);   /* Argument list for all jobs */
+    dnaDCL(BatchJob, jobs); /* Per-font build specs */
+} batch;
+
 /* Split font set file into arg list */
 static void makeArgs(char *filename) {
     int state;
@@ -155,6 +178,92 @@ static void makeArgs(char *filename) {
     }
 }
 
+/* Add job for args batch.args[iArg...] if any */
+static void addBatchJob(long iArg) {
+    if (batch.args.cnt > iArg) {
+        BatchJob *job = dnaNEXT(batch.jobs);
+        job->iArg = iArg;
+        job->nArgs = batch.args.cnt - iArg;
+    }
+}
+
+/* Split batch file into per-font jobs. Each non-blank line specifies the
+   arguments for building one font using the same syntax as a script file. */
+static void readBatch(char *filename) {
+    int state;
+    long i;
+    long length;
+    long iArg = 0;
+    File file;
+    char *start = NULL; /* Suppress optimizer warning */
+
+    /* Read whole file into buffer */
+    fileOpen(&file, cbctx, filename, "rb");
+    fileSeek(&file, 0, SEEK_END);
+
+    length = fileTell(&file);
+    batch.buf = malloc(length + 1);
+    if (batch.buf == NULL)
+        cbFatal(cbctx, "out of memory");
+
+    fileSeek(&file, 0, SEEK_SET);
+    fileReadN(&file, length, batch.buf);
+    fileClose(&file);
+
+    batch.buf[length] = '\n'; /* Ensure termination */
+
+    /* Parse buffer into jobs */
+    state = 0;
+    for (i = 0; i < length + 1; i++) {
+        int c = batch.buf[i];
+        int eol = c == '\n' || c == '\r';
+        switch (state) {
+            case 0:
+                if (eol) {
+                    addBatchJob(iArg);
+                    iArg = batch.args.cnt;
+                } else if (c == '#') {
+                    state = 1;
+                } else if (c == '"') {
+                    start = &batch.buf[i + 1];
+                    state = 2;
+                } else if (!isspace(c)) {
+                    start = &batch.buf[i];
+                    state = 3;
+                }
+                break;
+
+            case 1: /* Comment */
+                if (eol) {
+                    addBatchJob(iArg);
+                    iArg = batch.args.cnt;
+                    state = 0;
+                }
+                break;
+
+            case 2: /* Quoted string */
+                if (c == '"') {
+                    batch.buf[i] = '\0'; /* Terminate string */
+                    *dnaNEXT(batch.args) = start;
+                    state = 0;
+                }
+                break;
+
+            case 3: /* Space-delimited string */
+                if (isspace(c)) {
+                    batch.buf[i] = '\0'; /* Terminate string */
+                    *dnaNEXT(batch.args) = start;
+                    if (eol) {
+                        addBatchJob(iArg);
+                        iArg = batch.args.cnt;
+                    }
+                    state = 0;
+                }
+                break;
+        }
+    }
+}
+
 /* Print usage information */
 static void printUsage(void) {
     printf(
@@ -190,6 +299,10 @@ static void printUsage(void) {
         "-ga/-nga : Quick mode. Use/do not use the GlyphOrderAndAliasDB file to\n"
         "    rename and re-order glyphs. Default is to not do the renaming and\n"
         "    re-ordering. If used after -r, -nga overrides the default -r setting.\n"
+        "-gfi <path> : Same as -gf, but read the GlyphOrderAndAliasDB file through a\n"
+        "    compiled binary index, <path>.idx, which is loaded without parsing\n"
+        "    and provides hashed name lookups. The index is created, or rebuilt\n"
+        "    when the GlyphOrderAndAliasDB file has changed, automatically.\n"
         "-gs : Omit from the font any glyphs that are not in the GOADB file\n"
         "-S/-nS : Turn subroutinization on/off. If '-ns' is used after -r, it\n"
         "    overrides the default -r setting. Default is no subroutinization, except\n"
@@ -243,6 +356,31 @@ static void printUsage(void) {
         "    non-zero left side kern classes. Using the optimization saves hundreds\n"
         "    to thousands of bytes and is the default behavior, but causes kerning to\n"
         "    not be seen by some applications.\n"
+        "-memOut : Assemble the output font in memory and write it to the output\n"
+        "    file in a single operation, rather than writing it to the file\n"
+        "    incrementally.\n"
+        "-cache <dir> : Cache the CFF data converted from the source font in\n"
+        "    directory <dir>. When the source font, the GlyphOrderAndAliasDB file\n"
+        "    and the conversion options are unchanged from a previous build, the\n"
+        "    cached CFF data is reused and only the features and the other OpenType\n"
+        "    tables are rebuilt. Warnings from the source font conversion are not\n"
+        "    repeated when the cache is used.\n"
+        "-batch <path> : Build all the fonts listed in the batch file <path>, one\n"
+        "    font per line. Each line holds the options for one font, such as\n"
+        "    '-f <path> -o <path> -ff <path>', using the same syntax as a script\n"
+        "    file. The options on the command line apply to every font, and the\n"
+        "    FontMenuNameDB and GlyphOrderAndAliasDB files given there are read\n"
+        "    only once and shared by all the builds. The build time of each font\n"
+        "    and the overall throughput are reported.\n"
+        "-workers <n> : With -batch, build up to <n> fonts concurrently in separate\n"
+        "    worker processes. Default is 1.\n"
+        "-time : Report the time spent in each phase of the build, whether the CFF\n"
+        "    cache was used, and the output size and throughput.\n"
+        "-bench : Time repeated lookups of every name in the GlyphOrderAndAliasDB\n"
+        "    file, in the AGL and in the font, and report the lookup rates. The\n"
+        "    font and AGL names are looked up both through their hash tables and\n"
+        "    by binary search. This adds work to the build and is meant for\n"
+        "    measurement only.\n"
         "-V : Show warnings about common, but usually not problematic, issues such as\n"
         "    a glyph having conflicting GDEF classes because it is used in more than\n"
         "    one class type in a layout table. Example: a glyph used as a base in one\n"
@@ -295,6 +433,8 @@ static void convFont(char *pfbfile, char *otffile) {
     }
 }
 
+static void runBatch(void);
+
 /* Parse argument list */
 static void parseArgs(int argc, char *argv[], int inScript) {
     int i;
@@ -361,10 +501,32 @@ static void parseArgs(int argc, char *argv[], int inScript) {
                         break;
 
                     case 'b':
+                        if (!strcmp(arg, "-bench")) {
+                            convert.otherflags |= OTHERFLAGS_BENCH;
+                            break;
+                        }
+                        if (!strcmp(arg, "-batch")) {
+                            if (argsleft == 0) {
+                                showUsage();
+                            }
+                            if (inScript) {
+                                cbFatal(cbctx, "can't use -batch in a script or batch file");
+                            }
+                            batch.file = argv[++i];
+                            break;
+                        }
                         convert.otherflags |= OTHERFLAGS_ISWINDOWSBOLD;
                         break;
 
                     case 'c': /* Adobe CMap directory */
+                        if (!strcmp(arg, "-cache")) {
+                            if (argsleft == 0) {
+                                showUsage();
+                            }
+                            dircpy(convert.dir.cache, argv[++i]);
+                            cbSetCacheDir(cbctx, convert.dir.cache);
+                            break;
+                        }
                         switch (arg[2]) {
                             case '\0': /* [-c] CMap directory */
                                 if (argsleft == 0) {
@@ -486,6 +648,14 @@ static void parseArgs(int argc, char *argv[], int inScript) {
                     case 'g': /* Glyph name alias database */
                         switch (arg[2]) {
                             case 'f': /* [-c] CMap directory */
+                                if (arg[3] == 'i' && arg[4] == '\0') {
+                                    /* [-gfi] Use compiled alias database index */
+                                    if (argsleft == 0) {
+                                        showUsage();
+                                    }
+                                    cbAliasDBReadIndexed(cbctx, argv[++i]);
+                                    break;
+                                }
                                 if (arg[3] != '\0' || argsleft == 0) {
                                     showUsage();
                                 }
@@ -518,6 +688,10 @@ static void parseArgs(int argc, char *argv[], int inScript) {
                         break;
 
                     case 'm': /* Font conversion database */
+                        if (!strcmp(arg, "-memOut")) {
+                            convert.otherflags |= OTHERFLAGS_MEMORY_OUTPUT;
+                            break;
+                        }
                         switch (arg[2]) {
                             case 'f': /* [-c] CMap directory */
                                 if (arg[3] != '\0' || argsleft == 0) {
@@ -700,12 +874,31 @@ static void parseArgs(int argc, char *argv[], int inScript) {
                         showUsage();
                         break;
 
+                    case 'w':
+                        if (strcmp(arg, "-workers")) {
+                            cbFatal(cbctx, "unrecognized option (%s)", arg);
+                        } else if (argsleft == 0) {
+                            showUsage();
+                        }
+                        batch.workers = atoi(argv[++i]);
+                        if (batch.workers < 1) {
+                            cbFatal(cbctx, "the number of workers must be at least 1 (%s)", argv[i]);
+                        }
+                        break;
+
                     case 'V':
                         convert.flags |= HOT_VERBOSE;              // controls warnings during parsing/conversion to CFF
                         convert.otherflags |= OTHERFLAGS_VERBOSE;  // controls warnings during feature file processing
                         break;
 
                     case 't':
+                        if (!strcmp(arg, "-time")) {
+                            convert.otherflags |= OTHERFLAGS_TIMING;
+                            break;
+                        }
+                        showHelp();
+                        break;
+
                     case 'h':
                         showHelp();
                         break;
@@ -739,12 +932,132 @@ static void parseArgs(int argc, char *argv[], int inScript) {
         }
     }
     if (!convert.fontDone) {
-        convFont(pfbfile, outputOTFfilename);
+        if (batch.file != NULL) {
+            runBatch();
+        } else {
+            convFont(pfbfile, outputOTFfilename);
+        }
     }
 
     convert.fontDone = 1;
 }
 
+/* Return source font name of batch job for reporting */
+static char *batchJobName(BatchJob *job) {
+    long i;
+    char **args = &batch.args.array[job->iArg];
+    for (i = 0; i < job->nArgs - 1; i++) {
+        if (!strcmp(args[i], "-f")) {
+            return args[i + 1];
+        }
+    }
+    return "font.ps";
+}
+
+/* Report result of batch job */
+static void reportBatchJob(long i, BatchResult *result) {
+    char text[FILENAME_MAX + 128];
+    char *name = batchJobName(&batch.jobs.array[i]);
+    if (result->built) {
+        sprintf(text, "[%ld/%ld] built <%s> in %.3f sec", i + 1,
+                batch.jobs.cnt, name, result->secs);
+        message(cbctx, hotNOTE, text);
+    } else {
+        sprintf(text, "[%ld/%ld] failed <%s>", i + 1, batch.jobs.cnt, name);
+        message(cbctx, hotERROR, text);
+    }
+}
+
+/* Build font for batch job. The options from the command line that precede
+   -batch apply to every job and any databases they read are shared; the
+   options on the job's line apply to that job only, so they are put back
+   afterwards. */
+static void buildBatchJob(long i, BatchResult *result) {
+    BatchJob *job = &batch.jobs.array[i];
+    struct convertData_ saved = convert;
+    double start = ctuWallTime();
+
+    parseArgs(job->nArgs, &batch.args.array[job->iArg], 1);
+    convert = saved;
+    result->secs = ctuWallTime() - start;
+    result->built = 1;
+}
+
+/* [ctuJobFunc] Build font for batch job in worker process. A fatal error ends
+   the worker, and another worker takes the remaining jobs. */
+static void CTL_CDECL batchJob(long index, void *result, void *ctx) {
+    buildBatchJob(index, (BatchResult *)result);
+}
+
+/* Build fonts one after another in this process, when worker processes can't
+   be used. Return the number of fonts built. */
+static long buildBatchInProcess(BatchResult *results) {
+    jmp_buf jobMark;
+    volatile long i;
+
+    for (i = 0; i < batch.jobs.cnt; i++) {
+        cbSetJobMark(cbctx, &jobMark);
+        if (setjmp(jobMark)) {
+            /* The shared library context isn't reusable after a fatal
+               error, so the remaining jobs can't be built */
+            break;
+        }
+        buildBatchJob(i, &results[i]);
+    }
+    cbSetJobMark(cbctx, NULL);
+    return i;
+}
+
+/* Build all fonts listed in the batch file */
+static void runBatch(void) {
+    BatchResult *results;
+    double start;
+    double secs;
+    long built;
+    long i;
+    char text[128];
+
+    readBatch(batch.file);
+    if (batch.jobs.cnt == 0) {
+        cbFatal(cbctx, "no fonts specified in batch file [%s]", batch.file);
+    }
+    batch.file = NULL; /* Jobs build their fonts rather than the batch */
+
+    results = calloc(batch.jobs.cnt, sizeof(BatchResult));
+    if (results == NULL) {
+        cbFatal(cbctx, "out of memory");
+    }
+
+    /* Jobs run in worker processes, even one at a time, so that a failing
+       build is reported and the remaining fonts are still built. Each worker
+       inherits the already-read databases from this process. */
+    start = ctuWallTime();
+    built = ctuRunJobs(batch.jobs.cnt, batch.workers, CTU_JOBS_KEEP_GOING,
+                       batchJob, sizeof(BatchResult), results, NULL);
+    if (built < 0) {
+        if (errno != ENOSYS) {
+            cbWarning(cbctx, "can't start batch worker <%s>", strerror(errno));
+        } else if (batch.workers > 1) {
+            cbWarning(cbctx, "concurrent batch builds are not supported on this platform");
+        }
+        built = buildBatchInProcess(results);
+    }
+    secs = ctuWallTime() - start;
+
+    for (i = 0; i < batch.jobs.cnt; i++) {
+        reportBatchJob(i, &results[i]);
+    }
+    free(results);
+
+    sprintf(text, "built %ld of %ld fonts in %.3f sec (%.2f fonts/sec)",
+            built, batch.jobs.cnt, secs, secs > 0 ? built / secs : 0.0);
+    message(cbctx, hotNOTE, text);
+    if (built < batch.jobs.cnt) {
+        cbFatal(cbctx, "%ld of %ld batch builds failed",
+                batch.jobs.cnt - built, batch.jobs.cnt);
+    }
+}
+
 /*Used to parse the parameter string passed in by python
  * start is the start index and is updated to the beginning of the next substring
  */
@@ -851,10 +1164,17 @@ int c_main(int argc, char *argv[]) {
     script.buf = NULL;
     dnaINIT(mainDnaCtx, script.args, 100, 500);
 
+    batch.file = NULL;
+    batch.workers = 1;
+    batch.buf = NULL;
+    dnaINIT(mainDnaCtx, batch.args, 100, 500);
+    dnaINIT(mainDnaCtx, batch.jobs, 20, 100);
+
     convert.dir.pfb[0] = '\0';
     convert.dir.otf[0] = '\0';
     convert.dir.cmap[0] = '\0';
     convert.dir.feat[0] = '\0';
+    convert.dir.cache[0] = '\0';
     convert.features = NULL;
     convert.hCMap = NULL;
     convert.vCMap = NULL;
@@ -870,6 +1190,9 @@ int c_main(int argc, char *argv[]) {
     /* Clean up */
     free(script.buf);
     dnaFREE(script.args);
+    free(batch.buf);
+    dnaFREE(batch.args);
+    dnaFREE(batch.jobs);
     cbFree(cbctx);
 
     return 0;
@@ -30,7 +30,18 @@ extern jmp_buf mark;
 #include "systemspecific.h"
 #undef _DEBUG
 #include "ctutil.h"
+#include "sha1.h"
 #include <errno.h>
+#include <time.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define HAVE_MMAP 1
+#endif
 
 #define FEATUREDIR "features"
 
@@ -56,6 +67,11 @@ extern jmp_buf mark;
 #include <sys\stat.h>
 #endif
 
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#endif
+
 /*extern char *font_encoding;
   extern int font_serif;
  */
@@ -67,13 +83,28 @@ typedef struct {
     dnaDCL(char, data); /* Data */
 } AnonInfo;
 
-typedef struct { /* Alias name record */
-    long iKey;   /* Alias name key index */
-    long iFinal; /* Final name index */
-    long iUV;    /* UV override name index */
-    long iOrder; /* order index */
+typedef struct { /* Alias name record (as stored in the compiled index) */
+    uint32_t iKey;   /* Alias name key index */
+    uint32_t iFinal; /* Final name index */
+    uint32_t iUV;    /* UV override name index */
+    uint32_t iOrder; /* order index */
 } AliasRec;
 
+typedef struct { /* Alias database tables used for lookups. These point into
+                    the dna arrays of a parsed text file or directly into the
+                    data of a compiled index file. */
+    AliasRec *aliasRecs;  /* Records sorted by alias name */
+    long nAlias;
+    AliasRec *finalRecs;  /* Records sorted by final name */
+    long nFinal;
+    uint32_t *aliasSlots; /* Hash index of aliasRecs by alias name */
+    long nAliasSlots;
+    uint32_t *finalSlots; /* Hash index of finalRecs by final name */
+    long nFinalSlots;
+    char *names;          /* Name strings */
+    long nNames;
+} AliasTables;
+
 /* tc library client callback context */
 struct cbCtx_ {
     char *progname; /* Program name */
@@ -100,6 +131,10 @@ struct cbCtx_ {
     struct { /* OTF file input/output */
         File file;
         char buf[BUFSIZ];
+        int inMemory;      /* Assemble OTF in memory and write on close */
+        dnaDCL(char, mem); /* In-memory OTF data */
+        long posn;         /* Current in-memory position */
+        double secs;       /* Wall time spent in output callbacks and close */
     } otf;
 
     struct {                 /* Feature file input */
@@ -128,14 +163,21 @@ struct cbCtx_ {
         unsigned short syntaxVersion;
     } fcdb;
 
-    struct {                    /* Glyph name aliasing database */
-        dnaDCL(AliasRec, recs); /* Alias name records */
-        dnaDCL(char, names);    /* Name string buffer */
+    struct {                     /* Glyph name aliasing database */
+        dnaDCL(AliasRec, recs);  /* Alias name records */
+        dnaDCL(char, names);     /* Name string buffer */
+        dnaDCL(uint32_t, index); /* Hash index of recs by alias name */
+        AliasTables tab;         /* Tables used for lookups */
+        void *idxData;           /* Compiled index file data, or NULL */
+        size_t idxSize;          /* Compiled index file size */
         int useFinalNames;
+        int fromIndexFile;       /* Loaded from compiled index file */
+        double loadTime;         /* Load time (seconds) */
     } alias;
 
-    struct {                    /* Glyph name aliasing database */
-        dnaDCL(AliasRec, recs); /* final name records */
+    struct {                     /* Glyph name aliasing database */
+        dnaDCL(AliasRec, recs);  /* final name records */
+        dnaDCL(uint32_t, index); /* Hash index of recs by final name */
     } final;
 
     char *matchkey; /* Temporary lookup key for match functions */
@@ -144,18 +186,23 @@ struct cbCtx_ {
         char *pfb;
         char *otf;
         char *cmap;
+        char *cache; /* Converted CFF cache; NULL if not caching */
     } dir;
 
     dnaDCL(char, tmpbuf); /* Temporary buffer */
     hotMacData mac;       /* Mac-specific data from database */
+    jmp_buf *jobMark;     /* Failure exit for in-process batch job; NULL if none */
 };
 
 /* ----------------------------- Error Handling ---------------------------- */
 
 /* [hot callback] Fatal exception handler */
 void myfatal(void *ctx) {
+    cbCtx h = ctx;
+    if (h->jobMark != NULL) {
+        longjmp(*h->jobMark, 1); /* Fail batch job, not the whole run */
+    }
     if (!KeepGoing) {
-        cbCtx h = ctx;
         /*This seems to cause all kinds of crashes on Windows and OSX*/
         /* hotFree(h->hot.ctx);*/ /* Free library context */
 
@@ -308,6 +355,11 @@ static char *psConvFont(cbCtx h, int flags, char *filename, int *psinfo, hotRead
     int b1;
     char *FontName;
 
+    if (fontOverrides->cffSupplied) {
+        /* CFF data already loaded from cache; source font isn't read */
+        return hotReadFont(h->hot.ctx, flags, psinfo, fontOverrides);
+    }
+
     fileOpen(&h->ps.file, h, filename, "rb");
 
     /* Determine font file type */
@@ -394,38 +446,129 @@ static char *otfId(void *ctx) {
     return h->otf.file.name;
 }
 
+/* Grow in-memory OTF data to accommodate count bytes at the current position
+   and return the address to write them. Any gap left by a seek beyond the end
+   of the data is zero-filled, matching file semantics. */
+static char *otfMemReserve(cbCtx h, long count) {
+    long cnt = h->otf.mem.cnt;
+    if (h->otf.posn + count > cnt) {
+        dnaSET_CNT(h->otf.mem, h->otf.posn + count);
+        if (h->otf.posn > cnt) {
+            memset(&h->otf.mem.array[cnt], 0, h->otf.posn - cnt);
+        }
+    }
+    return &h->otf.mem.array[h->otf.posn];
+}
+
 /* [hot callback] Write single byte to output file (errors checked on close) */
 static void otfWrite1(void *ctx, int c) {
     cbCtx h = ctx;
-    fileWrite1(&h->otf.file, c);
+    if (h->otf.inMemory) {
+        *otfMemReserve(h, 1) = c;
+        h->otf.posn++;
+    } else {
+        fileWrite1(&h->otf.file, c);
+    }
 }
 
 /* [hot callback] Write multiple bytes to output file (errors checked on
    close) */
 static void otfWriteN(void *ctx, long count, char *ptr) {
     cbCtx h = ctx;
-    fileWriteN(&h->otf.file, count, ptr);
+    double start = ctuWallTime();
+    if (h->otf.inMemory) {
+        if (count > 0) {
+            memcpy(otfMemReserve(h, count), ptr, count);
+            h->otf.posn += count;
+        }
+    } else {
+        fileWriteN(&h->otf.file, count, ptr);
+    }
+    h->otf.secs += ctuWallTime() - start;
 }
 
 /* [hot callback] Return current file position */
 static long otfTell(void *ctx) {
     cbCtx h = ctx;
+    if (h->otf.inMemory) {
+        return h->otf.posn;
+    }
     return fileTell(&h->otf.file);
 }
 
 /* [hot callback] Seek to offset */
 static void otfSeek(void *ctx, long offset) {
     cbCtx h = ctx;
-    fileSeek(&h->otf.file, offset, SEEK_SET);
+    double start = ctuWallTime();
+    if (h->otf.inMemory) {
+        if (offset < 0) {
+            cbFatal(h, "invalid seek offset (%ld) [%s]", offset, h->otf.file.name);
+        }
+        h->otf.posn = offset;
+    } else {
+        fileSeek(&h->otf.file, offset, SEEK_SET);
+    }
+    h->otf.secs += ctuWallTime() - start;
 }
 
 /* [hot callback] Refill data buffer from file */
 static char *otfRefill(void *ctx, long *count) {
     cbCtx h = ctx;
+    double start;
+    if (h->otf.inMemory) {
+        /* Return all remaining data in a single block */
+        char *data = &h->otf.mem.array[h->otf.posn];
+        *count = (h->otf.posn < h->otf.mem.cnt) ? h->otf.mem.cnt - h->otf.posn : 0;
+        h->otf.posn += *count;
+        return data;
+    }
+    start = ctuWallTime();
     *count = fileReadN(&h->otf.file, BUFSIZ, h->otf.buf);
+    h->otf.secs += ctuWallTime() - start;
     return h->otf.buf;
 }
 
+/* Open OTF output file. In memory mode the data is accumulated in h->otf.mem
+   and nothing is written to the file until otfClose(). */
+static void otfOpen(cbCtx h, char *otfpath, int inMemory) {
+    h->otf.inMemory = inMemory;
+    h->otf.mem.cnt = 0;
+    h->otf.posn = 0;
+    h->otf.secs = 0;
+    fileOpen(&h->otf.file, h, otfpath, inMemory ? "wb" : "w+b");
+}
+
+/* Flush in-memory OTF data with a single write, close file, and optionally
+   report output throughput. The time reported is the wall time spent in the
+   output callbacks and in closing the file, not that of the whole build. */
+static void otfClose(cbCtx h, int verbose) {
+    long size;
+    double start = ctuWallTime();
+    double secs;
+
+    if (h->otf.inMemory) {
+        size = h->otf.mem.cnt;
+        fileWriteN(&h->otf.file, size, h->otf.mem.array);
+        h->otf.inMemory = 0;
+    } else {
+        fileSeek(&h->otf.file, 0, SEEK_END);
+        size = fileTell(&h->otf.file);
+    }
+    fileClose(&h->otf.file);
+    secs = h->otf.secs + ctuWallTime() - start;
+
+    if (verbose) {
+        char str[FILENAME_MAX + 128];
+        if (secs > 0) {
+            sprintf(str, "Wrote %ld bytes in %.3f sec (%.0f bytes/sec) [%s]",
+                    size, secs, size / secs, h->otf.file.name);
+        } else {
+            sprintf(str, "Wrote %ld bytes [%s]", size, h->otf.file.name);
+        }
+        message(h, hotNOTE, str);
+    }
+}
+
 /* -------------------------- Feature file input --------------------------- */
 
 static char *featTopLevelFile(void *ctx) {
@@ -850,6 +993,110 @@ static int CDECL cmpFinalAlias(const void *first, const void *second, void *ctx)
     return strcmp(&h->alias.names.array[alias1->iFinal], &h->alias.names.array[alias2->iFinal]);
 }
 
+/* Return hash index size for cnt records: a power of 2 at least twice the
+   record count, so linear probing sequences stay short */
+static long aliasIndexSize(long cnt) {
+    long size = 16;
+    while (size < cnt * 2) {
+        size *= 2;
+    }
+    return size;
+}
+
+/* Fill open-addressing hash index of alias records keyed by the name at
+   offset iKey (byKey != 0) or iFinal. Each slot holds a record index + 1, or
+   0 if empty. If a name occurs more than once the first record is used. */
+static void aliasIndexFill(cbCtx h, uint32_t *index, long size,
+                           AliasRec *recs, long cnt, int byKey) {
+    long i;
+
+    memset(index, 0, size * sizeof(uint32_t));
+    for (i = 0; i < cnt; i++) {
+        char *gname = &h->alias.names.array[byKey ? recs[i].iKey : recs[i].iFinal];
+        unsigned long j = ctuHashName(gname) & (size - 1);
+        for (;;) {
+            long slot = index[j];
+            if (slot == 0) {
+                index[j] = i + 1;
+                break;
+            }
+            slot--;
+            if (!strcmp(gname, &h->alias.names.array[byKey ? recs[slot].iKey : recs[slot].iFinal])) {
+                break; /* Duplicate name */
+            }
+            j = (j + 1) & (size - 1);
+        }
+    }
+}
+
+/* Build alias and final name hash indexes and point the lookup tables at
+   the parsed database */
+static void aliasIndexBuild(cbCtx h) {
+    AliasTables *tab = &h->alias.tab;
+
+    dnaSET_CNT(h->alias.index, aliasIndexSize(h->alias.recs.cnt));
+    aliasIndexFill(h, h->alias.index.array, h->alias.index.cnt,
+                   h->alias.recs.array, h->alias.recs.cnt, 1);
+    dnaSET_CNT(h->final.index, aliasIndexSize(h->final.recs.cnt));
+    aliasIndexFill(h, h->final.index.array, h->final.index.cnt,
+                   h->final.recs.array, h->final.recs.cnt, 0);
+
+    tab->aliasRecs = h->alias.recs.array;
+    tab->nAlias = h->alias.recs.cnt;
+    tab->finalRecs = h->final.recs.array;
+    tab->nFinal = h->final.recs.cnt;
+    tab->aliasSlots = h->alias.index.array;
+    tab->nAliasSlots = h->alias.index.cnt;
+    tab->finalSlots = h->final.index.array;
+    tab->nFinalSlots = h->final.index.cnt;
+    tab->names = h->alias.names.array;
+    tab->nNames = h->alias.names.cnt;
+}
+
+/* Look up record by alias name */
+static AliasRec *aliasIndexFindAlias(cbCtx h, const char *gname) {
+    AliasTables *tab = &h->alias.tab;
+    long size = tab->nAliasSlots;
+    unsigned long j;
+
+    if (tab->nAlias == 0) {
+        return NULL;
+    }
+    for (j = ctuHashName(gname) & (size - 1);; j = (j + 1) & (size - 1)) {
+        uint32_t slot = tab->aliasSlots[j];
+        AliasRec *rec;
+        if (slot == 0) {
+            return NULL;
+        }
+        rec = &tab->aliasRecs[slot - 1];
+        if (!strcmp(gname, &tab->names[rec->iKey])) {
+            return rec;
+        }
+    }
+}
+
+/* Look up record by final name */
+static AliasRec *aliasIndexFindFinal(cbCtx h, const char *gname) {
+    AliasTables *tab = &h->alias.tab;
+    long size = tab->nFinalSlots;
+    unsigned long j;
+
+    if (tab->nFinal == 0) {
+        return NULL;
+    }
+    for (j = ctuHashName(gname) & (size - 1);; j = (j + 1) & (size - 1)) {
+        uint32_t slot = tab->finalSlots[j];
+        AliasRec *rec;
+        if (slot == 0) {
+            return NULL;
+        }
+        rec = &tab->finalRecs[slot - 1];
+        if (!strcmp(gname, &tab->names[rec->iFinal])) {
+            return rec;
+        }
+    }
+}
+
 /* Parse glyph name aliasing file.
 
    Glyph Name Aliasing Database File Format
@@ -913,9 +1160,9 @@ void cbAliasDBRead(cbCtx h, char *filename) {
     long lineno;
     long iOrder = -1;
     char buf[maxLineLen];
+    double start = ctuWallTime();
 
-    h->alias.recs.cnt = 0;
-    h->final.recs.cnt = 0;
+    cbAliasDBCancel(h);
 
     fileOpen(&file, h, filename, "r");
     for (lineno = 1; fileGetLine(&file, buf, maxLineLen) != NULL; lineno++) {
@@ -1068,6 +1315,9 @@ void cbAliasDBRead(cbCtx h, char *filename) {
              cmpAlias, h);
     ctuQSort(h->final.recs.array, h->final.recs.cnt, sizeof(AliasRec),
              cmpFinalAlias, h);
+    aliasIndexBuild(h);
+    h->alias.fromIndexFile = 0;
+    h->alias.loadTime = ctuWallTime() - start;
 
 #if 0 /* xxx remove when fully tested */
     {
@@ -1082,33 +1332,345 @@ void cbAliasDBRead(cbCtx h, char *filename) {
 #endif
 }
 
+/* ------------------- Compiled GlyphOrderAndAliasDB index ------------------ */
+
+/* The compiled index is a binary image of the parsed alias database and its
+   hash indexes, stored next to the text file as <filename>.idx. It is laid
+   out as 32-bit words in native byte order so that it can be memory-mapped
+   and used for lookups in place, without any parsing or copying:
+
+   uint32_t header[aihCount]
+   AliasRec aliasRecs[nAlias]
+   AliasRec finalRecs[nFinal]
+   uint32_t aliasSlots[nAliasSlots]
+   uint32_t finalSlots[nFinalSlots]
+   char names[nNames]
+
+   The header records the size and modification time of the text file, the
+   time to the nanosecond where the file system keeps it. The index is
+   rebuilt whenever they no longer match. */
+
+#define ALIAS_INDEX_MAGIC 0x474f4958UL /* "GOIX" (also detects byte order) */
+#define ALIAS_INDEX_VERSION 2
+
+#if defined(__APPLE__)
+#define ST_MTIME_NSEC(st) ((st)->st_mtimespec.tv_nsec)
+#elif defined(_WIN32)
+#define ST_MTIME_NSEC(st) 0
+#else
+#define ST_MTIME_NSEC(st) ((st)->st_mtim.tv_nsec)
+#endif
+
+enum {
+    aihMagic,
+    aihVersion,
+    aihSrcSize,
+    aihSrcTimeLo,
+    aihSrcTimeHi,
+    aihSrcTimeNsec,
+    aihNAlias,
+    aihNFinal,
+    aihNNames,
+    aihNAliasSlots,
+    aihNFinalSlots,
+    aihCount
+};
+
+/* Fill header fields that identify the text file */
+static void aliasIndexSetSrc(uint32_t *hdr, struct stat *src) {
+    hdr[aihSrcSize] = (uint32_t)src->st_size;
+    hdr[aihSrcTimeLo] = (uint32_t)((uint64_t)src->st_mtime & 0xffffffff);
+    hdr[aihSrcTimeHi] = (uint32_t)((uint64_t)src->st_mtime >> 32);
+    hdr[aihSrcTimeNsec] = (uint32_t)ST_MTIME_NSEC(src);
+}
+
+/* Return expected index file size from header */
+static size_t aliasIndexFileSize(uint32_t *hdr) {
+    return sizeof(uint32_t) * (aihCount + hdr[aihNAliasSlots] +
+                               (size_t)hdr[aihNFinalSlots]) +
+           sizeof(AliasRec) * (hdr[aihNAlias] + (size_t)hdr[aihNFinal]) +
+           hdr[aihNNames];
+}
+
+/* Check records in index data. Return 0 if valid, else 1. */
+static int aliasIndexCheckRecs(AliasRec *recs, long cnt, uint32_t nNames) {
+    long i;
+    for (i = 0; i < cnt; i++) {
+        if (recs[i].iKey >= nNames || recs[i].iFinal >= nNames ||
+            recs[i].iUV >= nNames) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Check hash slots in index data. Return 0 if valid, else 1. */
+static int aliasIndexCheckSlots(uint32_t *slots, long size, long cnt) {
+    long i;
+    if (size != aliasIndexSize(cnt)) {
+        return 1;
+    }
+    for (i = 0; i < size; i++) {
+        if (slots[i] > (uint32_t)cnt) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Point lookup tables into compiled index data, after checking that it
+   matches the text file and is consistent. Return 1 on success, else 0. */
+static int aliasIndexUse(cbCtx h, uint32_t *hdr, size_t size,
+                         struct stat *src) {
+    AliasTables tab;
+    uint32_t check[aihCount];
+    uint32_t *data = hdr + aihCount;
+
+    aliasIndexSetSrc(check, src);
+    if (size < aihCount * sizeof(uint32_t) ||
+        hdr[aihMagic] != ALIAS_INDEX_MAGIC ||
+        hdr[aihVersion] != ALIAS_INDEX_VERSION ||
+        hdr[aihSrcSize] != check[aihSrcSize] ||
+        hdr[aihSrcTimeLo] != check[aihSrcTimeLo] ||
+        hdr[aihSrcTimeHi] != check[aihSrcTimeHi] ||
+        hdr[aihSrcTimeNsec] != check[aihSrcTimeNsec] ||
+        size != aliasIndexFileSize(hdr)) {
+        return 0; /* Stale or not an index file */
+    }
+
+    tab.nAlias = hdr[aihNAlias];
+    tab.nFinal = hdr[aihNFinal];
+    tab.nAliasSlots = hdr[aihNAliasSlots];
+    tab.nFinalSlots = hdr[aihNFinalSlots];
+    tab.nNames = hdr[aihNNames];
+    tab.aliasRecs = (AliasRec *)data;
+    tab.finalRecs = tab.aliasRecs + tab.nAlias;
+    tab.aliasSlots = (uint32_t *)(tab.finalRecs + tab.nFinal);
+    tab.finalSlots = tab.aliasSlots + tab.nAliasSlots;
+    tab.names = (char *)(tab.finalSlots + tab.nFinalSlots);
+
+    if (aliasIndexCheckRecs(tab.aliasRecs, tab.nAlias, tab.nNames) ||
+        aliasIndexCheckRecs(tab.finalRecs, tab.nFinal, tab.nNames) ||
+        aliasIndexCheckSlots(tab.aliasSlots, tab.nAliasSlots, tab.nAlias) ||
+        aliasIndexCheckSlots(tab.finalSlots, tab.nFinalSlots, tab.nFinal) ||
+        (tab.nNames > 0 && tab.names[tab.nNames - 1] != '\0')) {
+        return 0;
+    }
+    h->alias.tab = tab;
+    return 1;
+}
+
+/* Release compiled index data */
+static void aliasIndexRelease(cbCtx h) {
+    if (h->alias.idxData == NULL) {
+        return;
+    }
+#if HAVE_MMAP
+    munmap(h->alias.idxData, h->alias.idxSize);
+#else
+    free(h->alias.idxData);
+#endif
+    h->alias.idxData = NULL;
+}
+
+/* Load database from compiled index file. The file data is kept (mapped
+   where possible) and used for lookups in place. Return 1 on success,
+   else 0. */
+static int aliasIndexLoad(cbCtx h, char *idxpath, struct stat *src) {
+    void *data;
+    size_t size;
+#if HAVE_MMAP
+    struct stat st;
+    int fd = open(idxpath, O_RDONLY);
+
+    if (fd == -1) {
+        return 0;
+    }
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+    size = st.st_size;
+    data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return 0;
+    }
+    if (!aliasIndexUse(h, data, size, src)) {
+        munmap(data, size);
+        return 0;
+    }
+#else
+    File file;
+    int valid;
+
+    if (!fileExists(idxpath)) {
+        return 0;
+    }
+    fileOpen(&file, h, idxpath, "rb");
+    fileSeek(&file, 0, SEEK_END);
+    size = fileTell(&file);
+    fileSeek(&file, 0, SEEK_SET);
+    data = malloc(size + sizeof(uint32_t));
+    if (data == NULL) {
+        cbFatal(h, "out of memory");
+    }
+    valid = fileReadN(&file, size, data) == (long)size &&
+            aliasIndexUse(h, data, size, src);
+    fileClose(&file);
+    if (!valid) {
+        free(data);
+        return 0;
+    }
+#endif
+    h->alias.idxData = data;
+    h->alias.idxSize = size;
+    return 1;
+}
+
+/* Make suffix for temporary file name that is unique among concurrent builds
+   (process id) and within this build (sequence number). */
+static void makeTmpSuffix(char *suffix) {
+    static unsigned long seq = 0;
+    sprintf(suffix, ".%lx.%lx.tmp", (unsigned long)getpid(), seq++);
+}
+
+/* Save database to compiled index file. The file is written under a
+   temporary name and renamed so that concurrent builds never map a partial
+   index. Failure to save is not fatal. */
+static void aliasIndexSave(cbCtx h, char *idxpath, struct stat *src) {
+    char tmppath[FILENAME_MAX + 1];
+    char tmpsuffix[32];
+    uint32_t hdr[aihCount];
+    File file;
+
+    makeTmpSuffix(tmpsuffix);
+    sprintf(tmppath, "%s%s", idxpath, tmpsuffix);
+    file.h = h;
+    file.name = tmppath;
+    file.fp = fopen(tmppath, "wb");
+    if (file.fp == NULL) {
+        cbWarning(h, "can't write GlyphOrderAndAliasDB index [%s]", idxpath);
+        return;
+    }
+
+    hdr[aihMagic] = ALIAS_INDEX_MAGIC;
+    hdr[aihVersion] = ALIAS_INDEX_VERSION;
+    aliasIndexSetSrc(hdr, src);
+    hdr[aihNAlias] = h->alias.recs.cnt;
+    hdr[aihNFinal] = h->final.recs.cnt;
+    hdr[aihNNames] = h->alias.names.cnt;
+    hdr[aihNAliasSlots] = h->alias.index.cnt;
+    hdr[aihNFinalSlots] = h->final.index.cnt;
+    fileWriteN(&file, sizeof(hdr), hdr);
+    fileWriteN(&file, h->alias.recs.cnt * sizeof(AliasRec), h->alias.recs.array);
+    fileWriteN(&file, h->final.recs.cnt * sizeof(AliasRec), h->final.recs.array);
+    fileWriteN(&file, h->alias.index.cnt * sizeof(uint32_t), h->alias.index.array);
+    fileWriteN(&file, h->final.index.cnt * sizeof(uint32_t), h->final.index.array);
+    fileWriteN(&file, h->alias.names.cnt, h->alias.names.array);
+    fileClose(&file);
+
+    remove(idxpath); /* rename() won't replace an existing file on Windows */
+    if (rename(tmppath, idxpath) != 0) {
+        remove(tmppath);
+        cbWarning(h, "can't write GlyphOrderAndAliasDB index [%s]", idxpath);
+    }
+}
+
+/* Read glyph name aliasing file through its compiled index, (re)building the
+   index if it is missing or older than the text file */
+void cbAliasDBReadIndexed(cbCtx h, char *filename) {
+    char idxpath[FILENAME_MAX + 1];
+    struct stat src;
+    double start = ctuWallTime();
+
+    if (strlen(filename) + 4 > FILENAME_MAX) {
+        cbFatal(h, "GlyphOrderAndAliasDB path too long [%s]", filename);
+    }
+    sprintf(idxpath, "%s.idx", filename);
+    if (stat(filename, &src) != 0) {
+        cbFatal(h, "file error <%s> [%s]", strerror(errno), filename);
+    }
+
+    cbAliasDBCancel(h);
+    if (aliasIndexLoad(h, idxpath, &src)) {
+        h->alias.fromIndexFile = 1;
+        h->alias.loadTime = ctuWallTime() - start;
+    } else {
+        cbAliasDBRead(h, filename);
+        aliasIndexSave(h, idxpath, &src);
+    }
+}
+
+/* Report alias database load time */
+static void aliasDBReportTiming(cbCtx h) {
+    char str[256];
+
+    if (h->alias.tab.nAlias == 0) {
+        return;
+    }
+    sprintf(str, "GlyphOrderAndAliasDB: %ld names loaded from %s in %.3f sec",
+            h->alias.tab.nAlias, h->alias.fromIndexFile ? "index" : "text",
+            h->alias.loadTime);
+    message(h, hotNOTE, str);
+}
+
+/* Measure alias database lookup throughput by looking up every alias and
+   final name, repeating until the run lasts long enough to be timed */
+static void aliasDBBenchLookups(cbCtx h) {
+    AliasTables *tab = &h->alias.tab;
+    char str[256];
+    double start;
+    double secs = 0;
+    long n = 0;
+
+    if (tab->nAlias == 0) {
+        return;
+    }
+    for (start = ctuWallTime(); secs < 0.05; secs = ctuWallTime() - start) {
+        long i;
+        for (i = 0; i < tab->nAlias; i++) {
+            if (aliasIndexFindAlias(h, &tab->names[tab->aliasRecs[i].iKey]) == NULL) {
+                cbFatal(h, "GlyphOrderAndAliasDB index lookup failed");
+            }
+        }
+        for (i = 0; i < tab->nFinal; i++) {
+            if (aliasIndexFindFinal(h, &tab->names[tab->finalRecs[i].iFinal]) == NULL) {
+                cbFatal(h, "GlyphOrderAndAliasDB index lookup failed");
+            }
+        }
+        n += tab->nAlias + tab->nFinal;
+    }
+    sprintf(str, "GlyphOrderAndAliasDB: %ld lookups in %.3f sec (%.0f lookups/sec)",
+            n, secs, n / secs);
+    message(h, hotNOTE, str);
+}
+
 /* used to override AliasDB when -q option is used: Usage scenario:
    default options are read in and processed from the project file, then
    the user overrides -r with -q. */
 void cbAliasDBCancel(cbCtx h) {
+    aliasIndexRelease(h);
+    memset(&h->alias.tab, 0, sizeof(h->alias.tab));
     h->alias.names.cnt = 0;
     h->alias.recs.cnt = 0;
+    h->alias.index.cnt = 0;
     h->final.recs.cnt = 0;
+    h->final.index.cnt = 0;
 }
 
 /* [hot callback] Convert alias name to final name. */
 static char *getFinalGlyphName(void *ctx, char *gname) {
     cbCtx h = ctx;
-    AliasRec *alias;
-    h->matchkey = gname;
-    alias = (AliasRec *)bsearch(h, h->alias.recs.array, h->alias.recs.cnt,
-                                sizeof(AliasRec), matchAliasRec);
-    return (alias == NULL) ? gname : &(h->alias.names.array[alias->iFinal]);
+    AliasRec *alias = aliasIndexFindAlias(h, gname);
+    return (alias == NULL) ? gname : &(h->alias.tab.names[alias->iFinal]);
 }
 
 /* [hot callback] Convert final name to src name. */
 static char *getSrcGlyphName(void *ctx, char *gname) {
     cbCtx h = ctx;
-    AliasRec *alias;
-    h->matchkey = gname;
-    alias = (AliasRec *)bsearch(h, h->final.recs.array, h->final.recs.cnt,
-                                sizeof(AliasRec), matchAliasRecByFinal);
-    return (alias == NULL) ? gname : &(h->alias.names.array[alias->iKey]);
+    AliasRec *alias = aliasIndexFindFinal(h, gname);
+    return (alias == NULL) ? gname : &(h->alias.tab.names[alias->iKey]);
 }
 
 /* [hot callback] Get UV override in form of u<UV Code> glyph name. */
@@ -1117,27 +1679,24 @@ static char *getUVOverrideName(void *ctx, char *gname) {
     AliasRec *alias;
     char *uvName = NULL;
 
-    if (h->alias.recs.cnt == 0) {
+    if (h->alias.tab.nAlias == 0) {
         return NULL;
     }
 
     /* Assume that  gname is an alias name from the GAODB. */
-    h->matchkey = gname;
     if (h->alias.useFinalNames) {
         /* Assume that gname is an final name from the GAODB. */
-        alias = (AliasRec *)bsearch(h, h->final.recs.array, h->final.recs.cnt,
-                                    sizeof(AliasRec), matchAliasRecByFinal);
+        alias = aliasIndexFindFinal(h, gname);
         if (alias != NULL) {
-            uvName = &h->alias.names.array[alias->iUV];
+            uvName = &h->alias.tab.names[alias->iUV];
             if (*uvName == '\0') {
                 uvName = NULL;
             }
         }
     } else {
-        alias = (AliasRec *)bsearch(h, h->alias.recs.array, h->alias.recs.cnt,
-                                    sizeof(AliasRec), matchAliasRec);
+        alias = aliasIndexFindAlias(h, gname);
         if (alias != NULL) {
-            uvName = &h->alias.names.array[alias->iUV];
+            uvName = &h->alias.tab.names[alias->iUV];
             if (*uvName == '\0') {
                 uvName = NULL;
             }
@@ -1150,19 +1709,15 @@ static char *getUVOverrideName(void *ctx, char *gname) {
 /* [hot callback] Get alias name and order. */
 static void getAliasAndOrder(void *ctx, char *oldName, char **newName, long int *order) {
     cbCtx h = ctx;
-    AliasRec *alias;
-    h->matchkey = oldName;
-    alias = (AliasRec *)bsearch(h, h->alias.recs.array, h->alias.recs.cnt,
-                                sizeof(AliasRec), matchAliasRec);
+    AliasRec *alias = aliasIndexFindAlias(h, oldName);
     if (alias != NULL) {
-        *newName = &h->alias.names.array[alias->iFinal];
+        *newName = &h->alias.tab.names[alias->iFinal];
         *order = alias->iOrder;
     } else {
         /* if it wasn't a "friendly" name, maybe it was already a final name */
-        alias = (AliasRec *)bsearch(h, h->final.recs.array, h->final.recs.cnt,
-                                    sizeof(AliasRec), matchAliasRecByFinal);
+        alias = aliasIndexFindFinal(h, oldName);
         if (alias != NULL) {
-            *newName = &h->alias.names.array[alias->iFinal];
+            *newName = &h->alias.tab.names[alias->iFinal];
             *order = alias->iOrder;
         } else {
             *newName = NULL;
@@ -1171,6 +1726,161 @@ static void getAliasAndOrder(void *ctx, char *oldName, char **newName, long int
     }
 }
 
+/* ---------------------------- Converted CFF cache ------------------------ */
+
+/* When a cache directory is set, the CFF data produced by converting the
+   source font is saved under a key derived from the source font data and all
+   inputs that affect the conversion. A subsequent build of the same font in
+   which only the features (or other sfnt-level data) changed then loads the
+   CFF from the cache and skips the PostScript parsing, conversion and
+   subroutinization done by hotReadFont(). */
+
+#define CFF_CACHE_MAGIC "makeotf CFF cache 1\n"
+#define CFF_CACHE_KEY_LEN (2 * sizeof(sha1_hash))
+
+static void *cacheHashMalloc(size_t size, void *hook) {
+    return malloc(size);
+}
+
+static void cacheHashFree(sha1_pctx ctx, void *hook) {
+    free(ctx);
+}
+
+/* Make cache key (hex string) from source font and conversion parameters */
+static void cacheMakeKey(cbCtx h, char *pfbpath, int flags,
+                         long addGlyphWeight, unsigned long maxNumSubrs,
+                         char *key) {
+    sha1_pctx ctx;
+    sha1_hash hash;
+    long params[4];
+    char buf[BUFSIZ];
+    size_t n;
+    File file;
+    unsigned i;
+
+    ctx = sha1_init(cacheHashMalloc, h);
+    if (ctx == NULL) {
+        cbFatal(h, "out of memory");
+    }
+
+    /* Conversion parameters */
+    params[0] = HOT_VERSION;
+    params[1] = flags & ~HOT_DB_MASK;
+    params[2] = addGlyphWeight;
+    params[3] = (long)maxNumSubrs;
+    sha1_update(ctx, (unsigned char *)params, sizeof(params));
+
+    /* Source font data */
+    fileOpen(&file, h, pfbpath, "rb");
+    while ((n = fileReadN(&file, sizeof(buf), buf)) > 0) {
+        sha1_update(ctx, (unsigned char *)buf, n);
+    }
+    fileClose(&file);
+
+    /* Glyph renaming, ordering and subsetting come from the alias database */
+    if (flags & HOT_RENAME) {
+        sha1_update(ctx, (unsigned char *)h->alias.tab.aliasRecs,
+                    h->alias.tab.nAlias * sizeof(AliasRec));
+        sha1_update(ctx, (unsigned char *)h->alias.tab.names,
+                    h->alias.tab.nNames);
+    }
+
+    sha1_finalize(ctx, cacheHashFree, hash, h);
+    for (i = 0; i < sizeof(hash); i++) {
+        sprintf(&key[i * 2], "%02x", hash[i]);
+    }
+}
+
+/* Make cache file path from key */
+static void cacheMakePath(cbCtx h, char *path, char *key, char *suffix) {
+    if (strlen(h->dir.cache) + CFF_CACHE_KEY_LEN + strlen(suffix) >= FILENAME_MAX) {
+        cbFatal(h, "CFF cache path too long [%s]", h->dir.cache);
+    }
+    sprintf(path, "%s%s%s", h->dir.cache, key, suffix);
+}
+
+/* Load CFF data from cache. Return 1 if found, else 0. */
+static int cacheLoadCFF(cbCtx h, char *key) {
+    char path[FILENAME_MAX + 1];
+    char magic[sizeof(CFF_CACHE_MAGIC) - 1];
+    File file;
+    long size;
+    int euroAdded;
+
+    cacheMakePath(h, path, key, ".cff");
+    if (!fileExists(path)) {
+        return 0;
+    }
+
+    fileOpen(&file, h, path, "rb");
+    fileSeek(&file, 0, SEEK_END);
+    size = fileTell(&file) - (long)sizeof(magic) - 1;
+    fileSeek(&file, 0, SEEK_SET);
+    if (size <= 0 ||
+        fileReadN(&file, sizeof(magic), magic) != sizeof(magic) ||
+        memcmp(magic, CFF_CACHE_MAGIC, sizeof(magic)) != 0 ||
+        (euroAdded = fileRead1(&file)) == EOF) {
+        /* Not a cache file written by us; ignore it and rebuild */
+        fileClose(&file);
+        cbWarning(h, "invalid CFF cache file ignored [%s]", path);
+        return 0;
+    }
+
+    cffSize(h, size, euroAdded);
+    if (fileReadN(&file, size, h->cff.buf.array) != size) {
+        fileError(&file);
+    }
+    fileClose(&file);
+    return 1;
+}
+
+/* Save CFF data to cache. The file is written under a temporary name and
+   renamed so that concurrent builds never see a partial cache file. */
+static void cacheSaveCFF(cbCtx h, char *key) {
+    char path[FILENAME_MAX + 1];
+    char tmppath[FILENAME_MAX + 1];
+    char tmpsuffix[32];
+    File file;
+
+    cacheMakePath(h, path, key, ".cff");
+    makeTmpSuffix(tmpsuffix);
+    cacheMakePath(h, tmppath, key, tmpsuffix);
+
+    fileOpen(&file, h, tmppath, "wb");
+    fileWriteN(&file, sizeof(CFF_CACHE_MAGIC) - 1, CFF_CACHE_MAGIC);
+    fileWrite1(&file, h->cff.euroAdded);
+    fileWriteN(&file, h->cff.buf.cnt, h->cff.buf.array);
+    fileClose(&file);
+
+    remove(path); /* rename() won't replace an existing file on Windows */
+    if (rename(tmppath, path) != 0) {
+        remove(tmppath);
+        cbWarning(h, "can't save CFF cache file [%s]", path);
+    }
+}
+
+/* Set converted CFF cache directory (including trailing separator) */
+void cbSetCacheDir(cbCtx h, char *cachedir) {
+    h->dir.cache = cachedir;
+}
+
+/* Set failure exit for in-process batch job; NULL to exit the program */
+void cbSetJobMark(cbCtx h, jmp_buf *mark) {
+    h->jobMark = mark;
+}
+
+/* Report time elapsed since *start for a cbConvert() phase and restart */
+static void reportPhaseTime(cbCtx h, long otherflags, char *phase,
+                            double *start) {
+    double now = ctuWallTime();
+    if (otherflags & OTHERFLAGS_TIMING) {
+        char str[128];
+        sprintf(str, "%s: %.3f sec", phase, now - *start);
+        message(h, hotNOTE, str);
+    }
+    *start = now;
+}
+
 /* ---------------------------- Callback Context --------------------------- */
 
 static void anonInit(void *ctx, long count, AnonInfo *ai) {
@@ -1231,6 +1941,8 @@ cbCtx cbNew(char *progname, char *pfbdir, char *otfdir,
     h->dir.pfb = pfbdir;
     h->dir.otf = otfdir;
     h->dir.cmap = cmapdir;
+    h->jobMark = NULL;
+    h->dir.cache = NULL;
 
     h->hot.cb = template; /* Copy template */
     h->hot.cb.ctx = h;
@@ -1239,6 +1951,9 @@ cbCtx cbNew(char *progname, char *pfbdir, char *otfdir,
 
     dnaINIT(mainDnaCtx, h->cff.buf, 50000, 150000);
     h->cff.euroAdded = 0;
+    dnaINIT(mainDnaCtx, h->otf.mem, 150000, 500000);
+    h->otf.inMemory = 0;
+    h->otf.posn = 0;
     h->hot.ctx = hotNew(&h->hot.cb);
     dnaINIT(mainDnaCtx, h->tmpbuf, 32, 32);
     h->mac.encoding = NULL;
@@ -1270,6 +1985,12 @@ cbCtx cbNew(char *progname, char *pfbdir, char *otfdir,
     dnaINIT(mainDnaCtx, h->alias.recs, 700, 200);
     dnaINIT(mainDnaCtx, h->alias.names, 15000, 5000);
     dnaINIT(mainDnaCtx, h->final.recs, 700, 200);
+    dnaINIT(mainDnaCtx, h->alias.index, 2048, 2048);
+    dnaINIT(mainDnaCtx, h->final.index, 2048, 2048);
+    memset(&h->alias.tab, 0, sizeof(h->alias.tab));
+    h->alias.idxData = NULL;
+    h->alias.fromIndexFile = 0;
+    h->alias.loadTime = 0;
 
     return h;
 }
@@ -1546,6 +2267,7 @@ void cbConvert(cbCtx h, int flags, char *clientVers,
     char otfpath[FILENAME_MAX + 1];
     int freeFeatName = 0;
     unsigned long hotConvertFlags = 0;
+    double start = ctuWallTime();
 
     if (otherflags & OTHERFLAGS_DO_ID2_GSUB_CHAIN_CONXT) {
         hotConvertFlags |= HOT_ID2_CHAIN_CONTXT3;
@@ -1589,8 +2311,23 @@ void cbConvert(cbCtx h, int flags, char *clientVers,
         hotConvertFlags |= HOT_CONVERT_FINAL_NAMES;
     }
 
+    if (otherflags & OTHERFLAGS_TIMING) {
+        hotConvertFlags |= HOT_CONVERT_TIMING;
+    }
+
+    if (otherflags & OTHERFLAGS_BENCH) {
+        hotConvertFlags |= HOT_CONVERT_BENCH;
+    }
+
     hotSetConvertFlags(h->hot.ctx, hotConvertFlags);
 
+    if (otherflags & OTHERFLAGS_TIMING) {
+        aliasDBReportTiming(h);
+    }
+    if (otherflags & OTHERFLAGS_BENCH) {
+        aliasDBBenchLookups(h);
+    }
+
     if (flags & HOT_RENAME) {
         h->alias.useFinalNames = 1;
     } else {
@@ -1617,10 +2354,27 @@ void cbConvert(cbCtx h, int flags, char *clientVers,
     /* Convert font to CFF */
     {
         hotReadFontOverrides fontOverrides;
+        char key[CFF_CACHE_KEY_LEN + 1];
+
         fontOverrides.syntheticWeight = addGlyphWeight;
         fontOverrides.maxNumSubrs = maxNumSubrs;
+        fontOverrides.cffSupplied = 0;
+        if (h->dir.cache != NULL) {
+            cacheMakeKey(h, pfbpath, flags, addGlyphWeight, maxNumSubrs, key);
+            fontOverrides.cffSupplied = cacheLoadCFF(h, key);
+            if (otherflags & OTHERFLAGS_TIMING) {
+                char str[128];
+                sprintf(str, "CFF cache %s [%s]",
+                        fontOverrides.cffSupplied ? "hit" : "miss", key);
+                message(h, hotNOTE, str);
+            }
+        }
         FontName = psConvFont(h, flags, pfbpath, &psinfo, &fontOverrides);
+        if (h->dir.cache != NULL && !fontOverrides.cffSupplied) {
+            cacheSaveCFF(h, key);
+        }
     }
+    reportPhaseTime(h, otherflags, "font conversion", &start);
 
     type = psinfo & HOT_TYPE_MASK;
     if (h->cff.euroAdded) {
@@ -1658,7 +2412,7 @@ void cbConvert(cbCtx h, int flags, char *clientVers,
     }
 
     // Make sure that GOADB file has been read in, if required
-    if ((flags & HOT_RENAME) && (h->alias.recs.cnt < 1) && (type != hotCID)) {
+    if ((flags & HOT_RENAME) && (h->alias.tab.nAlias < 1) && (type != hotCID)) {
         cbWarning(h, "Glyph renaming was requested, but the GlyphOrderAndAliasDB file was not specified.");
     }
 
@@ -1675,10 +2429,12 @@ void cbConvert(cbCtx h, int flags, char *clientVers,
         sprintf(otfpath, "%s%s", h->dir.otf, otffile);
     }
 
+    reportPhaseTime(h, otherflags, "font information", &start);
+
     /* Write OTF file */
-    fileOpen(&h->otf.file, h, otfpath, "w+b");
+    otfOpen(h, otfpath, (otherflags & OTHERFLAGS_MEMORY_OUTPUT) != 0);
     hotConvert(h->hot.ctx);
-    fileClose(&h->otf.file);
+    otfClose(h, (otherflags & OTHERFLAGS_TIMING) != 0);
 }
 
 // Read font conversion database
@@ -1694,6 +2450,7 @@ void cbFree(cbCtx h) {
 
     hotFree(h->hot.ctx);
     dnaFREE(h->cff.buf);
+    dnaFREE(h->otf.mem);
     dnaFREE(h->tmpbuf);
 
     // Free database resources
@@ -1703,9 +2460,12 @@ void cbFree(cbCtx h) {
     }
     dnaFREE(h->fcdb.files);
 
+    aliasIndexRelease(h);
     dnaFREE(h->alias.recs);
     dnaFREE(h->final.recs);
     dnaFREE(h->alias.names);
+    dnaFREE(h->alias.index);
+    dnaFREE(h->final.index);
 
     free(h);
 }
@@ -7,6 +7,7 @@
 #define CB_H
 
 #include <stddef.h>
+#include <setjmp.h>
 #include "dynarr.h"
 typedef struct cbCtx_ *cbCtx;
 
@@ -28,7 +29,10 @@ extern void cbConvert(cbCtx h, int flags, char *clientVers,
                       unsigned short os2Version, char *licenseID);
 
 extern void cbFCDBRead(cbCtx h, char *filename);
+extern void cbSetCacheDir(cbCtx h, char *cachedir);
+extern void cbSetJobMark(cbCtx h, jmp_buf *mark);
 extern void cbAliasDBRead(cbCtx h, char *filename);
+extern void cbAliasDBReadIndexed(cbCtx h, char *filename);
 extern void cbAliasDBCancel(cbCtx h);
 extern void cbFree(cbCtx h);
 
@@ -79,5 +83,8 @@ extern void message(void *ctx, int type, const char *text);
 #define OTHERFLAGS_ADD_STUB_DSIG (1 << 14)
 #define OTHERFLAGS_VERBOSE (1 << 15)
 #define OTHERFLAGS_FINAL_NAMES (1 << 16)
+#define OTHERFLAGS_MEMORY_OUTPUT (1 << 17) /* Assemble OTF in memory, write once */
+#define OTHERFLAGS_TIMING (1 << 18)        /* Report per-phase timing */
+#define OTHERFLAGS_BENCH (1 << 19)         /* Benchmark glyph name lookups */
 
 #endif /* CB_H */
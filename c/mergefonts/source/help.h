@@ -1,6 +1,6 @@
 "mergefonts Help\n",
 "============\n",
-"mergefonts [-cid cidfontinfo file ] [-hints] output-font-file [[glyph alias file] merge-font-file]+\n",
+"mergefonts [-cid cidfontinfo file ] [-hints] [-j n] [-time] output-font-file [[glyph alias file] merge-font-file]+\n",
 "mergefonts  [-u] [-h]\n",
 " \n",
 "This tool is based on the tx program. If the output file mode (e.g -cff, -t1,\n",
@@ -82,6 +82,16 @@
 "        source fonts. It copies the font global metrics and hint data from the\n",
 "        first font, and the glyph data and font name from the second font.\n",
 "\n",
+"-j <n>  decode the source fonts after the first in up to <n> worker\n",
+"        processes, then merge them in argument order, so the output is the\n",
+"        same as without -j. The workers only save time on a machine with\n",
+"        more than one processor core; on a single core -j is slower. Must\n",
+"        precede the output font file. Ignored on Windows.\n",
+"\n",
+"-time   report the time spent decoding, merging, and writing fonts, and\n",
+"        the number of glyph alias lookups, on stderr. Must precede the output\n",
+"        font file.\n",
+"\n",
 "[other options]\n",
 "-u              print usage\n",
 "-h              print help\n",
@@ -8,6 +8,10 @@
 
 #include "tx_shared.h"
 
+#ifndef _WIN32
+#define HAVE_FORK 1
+#endif
+
 #define MERGEFONTS_VERSION CTL_MAKE_VERSION(1, 3, 0) /* derived from tx */
 
 #ifdef __cplusplus
@@ -77,6 +81,30 @@ typedef struct {
     dnaDCL(ufoCtx, ufr);
 } sourceCtx;
 
+#if HAVE_FORK
+typedef struct { /* Worker results preceding its records */
+    long glyphs;         /* Number of recorded glyphs */
+    long codes;          /* Number of recorded encoding nodes */
+    long names;          /* Size of recorded glyph names */
+} RecCounts;
+
+typedef struct { /* Result of a decode job */
+    int done;            /* Recording written to the job's tmp file */
+    RecCounts counts;
+} DecodeResult;
+
+typedef struct { /* Source file decoded by a worker process (-j) */
+    char *srcname;                     /* Source font path */
+    FILE *fp;                          /* Worker's tmp file; closed once loaded */
+    int failed;                        /* Worker failed; file is decoded when merged */
+    RecCounts counts;                  /* Worker results */
+    dnaDCL(char, rec);                 /* Recorded glyph callbacks */
+    dnaDCL(abfGlyphInfo, glyphs);      /* Replayed glyph info; referenced by the destination font */
+    dnaDCL(abfEncoding, codes);        /* Replayed encoding nodes */
+    dnaDCL(char, names);               /* Replayed glyph names */
+} DecodeJob;
+#endif
+
 typedef struct
 {
     abfTopDict *srcTopDict;            /* current source font top dict */
@@ -98,6 +126,30 @@ typedef struct
         long cnt; /* ABF_EMPTY_ARRAY */
         long array[16];
     } XUID;
+    bool timing;       /* report phase times (-time) */
+    int fileCount;     /* number of source fonts merged */
+    int failedJobs;    /* number of source fonts workers failed to decode */
+    dnaDCL(abfGlyphInfo *, aliasGlyphs); /* Glyphs of current source font */
+    dnaDCL(long, aliasHash);  /* aliasGlyphs index + 1, hashed by name or CID */
+    long aliasLookups;        /* glyph alias entries looked up */
+    long aliasFound;          /* glyph alias entries found in alias maps */
+    double aliasMapSecs;      /* time building alias maps */
+    double readSecs;   /* time decoding source fonts in workers */
+    double mergeSecs;  /* time merging source fonts */
+    double writeSecs;  /* time writing the destination font */
+#if HAVE_FORK
+    dnaDCL(DecodeJob, jobs);           /* Worker decoded source files, indexed by fileIndex */
+    DecodeJob *job;                    /* Decoded current source file, or NULL */
+    dnaDCL(char, rec);                 /* Recorded glyph callbacks being written or replayed */
+    long recNext;                      /* Replay position in rec */
+    bool recording;                    /* Record glyph callbacks instead of merging them (worker) */
+    bool recordMsgs;                   /* Record library messages while recording glyphs */
+    bool recFailed;                    /* Glyph callback that can't be recorded was called */
+    long recGlyphs;                    /* Count of recorded glyphs */
+    long recCodes;                     /* Count of recorded encoding nodes */
+    long recNames;                     /* Count of recorded glyph name bytes */
+    size_t (*stmWrite)(ctlStreamCallbacks *cb, void *stream, size_t count, char *ptr);
+#endif
 } MergeInfo;
 
 /* -------------------------------- Options -------------------------------- */
@@ -291,6 +343,12 @@ static GAFileInfo *checkIFParentCIDCompatible(txCtx h, abfTopDict *local_top, bo
 
 static void mergeFDArray(txCtx h, abfTopDict *local_top) {
     MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+#if HAVE_FORK
+    /* A worker leaves the destination font as it found it; the font dicts
+       are merged when the recording is replayed. */
+    if (mergeInfo->recording)
+        return;
+#endif
     dnaSET_CNT(mergeInfo->newiFDArray, local_top->FDArray.cnt);
     /* This will merge the new font's new FDArray into the output font's FDArray,
        and will fill in the mergeInfo->newiFDArray.array */
@@ -306,6 +364,109 @@ static void mergeFDArray(txCtx h, abfTopDict *local_top) {
         fatal(h, "Error. Bad return from attempt to merge font dict for fonts %s.", h->src.stm.filename);
 }
 
+/* ------------------------------- Alias Map -------------------------------- */
+
+/* The glyphs of a Type 1 or CFF source font selected by a glyph alias file
+   are found through an open-addressed hash of the font's glyphs, keyed by
+   source glyph name or CID, and then fetched by tag. The hash is built once
+   per source font, from a pass over the glyphs that skips their charstrings.
+   Its size is a power of 2 at least twice the number of glyphs. */
+
+/* Hash glyph name or CID. */
+static unsigned long hashAlias(int seltype, unsigned short cid, char *gname) {
+    return (seltype == sel_by_cid) ? ctuHashCID(cid) : ctuHashName(gname);
+}
+
+/* Collect source glyph, skipping its charstring. */
+static int aliasMapBeg(abfGlyphCallbacks *cb, abfGlyphInfo *info) {
+    txCtx h = cb->indirect_ctx;
+    MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+
+    *dnaNEXT(mergeInfo->aliasGlyphs) = info;
+    return ABF_SKIP_RET;
+}
+
+/* Build alias map of current source font. Return 1 if built, or 0 if its
+   glyphs must be looked up by the source library. */
+static bool makeAliasMap(txCtx h, int seltype) {
+    MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+    abfGlyphCallbacks cb = h->cb.glyph;
+    long size = 64;
+    long mask;
+    long i;
+    int result;
+    double start = ctuWallTime();
+
+    cb.indirect_ctx = h;
+    cb.beg = aliasMapBeg;
+    mergeInfo->aliasGlyphs.cnt = 0;
+    switch (h->src.type) {
+        case src_Type1:
+            result = t1rIterateGlyphs(h->t1r.ctx, &cb);
+            break;
+        case src_OTF:
+        case src_CFF:
+            result = cfrIterateGlyphs(h->cfr.ctx, &cb);
+            break;
+        default:
+            return 0;
+    }
+    if (result)
+        fatal(h, NULL);
+
+    while (size < mergeInfo->aliasGlyphs.cnt * 2)
+        size *= 2;
+    dnaSET_CNT(mergeInfo->aliasHash, size);
+    memset(mergeInfo->aliasHash.array, 0, size * sizeof(long));
+    mask = size - 1;
+
+    for (i = 0; i < mergeInfo->aliasGlyphs.cnt; i++) {
+        abfGlyphInfo *info = mergeInfo->aliasGlyphs.array[i];
+        long j;
+
+        /* The glyphs haven't been merged yet */
+        info->flags &= ~ABF_GLYPH_SEEN;
+
+        /* Only CID-keyed glyphs are selected by CID, and only name-keyed
+           glyphs by name */
+        if (seltype == sel_by_cid) {
+            if (!(info->flags & ABF_GLYPH_CID))
+                continue;
+        } else if ((info->flags & ABF_GLYPH_CID) || info->gname.ptr == NULL)
+            continue;
+
+        for (j = hashAlias(seltype, info->cid, info->gname.ptr) & mask;
+             mergeInfo->aliasHash.array[j] != 0;
+             j = (j + 1) & mask) {
+            abfGlyphInfo *slot = mergeInfo->aliasGlyphs.array[mergeInfo->aliasHash.array[j] - 1];
+            if ((seltype == sel_by_cid) ? slot->cid == info->cid : strcmp(slot->gname.ptr, info->gname.ptr) == 0)
+                break; /* Keep first of duplicate glyphs */
+        }
+        if (mergeInfo->aliasHash.array[j] == 0)
+            mergeInfo->aliasHash.array[j] = i + 1;
+    }
+
+    mergeInfo->aliasMapSecs += ctuWallTime() - start;
+    return 1;
+}
+
+/* Look up source glyph of glyph alias entry in alias map. */
+static abfGlyphInfo *lookupAlias(txCtx h, int seltype, GAEntry *gae) {
+    MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+    unsigned short cid = (unsigned short)gae->srcCID;
+    long mask = mergeInfo->aliasHash.cnt - 1;
+    long j;
+
+    for (j = hashAlias(seltype, cid, gae->srcName) & mask;
+         mergeInfo->aliasHash.array[j] != 0;
+         j = (j + 1) & mask) {
+        abfGlyphInfo *info = mergeInfo->aliasGlyphs.array[mergeInfo->aliasHash.array[j] - 1];
+        if ((seltype == sel_by_cid) ? info->cid == cid : strcmp(info->gname.ptr, gae->srcName) == 0)
+            return info;
+    }
+    return NULL;
+}
+
 /* ---------------------------- Subset Creation ---------------------------- */
 
 static void callbackMergeGASubset(txCtx h, GAFileInfo *gaf) {
@@ -313,24 +474,544 @@ static void callbackMergeGASubset(txCtx h, GAFileInfo *gaf) {
     int i;
     long numGAEEntries = gaf->gaEntrySet.cnt;
     MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+    bool mapped;
 
     if ((gaf->gaType == gafSrcCID) || (gaf->gaType == gafBothCID))
         seltype = sel_by_cid;
     else
         seltype = sel_by_name;
 
+    mapped = makeAliasMap(h, seltype);
+
     i = 0;
     while (i < numGAEEntries) {
         GAEntry *gae;
         mergeInfo->curGAEIndex = i;
         gae = dnaINDEX(gaf->gaEntrySet, i);
-        callbackGlyph(h, seltype, (unsigned short)gae->srcCID, gae->srcName);
+        if (mapped) {
+            abfGlyphInfo *info = lookupAlias(h, seltype, gae);
+            if (info != NULL) {
+                callbackGlyph(h, sel_by_tag, info->tag, NULL);
+                mergeInfo->aliasFound++;
+            }
+        } else
+            callbackGlyph(h, seltype, (unsigned short)gae->srcCID, gae->srcName);
+        mergeInfo->aliasLookups++;
         i++;
     }
 
     /* Unlike the regular callbackSubset function, we do NOT add a not def glyph is one is missing - we add only the specified glyphs in the mapping file. */
 }
 
+/* Call the glyph callbacks for the glyphs of the current source font that are
+   to be merged: those mapped by its glyph alias file, or all of them. */
+static void emitGlyphs(txCtx h, GAFileInfo *gaf) {
+    int result = 0;
+
+    if (gaf != NULL) {
+        callbackMergeGASubset(h, gaf);
+        return;
+    }
+
+    switch (h->src.type) {
+        case src_Type1:
+            result = t1rIterateGlyphs(h->t1r.ctx, &h->cb.glyph);
+            break;
+        case src_OTF:
+        case src_CFF:
+            result = cfrIterateGlyphs(h->cfr.ctx, &h->cb.glyph);
+            break;
+        case src_SVG:
+            result = svrIterateGlyphs(h->svr.ctx, &h->cb.glyph);
+            break;
+        case src_UFO:
+            result = ufoIterateGlyphs(h->ufr.ctx, &h->cb.glyph);
+            break;
+    }
+    if (result)
+        fatal(h, NULL);
+}
+
+#if HAVE_FORK
+/* ------------------------- Recorded Glyph Callbacks ----------------------- */
+
+/* With -j, the source files after the first are decoded by worker processes
+   before they are merged. A worker runs mergeFile() for its file with glyph
+   callbacks that record each call, and any library message written while
+   the glyphs are decoded, in a buffer that is passed back in a tmp file.
+   Merging then replays the recorded calls through the merge callbacks in
+   place of decoding the glyphs again, one file at a time in argument order,
+   so the output is the same as that of a serial merge.
+
+   A recording is only used if the source library flags and glyph selection
+   it was made with match those of the merge. Otherwise, or if the worker
+   failed, the file is decoded as usual when it is merged. */
+
+enum { /* Record types */
+    rec_font,  /* Source font: RecFont */
+    rec_beg,   /* RecGlyph, glyph name, encoding codes */
+    rec_width, /* 1 float */
+    rec_move,  /* 2 floats */
+    rec_line,  /* 2 floats */
+    rec_curve, /* 6 floats */
+    rec_stem,  /* int flags, 2 floats */
+    rec_flex,  /* 13 floats */
+    rec_genop, /* int cnt, int op, cnt floats */
+    rec_seac,  /* 2 floats, int bchar, int achar */
+    rec_end,
+    rec_msg    /* long length, message text */
+};
+
+typedef struct { /* Recorded source font */
+    long flags;          /* Source library flags */
+    long size;           /* Size of the records of its glyphs that follow */
+    int isGA;            /* Glyphs selected by glyph alias file */
+    long aliasLookups;   /* Glyph alias entries looked up */
+    long aliasFound;     /* Glyph alias entries found in alias map */
+    double aliasMapSecs; /* Time building alias map */
+} RecFont;
+
+typedef struct { /* Recorded glyph */
+    abfGlyphInfo info;       /* Glyph info, with pointers reset on replay */
+    unsigned short gaeIndex; /* Glyph alias entry index */
+    long nameLen;            /* Glyph name length including null, or 0 */
+    long nCodes;             /* Number of encoding codes */
+} RecGlyph;
+
+/* Append data to record buffer. */
+static void recPut(MergeInfo *mergeInfo, const void *data, size_t size) {
+    memcpy(dnaEXTEND(mergeInfo->rec, (long)size), data, size);
+}
+
+/* Read data from record buffer. */
+static void recGet(MergeInfo *mergeInfo, void *data, size_t size) {
+    memcpy(data, &mergeInfo->rec.array[mergeInfo->recNext], size);
+    mergeInfo->recNext += (long)size;
+}
+
+/* Append record with float arguments. */
+static void recArgs(abfGlyphCallbacks *cb, int type, int cnt, const float *args) {
+    txCtx h = cb->indirect_ctx;
+    MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+
+    *dnaNEXT(mergeInfo->rec) = (char)type;
+    recPut(mergeInfo, args, cnt * sizeof(float));
+}
+
+static int recBeg(abfGlyphCallbacks *cb, abfGlyphInfo *info) {
+    txCtx h = cb->indirect_ctx;
+    MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+    abfEncoding *enc;
+    RecGlyph rec;
+
+    cb->info = info;
+
+    rec.info = *info;
+    rec.gaeIndex = mergeInfo->curGAEIndex;
+    rec.nameLen = (info->gname.ptr != NULL) ? (long)strlen(info->gname.ptr) + 1 : 0;
+    rec.nCodes = 0;
+    for (enc = &info->encoding; enc != NULL; enc = enc->next)
+        rec.nCodes++;
+
+    *dnaNEXT(mergeInfo->rec) = rec_beg;
+    recPut(mergeInfo, &rec, sizeof(rec));
+    recPut(mergeInfo, info->gname.ptr, rec.nameLen);
+    for (enc = &info->encoding; enc != NULL; enc = enc->next)
+        recPut(mergeInfo, &enc->code, sizeof(enc->code));
+
+    mergeInfo->recGlyphs++;
+    mergeInfo->recCodes += rec.nCodes - 1;
+    mergeInfo->recNames += rec.nameLen;
+
+    return ABF_CONT_RET;
+}
+
+static void recWidth(abfGlyphCallbacks *cb, float hAdv) {
+    recArgs(cb, rec_width, 1, &hAdv);
+}
+
+static void recMove(abfGlyphCallbacks *cb, float x0, float y0) {
+    float args[2];
+    args[0] = x0;
+    args[1] = y0;
+    recArgs(cb, rec_move, 2, args);
+}
+
+static void recLine(abfGlyphCallbacks *cb, float x1, float y1) {
+    float args[2];
+    args[0] = x1;
+    args[1] = y1;
+    recArgs(cb, rec_line, 2, args);
+}
+
+static void recCurve(abfGlyphCallbacks *cb,
+                     float x1, float y1,
+                     float x2, float y2,
+                     float x3, float y3) {
+    float args[6];
+    args[0] = x1;
+    args[1] = y1;
+    args[2] = x2;
+    args[3] = y2;
+    args[4] = x3;
+    args[5] = y3;
+    recArgs(cb, rec_curve, 6, args);
+}
+
+static void recStem(abfGlyphCallbacks *cb,
+                    int flags, float edge0, float edge1) {
+    txCtx h = cb->indirect_ctx;
+    MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+    float args[2];
+
+    args[0] = edge0;
+    args[1] = edge1;
+    *dnaNEXT(mergeInfo->rec) = rec_stem;
+    recPut(mergeInfo, &flags, sizeof(flags));
+    recPut(mergeInfo, args, sizeof(args));
+}
+
+static void recFlex(abfGlyphCallbacks *cb, float depth,
+                    float x1, float y1,
+                    float x2, float y2,
+                    float x3, float y3,
+                    float x4, float y4,
+                    float x5, float y5,
+                    float x6, float y6) {
+    float args[13];
+    args[0] = depth;
+    args[1] = x1;
+    args[2] = y1;
+    args[3] = x2;
+    args[4] = y2;
+    args[5] = x3;
+    args[6] = y3;
+    args[7] = x4;
+    args[8] = y4;
+    args[9] = x5;
+    args[10] = y5;
+    args[11] = x6;
+    args[12] = y6;
+    recArgs(cb, rec_flex, 13, args);
+}
+
+static void recGenop(abfGlyphCallbacks *cb, int cnt, float *args, int op) {
+    txCtx h = cb->indirect_ctx;
+    MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+
+    if (cnt < 0 || cnt > CFF2_MAX_OP_STACK) {
+        mergeInfo->recFailed = 1;
+        return;
+    }
+    *dnaNEXT(mergeInfo->rec) = rec_genop;
+    recPut(mergeInfo, &cnt, sizeof(cnt));
+    recPut(mergeInfo, &op, sizeof(op));
+    recPut(mergeInfo, args, cnt * sizeof(float));
+}
+
+static void recSeac(abfGlyphCallbacks *cb,
+                    float adx, float ady, int bchar, int achar) {
+    txCtx h = cb->indirect_ctx;
+    MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+    float args[2];
+
+    args[0] = adx;
+    args[1] = ady;
+    *dnaNEXT(mergeInfo->rec) = rec_seac;
+    recPut(mergeInfo, args, sizeof(args));
+    recPut(mergeInfo, &bchar, sizeof(bchar));
+    recPut(mergeInfo, &achar, sizeof(achar));
+}
+
+static void recEnd(abfGlyphCallbacks *cb) {
+    recArgs(cb, rec_end, 0, NULL);
+}
+
+/* Variable font glyphs aren't recorded; the worker fails instead. */
+static void recFail(abfGlyphCallbacks *cb) {
+    txCtx h = cb->indirect_ctx;
+    MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+    mergeInfo->recFailed = 1;
+}
+
+static void recMoveVF(abfGlyphCallbacks *cb, abfBlendArg *x0, abfBlendArg *y0) {
+    recFail(cb);
+}
+
+static void recCurveVF(abfGlyphCallbacks *cb,
+                       abfBlendArg *x1, abfBlendArg *y1,
+                       abfBlendArg *x2, abfBlendArg *y2,
+                       abfBlendArg *x3, abfBlendArg *y3) {
+    recFail(cb);
+}
+
+static void recStemVF(abfGlyphCallbacks *cb,
+                      int flags, abfBlendArg *edge0, abfBlendArg *edge1) {
+    recFail(cb);
+}
+
+/* Record library messages written while glyphs are being recorded; write
+   others as usual. */
+static size_t recStmWrite(ctlStreamCallbacks *cb, void *stream,
+                          size_t count, char *ptr) {
+    txCtx h = cb->direct_ctx;
+    MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+
+    if (mergeInfo->recordMsgs && ((Stream *)stream)->type == stm_Dbg) {
+        long length = (long)count;
+        *dnaNEXT(mergeInfo->rec) = rec_msg;
+        recPut(mergeInfo, &length, sizeof(length));
+        recPut(mergeInfo, ptr, count);
+        return count;
+    }
+    return mergeInfo->stmWrite(cb, stream, count, ptr);
+}
+
+/* Return flags of current source font library. */
+static long srcFlags(txCtx h) {
+    switch (h->src.type) {
+        case src_Type1:
+            return h->t1r.flags;
+        case src_SVG:
+            return h->svr.flags;
+        case src_UFO:
+            return h->ufr.flags;
+        default:
+            return h->cfr.flags;
+    }
+}
+
+/* Return debug stream of current source font library. */
+static Stream *srcDbgStream(txCtx h) {
+    switch (h->src.type) {
+        case src_Type1:
+            return &h->t1r.dbg;
+        case src_SVG:
+            return &h->svr.dbg;
+        case src_UFO:
+            return &h->ufr.dbg;
+        default:
+            return &h->cfr.dbg;
+    }
+}
+
+/* Record glyphs of current source font. */
+static void recordGlyphs(txCtx h, GAFileInfo *gaf) {
+    MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+    abfGlyphCallbacks save = h->cb.glyph;
+    abfGlyphCallbacks *cb = &h->cb.glyph;
+    long start = mergeInfo->rec.cnt;
+    RecFont font;
+
+    font.flags = srcFlags(h);
+    font.size = 0;
+    font.isGA = gaf != NULL;
+    font.aliasLookups = mergeInfo->aliasLookups;
+    font.aliasFound = mergeInfo->aliasFound;
+    font.aliasMapSecs = mergeInfo->aliasMapSecs;
+    *dnaNEXT(mergeInfo->rec) = rec_font;
+    recPut(mergeInfo, &font, sizeof(font));
+
+    /* Record the calls the source library makes to the merge callbacks */
+    cb->indirect_ctx = h;
+    cb->beg = recBeg;
+    cb->width = recWidth;
+    cb->move = recMove;
+    cb->line = recLine;
+    cb->curve = recCurve;
+    cb->stem = (save.stem != NULL) ? recStem : NULL;
+    cb->flex = (save.flex != NULL) ? recFlex : NULL;
+    cb->genop = (save.genop != NULL) ? recGenop : NULL;
+    cb->seac = (save.seac != NULL) ? recSeac : NULL;
+    cb->end = recEnd;
+    cb->moveVF = (save.moveVF != NULL) ? recMoveVF : NULL;
+    cb->lineVF = (save.lineVF != NULL) ? recMoveVF : NULL;
+    cb->curveVF = (save.curveVF != NULL) ? recCurveVF : NULL;
+    cb->stemVF = (save.stemVF != NULL) ? recStemVF : NULL;
+
+    mergeInfo->recordMsgs = 1;
+    emitGlyphs(h, gaf);
+    mergeInfo->recordMsgs = 0;
+    h->cb.glyph = save;
+
+    font.size = mergeInfo->rec.cnt - start - 1 - (long)sizeof(font);
+    font.aliasLookups = mergeInfo->aliasLookups - font.aliasLookups;
+    font.aliasFound = mergeInfo->aliasFound - font.aliasFound;
+    font.aliasMapSecs = mergeInfo->aliasMapSecs - font.aliasMapSecs;
+    memcpy(&mergeInfo->rec.array[start + 1], &font, sizeof(font));
+}
+
+/* Report failure returned by merge beg() callback, as the source library
+   does. It is fatal unless the glyph was selected by glyph alias file. */
+static void replayFail(txCtx h, int result, bool isGA) {
+    bool quit = result == ABF_QUIT_RET;
+    char *text;
+
+    switch (h->src.type) {
+        case src_Type1:
+            text = t1rErrStr(quit ? t1rErrCstrQuit : t1rErrCstrFail);
+            break;
+        case src_SVG:
+            text = svrErrStr(quit ? svrErrParseQuit : svrErrParseFail);
+            break;
+        case src_UFO:
+            text = ufoErrStr(quit ? ufoErrParseQuit : ufoErrParseFail);
+            break;
+        default:
+            text = cfrErrStr(quit ? cfrErrCstrQuit : cfrErrCstrFail);
+            break;
+    }
+    (void)h->cb.stm.write(&h->cb.stm, srcDbgStream(h), strlen(text), text);
+    if (!isGA)
+        fatal(h, NULL);
+}
+
+/* Replay recorded glyph callbacks up to end. */
+static void replayFont(txCtx h, long end, bool isGA) {
+    MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+    DecodeJob *job = mergeInfo->job;
+    abfGlyphCallbacks *cb = &h->cb.glyph;
+    int result = ABF_SKIP_RET;
+    float args[CFF2_MAX_OP_STACK];
+    int ints[2];
+
+    while (mergeInfo->recNext < end) {
+        switch (mergeInfo->rec.array[mergeInfo->recNext++]) {
+            case rec_beg: {
+                abfGlyphInfo *info = dnaNEXT(job->glyphs);
+                abfEncoding *enc = &info->encoding;
+                RecGlyph rec;
+                long i;
+
+                recGet(mergeInfo, &rec, sizeof(rec));
+                *info = rec.info;
+                info->gname.ptr = NULL;
+                if (rec.nameLen > 0) {
+                    info->gname.ptr = dnaEXTEND(job->names, rec.nameLen);
+                    recGet(mergeInfo, info->gname.ptr, rec.nameLen);
+                }
+                recGet(mergeInfo, &enc->code, sizeof(enc->code));
+                for (i = 1; i < rec.nCodes; i++) {
+                    enc->next = dnaNEXT(job->codes);
+                    enc = enc->next;
+                    recGet(mergeInfo, &enc->code, sizeof(enc->code));
+                }
+                enc->next = NULL;
+                info->blendInfo.blendDeltaArgs = NULL;
+
+                mergeInfo->curGAEIndex = rec.gaeIndex;
+                result = cb->beg(cb, info);
+                info->flags |= ABF_GLYPH_SEEN;
+                if (result == ABF_QUIT_RET || result == ABF_FAIL_RET)
+                    replayFail(h, result, isGA);
+                break;
+            }
+            case rec_width:
+                recGet(mergeInfo, args, sizeof(float));
+                if (result == ABF_CONT_RET || result == ABF_WIDTH_RET)
+                    cb->width(cb, args[0]);
+                break;
+            case rec_move:
+                recGet(mergeInfo, args, 2 * sizeof(float));
+                if (result == ABF_CONT_RET)
+                    cb->move(cb, args[0], args[1]);
+                break;
+            case rec_line:
+                recGet(mergeInfo, args, 2 * sizeof(float));
+                if (result == ABF_CONT_RET)
+                    cb->line(cb, args[0], args[1]);
+                break;
+            case rec_curve:
+                recGet(mergeInfo, args, 6 * sizeof(float));
+                if (result == ABF_CONT_RET)
+                    cb->curve(cb, args[0], args[1], args[2], args[3],
+                              args[4], args[5]);
+                break;
+            case rec_stem:
+                recGet(mergeInfo, ints, sizeof(int));
+                recGet(mergeInfo, args, 2 * sizeof(float));
+                if (result == ABF_CONT_RET)
+                    cb->stem(cb, ints[0], args[0], args[1]);
+                break;
+            case rec_flex:
+                recGet(mergeInfo, args, 13 * sizeof(float));
+                if (result == ABF_CONT_RET)
+                    cb->flex(cb, args[0], args[1], args[2], args[3], args[4],
+                             args[5], args[6], args[7], args[8], args[9],
+                             args[10], args[11], args[12]);
+                break;
+            case rec_genop:
+                recGet(mergeInfo, ints, 2 * sizeof(int));
+                recGet(mergeInfo, args, ints[0] * sizeof(float));
+                if (result == ABF_CONT_RET)
+                    cb->genop(cb, ints[0], args, ints[1]);
+                break;
+            case rec_seac:
+                recGet(mergeInfo, args, 2 * sizeof(float));
+                recGet(mergeInfo, ints, 2 * sizeof(int));
+                if (result == ABF_CONT_RET)
+                    cb->seac(cb, args[0], args[1], ints[0], ints[1]);
+                break;
+            case rec_end:
+                if (result == ABF_CONT_RET || result == ABF_WIDTH_RET)
+                    cb->end(cb);
+                break;
+            case rec_msg: {
+                long length;
+                recGet(mergeInfo, &length, sizeof(length));
+                (void)h->cb.stm.write(&h->cb.stm, srcDbgStream(h), length,
+                                      &mergeInfo->rec.array[mergeInfo->recNext]);
+                mergeInfo->recNext += length;
+                break;
+            }
+            default:
+                fatal(h, "bad glyph record from worker [%s]", h->src.stm.filename);
+        }
+    }
+}
+
+/* Replay recorded glyphs of current source font. Return 1 if replayed, or 0
+   if the font has to be decoded. */
+static bool replayGlyphs(txCtx h, GAFileInfo *gaf) {
+    MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+    RecFont font;
+    long end;
+
+    if (mergeInfo->recNext >= mergeInfo->rec.cnt ||
+        mergeInfo->rec.array[mergeInfo->recNext] != rec_font)
+        return 0;
+    mergeInfo->recNext++;
+    recGet(mergeInfo, &font, sizeof(font));
+    end = mergeInfo->recNext + font.size;
+
+    if (font.flags != srcFlags(h) || font.isGA != (gaf != NULL)) {
+        mergeInfo->recNext = end;
+        return 0;
+    }
+    replayFont(h, end, font.isGA);
+    mergeInfo->aliasLookups += font.aliasLookups;
+    mergeInfo->aliasFound += font.aliasFound;
+    mergeInfo->aliasMapSecs += font.aliasMapSecs;
+    return 1;
+}
+#endif /* HAVE_FORK */
+
+/* Merge glyphs of current source font; replay them if they were decoded by a
+   worker. */
+static void mergeGlyphs(txCtx h, GAFileInfo *gaf) {
+#if HAVE_FORK
+    MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+
+    if (mergeInfo->recording) {
+        recordGlyphs(h, gaf);
+        return;
+    }
+    if (mergeInfo->job != NULL && replayGlyphs(h, gaf))
+        return;
+#endif
+    emitGlyphs(h, gaf);
+}
+
 /* ----------------------------- t1read Library ---------------------------- */
 
 static void updateFontBBox(abfTopDict *top, abfTopDict *mergeTop) {
@@ -461,10 +1142,7 @@ static void t1rMergeFont(txCtx h, long origin, bool isFirstFont, sourceCtx *srcC
 
         h->cb.glyph.indirect_ctx = h;
 
-        if (gaf != NULL) {
-            callbackMergeGASubset(h, gaf);
-        } else if (t1rIterateGlyphs(local_t1r_ctx, &h->cb.glyph))
-            fatal(h, NULL);
+        mergeGlyphs(h, gaf);
 
         /* If this is the last font, and we haven't yet seen the .notdef, add it. */
 
@@ -522,15 +1200,10 @@ static void svrMergeFont(txCtx h, long origin, bool isFirstFont, sourceCtx *srcC
 
         h->cb.glyph.indirect_ctx = h;
 
-        if (gaf != NULL) {
-            callbackMergeGASubset(h, gaf);
-        } else {
-            if (parentIsCID)
-                fatal(h, "The first font is CID. You must provide a glyph alias file that converts this svg file to CID.");
+        if (gaf == NULL && parentIsCID)
+            fatal(h, "The first font is CID. You must provide a glyph alias file that converts this svg file to CID.");
 
-            if (svrIterateGlyphs(local_svr_ctx, &h->cb.glyph))
-                fatal(h, NULL);
-        }
+        mergeGlyphs(h, gaf);
 
         /* h->dst.endfont is called after the all fonts have been merged, by doMergeFontSet */
 
@@ -637,15 +1310,10 @@ static void ufoMergeFont(txCtx h, long origin, bool isFirstFont, sourceCtx *srcC
 
         h->cb.glyph.indirect_ctx = h;
 
-        if (gaf != NULL) {
-            callbackMergeGASubset(h, gaf);
-        } else {
-            if (parentIsCID)
-                fatal(h, "The first font is CID. You must provide a glyph alias file that converts this ufo font to CID.");
+        if (gaf == NULL && parentIsCID)
+            fatal(h, "The first font is CID. You must provide a glyph alias file that converts this ufo font to CID.");
 
-            if (ufoIterateGlyphs(local_ufr_ctx, &h->cb.glyph))
-                fatal(h, NULL);
-        }
+        mergeGlyphs(h, gaf);
 
         /* h->dst.endfont is called after the all fonts have been merged, by doMergeFontSet */
 
@@ -796,10 +1464,7 @@ static void cfrMergeFont(txCtx h, long origin, bool isFirstFont, sourceCtx *srcC
 
         h->cb.glyph.indirect_ctx = h;
 
-        if (gaf != NULL) {
-            callbackMergeGASubset(h, gaf);
-        } else if (cfrIterateGlyphs(local_cfr_ctx, &h->cb.glyph))
-            fatal(h, NULL);
+        mergeGlyphs(h, gaf);
 
         if (cfrEndFont(local_cfr_ctx)) /* source stream gets closed here. */
             fatal(h, NULL);
@@ -1542,6 +2207,192 @@ static void mergeFile(txCtx h, char *srcname, bool isFirstFont, sourceCtx *srcCt
     h->flags |= DONE_FILE;
 }
 
+#if HAVE_FORK
+/* ---------------------------- Parallel Decoding --------------------------- */
+
+/* The files are decoded by ctuRunJobs() in rounds of at most DECODE_ROUND
+   files, so that no more than that many tmp files are open at once. */
+#define DECODE_ROUND 64
+
+typedef struct { /* Decode jobs of a round */
+    txCtx h;
+    long first;    /* fileIndex of the round's first job */
+    int prepared;  /* Worker's output and tmp files have been redirected */
+} DecodeRun;
+
+/* Decode source file and write its recorded glyphs to the job's tmp file.
+   The job leaves the state it was given as it found it, as the worker may
+   decode other files after it. */
+static void CTL_CDECL decodeFile(long index, void *result, void *ctx) {
+    DecodeRun *run = ctx;
+    txCtx h = run->h;
+    MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+    DecodeJob *job = &mergeInfo->jobs.array[run->first + index];
+    DecodeResult *res = result;
+    cfrCtx cfr = h->cfr.ctx;
+    t1rCtx t1r = h->t1r.ctx;
+    svrCtx svr = h->svr.ctx;
+    ufoCtx ufr = h->ufr.ctx;
+    sourceCtx srcCtx;
+    long i;
+    jmp_buf env;
+
+    if (!run->prepared) {
+        /* Messages are written when the file is merged */
+        if (freopen("/dev/null", "w", stdout) == NULL ||
+            freopen("/dev/null", "w", stderr) == NULL)
+            _Exit(EXIT_FAILURE);
+        stmRenewTmp(h); /* Worker's own tmp files */
+        run->prepared = 1;
+    }
+    /* fatal() returns here. The worker then ends without closing the streams
+       it shares with the parent, and the file is decoded when merged. */
+    h->batchEnv = &env;
+    if (setjmp(env) != 0)
+        _Exit(EXIT_FAILURE);
+
+    dnaINIT(h->ctx.dna, srcCtx.cfr, 1, 1);
+    dnaINIT(h->ctx.dna, srcCtx.t1r, 1, 1);
+    dnaINIT(h->ctx.dna, srcCtx.svr, 1, 1);
+    dnaINIT(h->ctx.dna, srcCtx.ufr, 1, 1);
+
+    dnaSET_CNT(mergeInfo->rec, 0);
+    mergeInfo->recFailed = 0;
+    mergeInfo->recGlyphs = 0;
+    mergeInfo->recCodes = 0;
+    mergeInfo->recNames = 0;
+    mergeInfo->recording = 1;
+    mergeInfo->stmWrite = h->cb.stm.write;
+    h->cb.stm.write = recStmWrite;
+    mergeInfo->fileIndex = (unsigned short)(run->first + index);
+    mergeFile(h, job->srcname, 0, &srcCtx);
+    h->cb.stm.write = mergeInfo->stmWrite;
+    mergeInfo->recording = 0;
+    h->batchEnv = NULL;
+
+    for (i = 0; i < srcCtx.cfr.cnt; i++)
+        cfrFree(srcCtx.cfr.array[i]);
+    for (i = 0; i < srcCtx.t1r.cnt; i++)
+        t1rFree(srcCtx.t1r.array[i]);
+    for (i = 0; i < srcCtx.svr.cnt; i++)
+        svrFree(srcCtx.svr.array[i]);
+    for (i = 0; i < srcCtx.ufr.cnt; i++)
+        ufoFree(srcCtx.ufr.array[i]);
+    dnaFREE(srcCtx.cfr);
+    dnaFREE(srcCtx.t1r);
+    dnaFREE(srcCtx.svr);
+    dnaFREE(srcCtx.ufr);
+    h->cfr.ctx = cfr;
+    h->t1r.ctx = t1r;
+    h->svr.ctx = svr;
+    h->ufr.ctx = ufr;
+
+    if (mergeInfo->recFailed ||
+        fwrite(mergeInfo->rec.array, 1, mergeInfo->rec.cnt, job->fp) !=
+            (size_t)mergeInfo->rec.cnt ||
+        fflush(job->fp) != 0)
+        return;
+    res->counts.glyphs = mergeInfo->recGlyphs;
+    res->counts.codes = mergeInfo->recCodes;
+    res->counts.names = mergeInfo->recNames;
+    res->done = 1;
+}
+
+/* Read the glyphs recorded by a decode job and close its tmp file. */
+static void readDecodeJob(txCtx h, DecodeJob *job, DecodeResult *res) {
+    long size;
+
+    job->failed = !res->done;
+    if (!job->failed) {
+        job->counts = res->counts;
+        if (fseek(job->fp, 0, SEEK_END) != 0)
+            fatal(h, "can't read worker tmp file [%s]", job->srcname);
+        size = ftell(job->fp);
+        if (size < 0 || fseek(job->fp, 0, SEEK_SET) != 0)
+            fatal(h, "can't read worker tmp file [%s]", job->srcname);
+        dnaSET_CNT(job->rec, size);
+        if (fread(job->rec.array, 1, size, job->fp) != (size_t)size)
+            fatal(h, "can't read worker tmp file [%s]", job->srcname);
+    }
+    fclose(job->fp);
+    job->fp = NULL;
+}
+
+/* Decode the source files after the first in up to h->file.workers worker
+   processes, and read their recorded glyphs. A file whose job failed is
+   decoded when it is merged. */
+static void decodeFiles(txCtx h) {
+    MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+    DecodeResult results[DECODE_ROUND];
+    DecodeRun run;
+    long i;
+
+    run.h = h;
+    for (run.first = 1; run.first < mergeInfo->jobs.cnt;
+         run.first += DECODE_ROUND) {
+        long cnt = mergeInfo->jobs.cnt - run.first;
+        if (cnt > DECODE_ROUND)
+            cnt = DECODE_ROUND;
+
+        for (i = 0; i < cnt; i++) {
+            DecodeJob *job = &mergeInfo->jobs.array[run.first + i];
+            job->fp = tmpfile();
+            if (job->fp == NULL)
+                fatal(h, "can't open worker tmp file <%s>", strerror(errno));
+        }
+        memset(results, 0, sizeof(results));
+        run.prepared = 0;
+        if (ctuRunJobs(cnt, h->file.workers, CTU_JOBS_KEEP_GOING, decodeFile,
+                       sizeof(DecodeResult), results, &run) < 0)
+            fprintf(stderr, "%s: can't start worker <%s>, decoding files "
+                    "when merged\n", h->progname, strerror(errno));
+        for (i = 0; i < cnt; i++)
+            readDecodeJob(h, &mergeInfo->jobs.array[run.first + i],
+                          &results[i]);
+    }
+}
+
+/* Load the glyphs recorded by a worker, for replay when the file is merged.
+   The replayed glyph info is referenced by the destination font until it is
+   written, so its arrays are sized up front and never move. */
+static void loadDecodeJob(txCtx h, DecodeJob *job) {
+    MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+
+    mergeInfo->job = NULL;
+    if (job->failed)
+        return;
+
+    dnaSET_CNT(mergeInfo->rec, job->rec.cnt);
+    memcpy(mergeInfo->rec.array, job->rec.array, job->rec.cnt);
+    dnaFREE(job->rec);
+
+    if (job->counts.glyphs > 0)
+        dnaGROW(job->glyphs, job->counts.glyphs - 1);
+    if (job->counts.codes > 0)
+        dnaGROW(job->codes, job->counts.codes - 1);
+    if (job->counts.names > 0)
+        dnaGROW(job->names, job->counts.names - 1);
+    mergeInfo->recNext = 0;
+    mergeInfo->job = job;
+}
+#endif /* HAVE_FORK */
+
+/* Merge source file and report the font dicts it added. */
+static void mergeSourceFile(txCtx h, char *filePath, int fileIndex,
+                            sourceCtx *srcCtx, int *curMaxFD) {
+    MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+    int j;
+
+    mergeInfo->fileIndex = (unsigned short)fileIndex;
+    mergeFile(h, filePath, (fileIndex == 0), srcCtx);
+    for (j = 0; j < mergeInfo->newiFDArray.cnt; j++) {
+        if (*curMaxFD < mergeInfo->newiFDArray.array[j]) {
+            *curMaxFD = mergeInfo->newiFDArray.array[j];
+            fprintf(stderr, "Adding font dict %d from %s.\n", *curMaxFD, h->src.stm.filename);
+        }
+    }
+}
+
 #if 0  /* see corresponding if'd out calls in readGlyphAliasFile below */
 static int CTL_CDECL cmpGAEBySrcName(const void *first, const void *second) {
     return strcmp(((GAEntry *)first)->srcName,
@@ -1683,6 +2534,15 @@ static int doMergeFileSet(txCtx h, int argc, char *argv[], int i) {
     int fileCount = 0;
     int curMaxFD = -1;
     MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+    double start;
+#if HAVE_FORK
+    bool parallel = h->file.workers > 1;
+
+    if (parallel) {
+        dnaINIT(h->ctx.dna, mergeInfo->jobs, MAX_MERGE_FILES, MAX_MERGE_FILES);
+        dnaINIT(h->ctx.dna, mergeInfo->rec, 1 << 16, 1 << 20);
+    }
+#endif
 
     /* allocate a list to hold  the source font ctx's */
     dnaINIT(h->ctx.dna, srcCtx.cfr, 5, 5);
@@ -1692,6 +2552,8 @@ static int doMergeFileSet(txCtx h, int argc, char *argv[], int i) {
 
     dnaINIT(h->ctx.dna, mergeInfo->newiFDArray, MAX_MERGE_FILES, MAX_MERGE_FILES);
     dnaINIT(h->ctx.dna, mergeInfo->glyphAliasSet, MAX_MERGE_FILES, MAX_MERGE_FILES);
+    dnaINIT(h->ctx.dna, mergeInfo->aliasGlyphs, 1000, 16000);
+    dnaINIT(h->ctx.dna, mergeInfo->aliasHash, 2048, 32768);
 
     h->dst.begset(h); /* dest stream gets opened */
 
@@ -1709,10 +2571,10 @@ static int doMergeFileSet(txCtx h, int argc, char *argv[], int i) {
     }
 
     /* a glyph alias file applies to the following font file. */
+    start = ctuWallTime();
     while (i < argc) {
         bool isGA;
         char *filePath = argv[i++];
-        int j;
 
         /* try and see if the  file is a glyph alias file */
         isGA = readGlyphAliasFile(h, fileIndex, filePath);
@@ -1722,22 +2584,53 @@ static int doMergeFileSet(txCtx h, int argc, char *argv[], int i) {
             filePath = argv[i++];
         }
 
-        mergeInfo->fileIndex = fileIndex;
-        mergeFile(h, filePath, (fileIndex == 0), &srcCtx);
-        for (j = 0; j < mergeInfo->newiFDArray.cnt; j++) {
-            if (curMaxFD < mergeInfo->newiFDArray.array[j]) {
-                curMaxFD = mergeInfo->newiFDArray.array[j];
-                fprintf(stderr, "Adding font dict %d from %s.\n", curMaxFD, h->src.stm.filename);
-            }
+#if HAVE_FORK
+        if (parallel) {
+            /* Merge the files once all glyph alias files are read */
+            DecodeJob *job = dnaNEXT(mergeInfo->jobs);
+            job->srcname = filePath;
+            job->fp = NULL;
+            job->failed = 0;
+            dnaINIT(h->ctx.dna, job->glyphs, 1, 1);
+            dnaINIT(h->ctx.dna, job->codes, 1, 1);
+            dnaINIT(h->ctx.dna, job->names, 1, 1);
+            dnaINIT(h->ctx.dna, job->rec, 1, 1 << 16);
+            fileIndex++;
+            continue;
         }
-
+#endif
+        mergeSourceFile(h, filePath, fileIndex, &srcCtx, &curMaxFD);
         fileIndex++;
     }
 
+#if HAVE_FORK
+    if (parallel) {
+        /* The first font sets up the destination font and is merged before
+           the rest are decoded by workers. */
+        for (fileIndex = 0; fileIndex < mergeInfo->jobs.cnt; fileIndex++) {
+            DecodeJob *job = &mergeInfo->jobs.array[fileIndex];
+            if (fileIndex == 1) {
+                double startRead = ctuWallTime();
+                decodeFiles(h);
+                mergeInfo->readSecs = ctuWallTime() - startRead;
+                start += mergeInfo->readSecs;
+            }
+            if (fileIndex > 0)
+                loadDecodeJob(h, job);
+            mergeSourceFile(h, job->srcname, fileIndex, &srcCtx, &curMaxFD);
+            mergeInfo->job = NULL;
+        }
+    }
+#endif
+    mergeInfo->fileCount = fileIndex;
+    mergeInfo->mergeSecs = ctuWallTime() - start;
+
     if (fileIndex == 0)
         fatal(h, "empty file list.\n");
+    start = ctuWallTime();
     h->dst.endfont(h);
     h->dst.endset(h); /* dest stream gets closed */
+    mergeInfo->writeSecs = ctuWallTime() - start;
 
     /* restore original h->cb.glyph.beg */
     h->cb.glyph.beg = mergeInfo->mergeGlyphBeg;
@@ -1769,10 +2662,51 @@ static int doMergeFileSet(txCtx h, int argc, char *argv[], int i) {
 
     dnaFREE(mergeInfo->glyphAliasSet);
     dnaFREE(mergeInfo->newiFDArray);
+    dnaFREE(mergeInfo->aliasGlyphs);
+    dnaFREE(mergeInfo->aliasHash);
+
+#if HAVE_FORK
+    if (parallel) {
+        for (fileIndex = 0; fileIndex < mergeInfo->jobs.cnt; fileIndex++) {
+            mergeInfo->failedJobs += mergeInfo->jobs.array[fileIndex].failed;
+            dnaFREE(mergeInfo->jobs.array[fileIndex].glyphs);
+            dnaFREE(mergeInfo->jobs.array[fileIndex].codes);
+            dnaFREE(mergeInfo->jobs.array[fileIndex].names);
+            dnaFREE(mergeInfo->jobs.array[fileIndex].rec);
+        }
+        dnaFREE(mergeInfo->jobs);
+        dnaFREE(mergeInfo->rec);
+    }
+#endif
 
     return i - 1;
 }
 
+/* Print time spent in each phase of merge (-time). */
+static void printMergeTimes(txCtx h, char *dstPath) {
+    MergeInfo *mergeInfo = (MergeInfo *)h->appSpecificInfo;
+#if HAVE_FORK
+    if (h->file.workers > 1 && mergeInfo->fileCount > 1) {
+        fprintf(stderr, "%s: decoded %d source fonts in %.3f sec (%ld workers",
+                h->progname, mergeInfo->fileCount - 1, mergeInfo->readSecs,
+                h->file.workers);
+        if (mergeInfo->failedJobs > 0)
+            fprintf(stderr, ", %d failed", mergeInfo->failedJobs);
+        fprintf(stderr, ")\n");
+        fprintf(stderr, "%s: merged %d source fonts in %.3f sec\n",
+                h->progname, mergeInfo->fileCount, mergeInfo->mergeSecs);
+    } else
+#endif
+        fprintf(stderr, "%s: read and merged %d source fonts in %.3f sec\n",
+                h->progname, mergeInfo->fileCount, mergeInfo->mergeSecs);
+    if (mergeInfo->aliasLookups > 0)
+        fprintf(stderr, "%s: looked up %ld glyph aliases (%ld in alias maps built in %.3f sec)\n",
+                h->progname, mergeInfo->aliasLookups, mergeInfo->aliasFound,
+                mergeInfo->aliasMapSecs);
+    fprintf(stderr, "%s: wrote %s in %.3f sec\n",
+            h->progname, dstPath, mergeInfo->writeSecs);
+}
+
 /* Parse argument list. */
 static void parseArgs(txCtx h, int argc, char *argv[]) {
     int i;
@@ -1821,6 +2755,7 @@ static void parseArgs(txCtx h, int argc, char *argv[]) {
                     h->cfw.flags |= CFW_PRESERVE_GLYPH_ORDER;
                     i = doMergeFileSet(h, argc, argv, i);
                     if (mergeInfo->mode != mode_cff) { /* output font 'h->file.dst" is cff; we need to convert to t1. */
+                        double start = ctuWallTime();
                         setMode(h, mergeInfo->mode);
                         strcpy(h->file.src, dstPath);
                         strcpy(h->file.dst, dstPath);
@@ -1828,7 +2763,10 @@ static void parseArgs(txCtx h, int argc, char *argv[]) {
                         doSingleFileSet(h, dstPath);
                         remove(h->file.src); /* Under Windows, rename fails if dst file exists. */
                         rename(h->file.dst, h->file.src);
+                        mergeInfo->writeSecs += ctuWallTime() - start;
                     }
+                    if (mergeInfo->timing)
+                        printMergeTimes(h, dstPath);
                 }
                 break;
             case opt_dump: /* mode selection options */
@@ -2203,6 +3141,19 @@ static void parseArgs(txCtx h, int argc, char *argv[]) {
             case opt_hints:
                 mergeInfo->hintsOnly = 1;
                 break;
+            case opt_j:
+                if (!argsleft)
+                    goto noarg;
+                else {
+                    char *q;
+                    h->file.workers = strtol(argv[++i], &q, 0);
+                    if (*q != '\0' || h->file.workers < 1)
+                        goto badarg;
+                }
+                break;
+            case opt_time:
+                mergeInfo->timing = 1;
+                break;
             case opt_decid:
                 if (h->mode != mode_t1)
                     goto wrongmode;
@@ -63,6 +63,7 @@ DCL_OPT("-gx", opt_gx)
 DCL_OPT("-h", opt_h)
 DCL_OPT("-hints", opt_hints)
 DCL_OPT("-i", opt_i)
+DCL_OPT("-j", opt_j)
 DCL_OPT("-l", opt_l)
 DCL_OPT("-lf", opt_lf)
 DCL_OPT("-m", opt_m)
@@ -86,6 +87,7 @@ DCL_OPT("-std", opt_std)
 DCL_OPT("-svg", opt_svg)
 DCL_OPT("-t", opt_t)
 DCL_OPT("-t1", opt_t1)
+DCL_OPT("-time", opt_time)
 DCL_OPT("-u", opt_u)
 DCL_OPT("-ufo", opt_ufo)
 DCL_OPT("-usefd", opt_usefd)
@@ -1,4 +1,4 @@
-"mergefonts [-cid cidfontinfo file ] [-hints] output-font-file [[glyph alias file] merge-font-file]+\n",
+"mergefonts [-cid cidfontinfo file ] [-hints] [-j n] [-time] output-font-file [[glyph alias file] merge-font-file]+\n",
 "mergefonts [-u] [-h]\n",
 " \n",
 "This tool is based on the tx program. If the output file mode (e.g -cff, -t1,\n",
@@ -21,6 +21,9 @@
 "    source fonts. It copies the font global metrics and hint data from the\n",
 "    first font, and the glyph data and font name from the second font.\n",
 "\n",
+"-j <n>  decode source fonts in up to <n> worker processes\n",
+"-time   report decode, merge, and write times\n",
+"\n",
 "[other options]\n",
 "-u              print usage\n",
 "-h              print help\n",
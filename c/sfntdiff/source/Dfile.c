@@ -30,6 +30,8 @@ typedef struct
     Card8 *end;        /* One past end of filled buffer */
 } _file_;
 
+#define COMPARE_BLOCK 65536 /* fileSameBytes() block size */
+
 static _file_ file1 = {(-1), NULL};
 static _file_ file2 = {(-1), NULL};
 static _file_ *filep;
@@ -152,6 +154,35 @@ void fileReadBytes(Card8 which, Int32 count, Card8 *buf) {
     }
 }
 
+/* Compare "count" bytes at "offset1" in file 1 with "count" bytes at
+   "offset2" in file 2 by reading both in large blocks. Returns 1 if they are
+   identical, else 0. The input buffers are discarded, so the next read from
+   either file must be preceded by a seek. */
+IntX fileSameBytes(Card32 offset1, Card32 offset2, Card32 count) {
+    static Card8 block1[COMPARE_BLOCK];
+    static Card8 block2[COMPARE_BLOCK];
+    IntX same = 1;
+
+    fileSeekAbsNotBuffered(1, offset1);
+    fileSeekAbsNotBuffered(2, offset2);
+
+    while (count > 0) {
+        IntX size = (count < COMPARE_BLOCK) ? count : COMPARE_BLOCK;
+
+        if (sysRead(file1.id, block1, size, file1.name) != size ||
+            sysRead(file2.id, block2, size, file2.name) != size ||
+            memcmp(block1, block2, size) != 0) {
+            same = 0;
+            break;
+        }
+        count -= size;
+    }
+
+    fileSeekAbsNotBuffered(1, offset1);
+    fileSeekAbsNotBuffered(2, offset2);
+    return same;
+}
+
 /* 1, 2, and 4 byte big-endian machine independent input */
 void fileReadObject(Card8 which, IntX size, ...) {
     Int32 value;
@@ -18,6 +18,7 @@ extern Card32 fileTell(Card8 which);
 extern void fileSeek(Card8 which, Card32 offset, int relative);
 extern void fileSeekAbsNotBuffered(Card8 which, Card32 offset);
 extern void fileReadBytes(Card8 which, Int32 count, Card8 *buf);
+extern IntX fileSameBytes(Card32 offset1, Card32 offset2, Card32 count);
 extern void fileReadObject(Card8 which, IntX size, ...);
 extern Byte8 *fileName(Card8 which);
 extern Card32 fileSniff(Card8 which);
@@ -11,6 +11,13 @@
 #include <ctype.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <errno.h>
+#include "ctutil.h"
+
+#ifndef _WIN32
+#define HAVE_FORK 1
+#endif
 
 Byte8 *version = "3.0.1"; /* Program version */
 
@@ -31,7 +38,7 @@ char *MakeFullPath(char *source) {
 /* Print usage information */
 static void printUsage(void) {
     printf(
-        "Usage: %s [-u|-h] [-T] [-d <level>] [-x<tags>|-i<tags>] "
+        "Usage: %s [-u|-h] [-T] [-d <level>] [-x<tags>|-i<tags>] [-j <n>] "
         "<FONTS|DIRS>\n"
         "OR: %s  -X <scriptfile>\n\n"
         "where: <FONTS|DIRS> is:\n"
@@ -45,6 +52,7 @@ static void printUsage(void) {
         "    -d  set diff level of detail\n"
         "    -x  exclude table(s)   _OR_\n"
         "    -i  include table(s) e.g., -iname,head\n"
+        "    -j  compare directories with <n> parallel worker processes\n"
         "Version:\n"
         "    %s\n",
         global.progname,
@@ -85,8 +93,109 @@ static void showHelp(void) {
         "        e.g., -i cmap,name\n"
         "        will inspect/compare ONLY the 'cmap' and 'name' tables\n");
     printf("    -i and -x switches are exclusive of each other.\n");
+    printf(
+        "    -j <n>\n"
+        "        when comparing two directories, compare up to <n> pairs of\n"
+        "        files at once in parallel worker processes. The report for\n"
+        "        each pair is printed in the same order as without -j and is\n"
+        "        followed by a summary of the pairs compared per second.\n"
+        "        Ignored on Windows.\n");
+}
+
+static IntX workers = 1; /* Max concurrent worker processes (-j) */
+
+/* Compare a pair of files from two directories */
+static void diffDirPair(Byte8 *fil1, Byte8 *fil2) {
+    bool supported, supported2;
+
+    fileOpen(1, fil1);
+    fileOpen(2, fil2);
+
+    printf("\n---------------------------------------------\n");
+    if (opt_Present("-T")) {
+        printf("< %s\t%s\n", fil1, fileModTimeString(1, fil1));
+        printf("> %s\t%s\n", fil2, fileModTimeString(2, fil2));
+    } else {
+        printf("< %s\n", fil1);
+        printf("> %s\n", fil2);
+    }
+
+    /* See if we can recognize the file type */
+    supported = isSupportedFontFormat(fileSniff(1), fil1);
+    supported2 = isSupportedFontFormat(fileSniff(2), fil2);
+
+    if (!supported || !supported2) {
+        fileClose(1);
+        fileClose(2);
+        return;
+    }
+
+    sfntRead(0, -1, 0, -1); /* Read plain sfnt file */
+    sfntDump();
+    sfntFree();
+    fileClose(1);
+    fileClose(2);
 }
 
+static IntN cmpFileNames(const void *first, const void *second) {
+    return strcmp(*(Byte8 **)first, *(Byte8 **)second);
+}
+
+#if HAVE_FORK
+/* ------------------------- Parallel Directory Diffs ------------------------ */
+
+/* The pairs of files are shared out among forked worker processes (see
+   ctuRunJobs()), each of which therefore has its own copy of the table and
+   file state. As in a serial run, a fatal error stops the output after the
+   failed pair. */
+
+typedef struct { /* Directories being compared */
+    Byte8 *dir1;
+    Byte8 *dir2;
+    Byte8 **names;
+} DirPairs;
+
+/* Compare pair "index" in a worker process */
+static void CTL_CDECL diffDirPairJob(long index, void *result, void *ctx) {
+    DirPairs *dirs = (DirPairs *)ctx;
+    Byte8 fil1[MAX_PATH];
+    Byte8 fil2[MAX_PATH];
+
+    strcpy(fil1, dirs->dir1);
+    strcat(fil1, sysPathSep);
+    strcat(fil1, dirs->names[index]);
+
+    strcpy(fil2, dirs->dir2);
+    strcat(fil2, sysPathSep);
+    strcat(fil2, dirs->names[index]);
+
+    diffDirPair(fil1, fil2);
+}
+
+/* Compare pairs of files from the directories "dir1" and "dir2" in parallel
+   worker processes and print the output in file name order. */
+static void diffDirPairs(Byte8 *dir1, Byte8 *dir2, Byte8 **names, IntN cnt) {
+    DirPairs dirs;
+    double start = ctuWallTime();
+    double secs;
+    long done;
+
+    dirs.dir1 = dir1;
+    dirs.dir2 = dir2;
+    dirs.names = names;
+    done = ctuRunJobs(cnt, workers, 0, diffDirPairJob, 0, NULL, &dirs);
+    if (done < 0)
+        fatal("can't start worker <%s>\n", strerror(errno));
+    if (done < cnt)
+        quit(1);
+    secs = ctuWallTime() - start;
+
+    fprintf(stderr, "%s: compared %d file pairs in %.3f sec "
+            "(%.1f pairs/sec, %d workers)\n", global.progname,
+            cnt, secs, secs > 0 ? cnt / secs : 0.0, workers);
+}
+#endif /* HAVE_FORK */
+
 /* Main program */
 IntN main(IntN argc, Byte8 *argv[]) {
     static opt_Option opt[] =
@@ -97,6 +206,7 @@ IntN main(IntN argc, Byte8 *argv[]) {
             {"-x", sfntTagScan},
             {"-i", sfntTagScan},
             {"-d", opt_Int, &level, "0", 0, 4},
+            {"-j", opt_Int, &workers, "1", 1, 256},
         };
 
     IntN argi;
@@ -170,6 +280,13 @@ IntN main(IntN argc, Byte8 *argv[]) {
         IntN nn;
 
         NumSimpleNames = sysReadInputDir(filename1, &SimpleNameList);
+        qsort(SimpleNameList, NumSimpleNames, sizeof(Byte8 *), cmpFileNames);
+#if HAVE_FORK
+        if (workers > 1 && NumSimpleNames > 0) {
+            diffDirPairs(filename1, filename2, SimpleNameList, NumSimpleNames);
+            return 0;
+        }
+#endif
         for (nn = 0; nn < NumSimpleNames; nn++) {
             strcpy(fil1, filename1);
             strcat(fil1, sysPathSep);
@@ -179,33 +296,7 @@ IntN main(IntN argc, Byte8 *argv[]) {
             strcat(fil2, sysPathSep);
             strcat(fil2, SimpleNameList[nn]);
 
-            fileOpen(1, fil1);
-            fileOpen(2, fil2);
-
-            printf("\n---------------------------------------------\n");
-            if (opt_Present("-T")) {
-                printf("< %s\t%s\n", fil1, fileModTimeString(1, fil1));
-                printf("> %s\t%s\n", fil2, fileModTimeString(2, fil2));
-            } else {
-                printf("< %s\n", fil1);
-                printf("> %s\n", fil2);
-            }
-
-            /* See if we can recognize the file type */
-            supported = isSupportedFontFormat(fileSniff(1), fil1);
-            supported2 = isSupportedFontFormat(fileSniff(2), fil2);
-
-            if (!supported || !supported2) {
-                fileClose(1);
-                fileClose(2);
-                continue;
-            }
-
-            sfntRead(0, -1, 0, -1); /* Read plain sfnt file */
-            sfntDump();
-            sfntFree();
-            fileClose(1);
-            fileClose(2);
+            diffDirPair(fil1, fil2);
         }
     } else if (!name1isDir && name2isDir) {
         Byte8 fil2[MAX_PATH];
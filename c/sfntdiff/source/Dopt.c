@@ -101,7 +101,7 @@ void opt_Error(int error, opt_Option *opt, char *arg) {
 }
 
 bool is_known_option(char *arg) {
-    const char *known_options[] = {"-u", "-h", "-T", "-d", "-x", "-i", "-X"};
+    const char *known_options[] = {"-u", "-h", "-T", "-d", "-x", "-i", "-j", "-X"};
     int num_opts = sizeof(known_options) / sizeof(known_options[0]);
     int i;
     for (i = 0; i < num_opts; i++)
@@ -864,6 +864,14 @@ static void doTables(IntX read) {
                 func->read(2, start2, length2);
             }
         } else {
+            if (func == NULL || func->diff != NULL) {
+                /* Skip tables whose data is identical without diffing them.
+                   Tables with different checksums are left to the diff. */
+                if (entry1->checksum == entry2->checksum &&
+                    length1 == length2 &&
+                    fileSameBytes(start1, start2, length1))
+                    continue;
+            }
             if (func == NULL) /* non-handled table */
             {
                 hexDiff(tag, start1, length1, start2, length2);
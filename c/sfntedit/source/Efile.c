@@ -12,6 +12,9 @@
  * fonts/resource files reached this size. 
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* For copy_file_range */
+#endif
 #include <stdio.h>
 #include <stdarg.h>
 #include <string.h>
@@ -20,6 +23,12 @@
 #include "Esys.h"
 #include "errno.h"
 
+#if defined(__linux__) && defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+#include <unistd.h>
+#define HAVE_COPY_FILE_RANGE 1
+#endif
+
 extern int doingScripting;
 extern char *sourcepath;
 
@@ -197,14 +206,55 @@ void fileWriteObject(File *fyl, IntX size, Card32 value) {
     }
 }
 
+#if HAVE_COPY_FILE_RANGE
+/* Copy count bytes from the current source position to the current
+   destination position inside the kernel. Return 0 if the kernel can't copy
+   between these files so the caller can fall back to buffered copying. */
+static int kernelCopy(File *src, File *dst, size_t count) {
+    loff_t inOff;
+    loff_t outOff;
+    size_t left = count;
+
+    if (fflush(dst->fp) != 0)
+        fileError(dst);
+    inOff = ftell(src->fp);
+    outOff = ftell(dst->fp);
+    if (inOff < 0 || outOff < 0)
+        return 0;
+
+    while (left > 0) {
+        ssize_t n = copy_file_range(fileno(src->fp), &inOff,
+                                    fileno(dst->fp), &outOff, left, 0);
+        if (n <= 0) {
+            if (left == count && n < 0 && errno != EIO && errno != ENOSPC)
+                return 0; /* Unsupported; nothing copied yet */
+            if (n == 0)
+                errno = EIO; /* Source shorter than expected */
+            fileError(n == 0 ? src : dst);
+        }
+        left -= n;
+    }
+
+    /* Resynchronize streams with the descriptor offsets */
+    fileSeek(src, (long)inOff, SEEK_SET);
+    fileSeek(dst, (long)outOff, SEEK_SET);
+    return 1;
+}
+#endif /* HAVE_COPY_FILE_RANGE */
+
 /* Copy count bytes from source to destination files */
 void fileCopy(File *src, File *dst, size_t count) {
-    char buf[BUFSIZ];
+    static char buf[65536];
+
+#if HAVE_COPY_FILE_RANGE
+    if (count > 0 && kernelCopy(src, dst, count))
+        return;
+#endif
 
-    while (count > BUFSIZ) {
-        fileReadN(src, BUFSIZ, buf);
-        fileWriteN(dst, BUFSIZ, buf);
-        count -= BUFSIZ;
+    while (count > sizeof(buf)) {
+        fileReadN(src, sizeof(buf), buf);
+        fileWriteN(dst, sizeof(buf), buf);
+        count -= sizeof(buf);
     }
 
     fileReadN(src, count, buf);
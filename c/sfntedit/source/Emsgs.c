@@ -50,6 +50,7 @@ const char *EnglishMessages[] =
         "check failed [%s]\n",                                   /* SFED_MSG_CHECKFAILED */
         "check passed [%s]\n",                                   /* SFED_MSG_CHECKPASSED */
         "Done.\n",                                               /* SFED_MSG_DONE */
+        "processed %d fonts (%.1f MB) in %.3f sec (%.1f MB/sec)\n", /* SFED_MSG_THROUGHPUT */
 };
 
 const char *sfntedMsg(int msgId) {
@@ -51,6 +51,7 @@ extern const char *sfntedMsg(int msgId);
 #define SFED_MSG_CHECKFAILED        41
 #define SFED_MSG_CHECKPASSED        42
 #define SFED_MSG_DONE               43
+#define SFED_MSG_THROUGHPUT         44
 
-#define SFED_MSG_ENDSENTINEL        SFED_MSG_DONE
+#define SFED_MSG_ENDSENTINEL        SFED_MSG_THROUGHPUT
 #endif
@@ -22,6 +22,7 @@
 #include "Esys.h"
 #include "otftableeditor.h"
 #include "setjmp.h"
+#include "ctutil.h"
 
 #define MAX_ARGS 200
 
@@ -39,7 +40,7 @@ jmp_buf mark;
 
 #endif /* SUNOS */
 
-#define VERSION "1.4.4"
+#define VERSION "1.5.0"
 
 /* Data type sizes (bytes) */
 #define uint16_ 2
@@ -139,6 +140,8 @@ static long options; /* Options seen */
 #define OPT_CHECK   (1 << 4)
 #define OPT_FIX     (1 << 5)
 
+static int batchmode; /* -b: edit each source file in place */
+
 volatile int doingScripting = 0;
 int foundXswitch = 0;
 
@@ -187,6 +190,10 @@ int p_rename(const char *old_filename, const char *new_filename) {
     File dst;
     long srcsize;
 
+    /* Try a plain rename first; fall back to copying, e.g. across devices */
+    if (rename(old_filename, new_filename) == 0)
+        return 0;
+
     fileOpenRead(old_filename, &src);
     fileOpenWrite(new_filename, &dst);
 
@@ -210,6 +217,7 @@ static void printUsage(void) {
     printf(
             "Usage:\n"
             "    %s [options] <srcfile> [<dstfile>]\n"
+            "OR: %s [options] -b <srcfile>+\n"
             "OR: %s  -X <scriptfile>\n"
             "\n"
             "Options:\n"
@@ -221,6 +229,7 @@ static void printUsage(void) {
             "    -f fix checksums (implies -c)\n"
             "    -u print usage\n"
             "    -h print help\n"
+            "    -b batch mode: apply options to each <srcfile> in place\n"
             "    -X execute command-lines from <scriptfile> [default: sfntedit.scr]\n"
             "\n"
             "Build:\n"
@@ -228,6 +237,7 @@ static void printUsage(void) {
             "\n",
             global.progname,
             global.progname,
+            global.progname,
             VERSION);
 }
 
@@ -285,6 +295,11 @@ static void showHelp(void) {
         "recommended in the OpenType specification. A side effect of copying is that all\n"
         "table information including checksums and sfnt search fields is recalculated.\n"
         "\n"
+        "The batch option (-b) applies the same options to each of a list of source\n"
+        "files in turn, editing them in-place, in a single run of the program. The\n"
+        "-b and -X modes finish by reporting the number of fonts and bytes processed\n"
+        "and the throughput achieved.\n"
+        "\n"
         "Examples:\n"
         "- Extract GPOS and GSUB tables to files minion.GPOS and minion.GSUB.\n"
         "    sfntedit -x GPOS,GSUB minion.otf\n"
@@ -296,7 +311,10 @@ static void showHelp(void) {
         "    sfntedit -d TR01,TR02,TR03 pala.ttf\n"
         "    \n"
         "- Copy font to new file fixing checksums and reordering tables.\n"
-        "    sfntedit -f helv.ttf newhelv.ttf\n\n");
+        "    sfntedit -f helv.ttf newhelv.ttf\n"
+        "    \n"
+        "- Delete DSIG table from several fonts.\n"
+        "    sfntedit -d DSIG -b *.otf\n\n");
 }
 
 static void makeArgs(char *filename) {
@@ -493,6 +511,7 @@ static int parseArgs(int argc, char *argv[]) {
     int i;
 
     options = 0; /* reset options */
+    batchmode = 0;
 
     for (i = 0; i < argc; i++) {
         char *arg = argv[i];
@@ -545,6 +564,9 @@ static int parseArgs(int argc, char *argv[]) {
                     case 'f': /* Fix checksum */
                         options |= OPT_FIX;
                         break;
+                    case 'b': /* Batch mode */
+                        batchmode = 1;
+                        break;
                     case 'u':
                         showUsage();
                         exit(0);
@@ -574,7 +596,7 @@ static int parseArgs(int argc, char *argv[]) {
                     srcfile.name = arg;
                 }
 
-                if (argsleft == 0) {
+                if (argsleft == 0 || batchmode) {
                     if (writefile) { /* Use temporary file; but check doesn't exist first */
                         char *fulltemp;
 
@@ -695,11 +717,45 @@ static void calcSearchParams(unsigned nUnits,
     *rangeShift = ENTRY_SIZE * (nUnits - pwr2);
 }
 
+/* Copy buffer; a multiple of 4 so that only the last block needs padding */
+#define COPY_BUF_SIZE 65536
+static Card8 copybuf[COPY_BUF_SIZE];
+
+/* Sum block of big-endian longs */
+static Card32 blockSum(const Card8 *p, size_t count) {
+    Card32 sum = 0;
+    const Card8 *end = p + count;
+    for (; p < end; p += 4)
+        sum += (Card32)p[0] << 24 | (Card32)p[1] << 16 | (Card32)p[2] << 8 | p[3];
+    return sum;
+}
+
+/* Compute table checksum, padding the data to a 4-byte boundary with zeros,
+   and copy the padded data to dst if it isn't NULL. The data is read and
+   summed a block at a time in a single pass. */
+static Card32 tableCopy(File *src, File *dst, long offset, long length) {
+    Card32 checksum = 0;
+
+    fileSeek(src, offset, SEEK_SET);
+    while (length > 0) {
+        size_t n = (length > COPY_BUF_SIZE) ? COPY_BUF_SIZE : (size_t)length;
+        size_t padded = (n + 3) & ~(size_t)3;
+
+        fileReadN(src, n, copybuf);
+        memset(copybuf + n, 0, padded - n);
+        checksum += blockSum(copybuf, padded);
+        if (dst != NULL)
+            fileWriteN(dst, padded, copybuf);
+        length -= n;
+    }
+
+    return checksum;
+}
+
 /* Check that the table checksums and the head adjustment checksums are
    calculated correctly. Also validate the sfnt search fields */
 static void checkChecksums(void) {
     int i;
-    long nLongs;
     int fail = 0;
     Card16 searchRange;
     Card16 entrySelector;
@@ -723,27 +779,14 @@ static void checkChecksums(void) {
     }
 
     /* Read directory header */
-    fileSeek(&srcfile, 0, SEEK_SET);
-    nLongs = (DIR_HDR_SIZE + ENTRY_SIZE * sfnt.numTables) / 4;
-    while (nLongs--) {
-        Card32 amt;
-        fileReadObject(&srcfile, 4, &amt);
-        totalsum += amt;
-    }
+    totalsum = tableCopy(&srcfile, NULL, 0,
+                         DIR_HDR_SIZE + ENTRY_SIZE * sfnt.numTables);
 
     for (i = 0; i < sfnt.numTables; i++) {
-        Card32 checksum = 0;
-        Card32 amt;
-
+        Card32 checksum;
         Table *entry = &sfnt.directory[i];
 
-        fileSeek(&srcfile, entry->offset, SEEK_SET);
-
-        nLongs = (entry->length + 3) / 4;
-        while (nLongs--) {
-            fileReadObject(&srcfile, 4, &amt);
-            checksum += amt;
-        }
+        checksum = tableCopy(&srcfile, NULL, entry->offset, entry->length);
 
         if (entry->tag == TAG('h', 'e', 'a', 'd')) {
             /* Adjust sum to ignore head.checkSumAdjustment field */
@@ -856,35 +899,6 @@ static int cmpOrder(const void *first, const void *second) {
         return 0;
 }
 
-/* Copy table and compute its checksum */
-static Card32 tableCopy(File *src, File *dst, long offset, long length) {
-    int i;
-    Card32 value;
-    Card32 checksum = 0;
-
-    fileSeek(src, offset, SEEK_SET);
-    for (; length > 3; length -= 4) {
-        fileReadObject(src, 4, &value);
-        fileWriteObject(dst, 4, value);
-        checksum += value;
-    }
-
-    if (length == 0)
-        return checksum;
-
-    /* Read remaining bytes and pad to 4-byte boundary */
-    value = 0;
-    for (i = 0; i < length; i++) {
-        Card8 b;
-        fileReadN(src, 1, &b);
-        value = value << 8 | b;
-    }
-    value <<= (4 - length) * 8;
-    fileWriteObject(dst, 4, value);
-
-    return checksum + value;
-}
-
 /* Add table from file */
 static Card32 addTable(Table *tbl, Card32 *length) {
     File file;
@@ -915,7 +929,6 @@ static int cmpTags(const void *first, const void *second) {
    options */
 static boolean sfntCopy(void) {
     int i;
-    int nLongs;
     Tag *tags;
     Card16 numDstTables;
     Card32 checksum;
@@ -1041,14 +1054,8 @@ static boolean sfntCopy(void) {
 
     /* Checksum sfnt header */
 
-    fileSeek(&dstfile, 0, SEEK_SET);
-
-    nLongs = (DIR_HDR_SIZE + ENTRY_SIZE * numDstTables) / 4;
-    for (i = 0; i < nLongs; i++) {
-        Card32 b;
-        fileReadObject(&dstfile, 4, &b);
-        totalsum += b;
-    }
+    totalsum += tableCopy(&dstfile, NULL, 0,
+                          DIR_HDR_SIZE + ENTRY_SIZE * numDstTables);
 
     if (headSeen) {
         /* Write head.checkSumAdjustment */
@@ -1059,11 +1066,96 @@ static boolean sfntCopy(void) {
     return changed;
 }
 
+static struct /* Batch and script throughput */
+{
+    int fonts;
+    double bytes;
+    double start;
+} stats;
+
+/* Apply options to source font, replacing the source font by the temporary
+   file if editing in-place */
+static void editFont(const char *backupname) {
+    boolean changed = 0;
+
+    fileOpenRead(srcfile.name, &srcfile);
+
+    if (dstfile.name != NULL) /* Open destination file */
+        fileOpenWrite(dstfile.name, &dstfile);
+
+    /* Read sfnt header */
+    sfntReadHdr();
+
+    /* Process font */
+    if (options & OPT_LIST)
+        sfntDumpHdr();
+    else if (options & OPT_CHECK)
+        checkChecksums();
+    else {
+        if (options & OPT_EXTRACT)
+            extractTables();
+        if (options & (OPT_DELETE | OPT_ADD | OPT_FIX))
+            changed = sfntCopy();
+    }
+
+    stats.fonts++;
+    stats.bytes += fileLength(&srcfile);
+
+    /* Close files */
+    fileClose(&srcfile);
+    if (dstfile.fp != NULL) {
+        fileClose(&dstfile);
+        if (!changed) {
+            if (remove(dstfile.name) == -1)
+                fatal(SFED_MSG_REMOVEERR, strerror(errno), dstfile.name);
+        } else if (strcmp(dstfile.name + strlen(dstfile.name) - strlen(tmpname), tmpname) == 0) { /* Rename tmp file to source file */
+            if (p_rename(srcfile.name, backupname) == -1)
+                fatal(SFED_MSG_BADRENAME, strerror(errno), srcfile.name);
+            if (p_rename(dstfile.name, srcfile.name) == -1)
+                fatal(SFED_MSG_BADRENAME, strerror(errno), dstfile.name);
+            if (remove(backupname) == -1)
+                fatal(SFED_MSG_REMOVEERR, strerror(errno), backupname);
+        }
+    }
+}
+
+/* Apply options to the nFiles source files named by files (-b) */
+static void editBatch(int nFiles, char *files[], const char *backupname) {
+    int i;
+    long saveOptions = options;
+    const char *saveDstName = dstfile.name;
+    static sfntHdr saveSfnt; /* Tables named by options */
+
+    saveSfnt = sfnt;
+    for (i = 0; i < nFiles; i++) {
+        /* Restore option state changed by previous font */
+        sfnt = saveSfnt;
+        options = saveOptions;
+        if (doingScripting && sourcepath[0] != '\0')
+            srcfile.name = MakeFullPath(files[i]);
+        else
+            srcfile.name = files[i];
+        srcfile.fp = NULL;
+        dstfile.name = saveDstName;
+        dstfile.fp = NULL;
+
+        editFont(backupname);
+    }
+}
+
+/* Report batch and script throughput */
+static void reportStats(void) {
+    double secs = ctuWallTime() - stats.start;
+    double mb = stats.bytes / (1024 * 1024);
+    message(SFED_MSG_THROUGHPUT, stats.fonts, mb, secs,
+            secs > 0 ? mb / secs : 0.0);
+}
+
 int main(int argc, char *argv[]) {
     int argi;
     volatile int i;
+    int batchscript = 0; /* Some script command used -b */
     cmdlinetype *cmdl;
-    boolean changed = 0;
     /* Set signal handler */
     if (signal(SIGINT, SIG_IGN) != SIG_IGN)
         signal(SIGINT, cleanup);
@@ -1121,17 +1213,12 @@ int main(int argc, char *argv[]) {
                 goto execscript;
             }
         }
-        if ((srcfile.name == NULL) &&
-            (argc > 1)
-
-                ) /* no files on commandline, but other switches */
+        if (srcfile.name == NULL) /* no files on commandline, but other switches */
         {
             fatal(SFED_MSG_MISSINGFILENAME);
             showUsage();
         }
 
-        fileOpenRead(srcfile.name, &srcfile);
-
         {
             char *end;
 
@@ -1151,42 +1238,15 @@ int main(int argc, char *argv[]) {
             }
         }
 
-        if (dstfile.name != NULL) /* Open destination file */
-            fileOpenWrite(dstfile.name, &dstfile);
-
-        /* Read sfnt header */
-        sfntReadHdr();
-
-        /* Process font */
-        if (options & OPT_LIST)
-            sfntDumpHdr();
-        else if (options & OPT_CHECK)
-            checkChecksums();
-        else {
-            if (options & OPT_EXTRACT)
-                extractTables();
-            if (options & (OPT_DELETE | OPT_ADD | OPT_FIX))
-                changed = sfntCopy();
-        }
-
-        /* Close files */
-        fileClose(&srcfile);
-        if (dstfile.fp != NULL) {
-            fileClose(&dstfile);
-            if (!changed) {
-                if (remove(dstfile.name) == -1)
-                    fatal(SFED_MSG_REMOVEERR, strerror(errno), dstfile.name);
-            } else if (strcmp(dstfile.name + strlen(dstfile.name) - strlen(tmpname), tmpname) == 0) { /* Rename tmp file to source file */
-                if (p_rename(srcfile.name, BACKUPNAME) == -1)
-                    fatal(SFED_MSG_BADRENAME, strerror(errno), srcfile.name);
-                if (p_rename(dstfile.name, srcfile.name) == -1)
-                    fatal(SFED_MSG_BADRENAME, strerror(errno), dstfile.name);
-                if (remove(BACKUPNAME) == -1)
-                    fatal(SFED_MSG_REMOVEERR, strerror(errno), BACKUPNAME);
-            }
-        }
+        if (batchmode) {
+            stats.start = ctuWallTime();
+            editBatch(argi, argv + argc - argi, BACKUPNAME);
+            reportStats();
+        } else
+            editFont(BACKUPNAME);
     } else { /* executing cmdlines from a script file */
     execscript :
+        stats.start = ctuWallTime();
 
     {
         char *end;
@@ -1240,47 +1300,20 @@ int main(int argc, char *argv[]) {
                 showUsage();
             }
 
-            fileOpenRead(srcfile.name, &srcfile);
-
-            if (dstfile.name != NULL) /* Open destination file */
-                fileOpenWrite(dstfile.name, &dstfile);
-
-            /* Read sfnt header */
-            sfntReadHdr();
-
-            /* Process font */
-            if (options & OPT_LIST)
-                sfntDumpHdr();
-            else if (options & OPT_CHECK)
-                checkChecksums();
-            else {
-                if (options & OPT_EXTRACT)
-                    extractTables();
-                if (options & (OPT_DELETE | OPT_ADD | OPT_FIX))
-                    changed = sfntCopy();
-            }
-
-            /* Close files */
-            fileClose(&srcfile);
-            if (dstfile.fp != NULL) {
-                char *fullbackupname;
-                fullbackupname = MakeFullPath(BACKUPNAME);
-                fileClose(&dstfile);
-                if (!changed) {
-                    if (remove(dstfile.name) == -1)
-                        fatal(SFED_MSG_REMOVEERR, strerror(errno), dstfile.name);
-                } else if (strcmp(dstfile.name + strlen(dstfile.name) - strlen(tmpname), tmpname) == 0) { /* Rename tmp file to source file */
-                    if (p_rename(srcfile.name, fullbackupname) == -1)
-                        fatal(SFED_MSG_BADRENAME, strerror(errno), srcfile.name);
-                    if (p_rename(dstfile.name, srcfile.name) == -1)
-                        fatal(SFED_MSG_BADRENAME, strerror(errno), dstfile.name);
-                    if (remove(fullbackupname) == -1)
-                        fatal(SFED_MSG_REMOVEERR, strerror(errno), fullbackupname);
-                }
+            {
+                char *fullbackupname = MakeFullPath(BACKUPNAME);
+                if (batchmode) {
+                    editBatch(argi, cmdl->args.array + cmdl->args.cnt - argi,
+                              fullbackupname);
+                    batchscript = 1;
+                } else
+                    editFont(fullbackupname);
                 free(fullbackupname);
             }
         }
 
+        if (batchscript)
+            reportStats();
         doingScripting = 0;
     }
     return 0;
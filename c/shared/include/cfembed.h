@@ -8,7 +8,7 @@
 #include "ctlshare.h"
 #include "sfntwrite.h"
 
-#define CEF_VERSION CTL_MAKE_VERSION(2, 0, 25)
+#define CEF_VERSION CTL_MAKE_VERSION(2, 0, 26)
 
 #ifdef __cplusplus
 extern "C" {
@@ -270,6 +270,29 @@ int cefMakeEmbeddingFont(cefCtx h, cefEmbedSpec *spec, cefMapCallback *map);
    in the event of an error. The list of possible error codes is specified
    below. */
 
+int cefBegFont(cefCtx h, float *UDV);
+int cefEndFont(cefCtx h);
+
+/* cefBegFont() opens the source stream and parses the source font once,
+   holding it in the context so that subsequent calls to
+   cefMakeEmbeddingFont() only fetch the glyphs of their subset. This avoids
+   reparsing the font's dictionaries, charset, and indexes when many subsets
+   are made from the same font, e.g. by a server embedding pages of a document.
+
+   The "UDV" parameter specifies the multiple master instance as described for
+   the "UDV" field of the cefEmbedSpec, which is ignored while a font is held.
+   The source stream remains open until cefEndFont() is called, which releases
+   the held font. cefFree() releases a font that is still held.
+
+   A held font belongs to the context that parsed it; the font reading
+   libraries fetch glyph data on demand and keep per-font buffers, so a client
+   that embeds concurrently should create one context (and source stream) per
+   thread rather than share one.
+
+   Both functions return 0 on success and a positive non-0 error code in the
+   event of an error. cefErrBadCall is returned if cefBegFont() is called while
+   a font is held or cefEndFont() is called while none is. */
+
 void cefFree(cefCtx h);
 
 /* cefFree() destroys the library context and all the resources allocated to
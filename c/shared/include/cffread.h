@@ -7,9 +7,10 @@
 
 #include "ctlshare.h"
 
-#define CFR_VERSION CTL_MAKE_VERSION(2, 1, 3)
+#define CFR_VERSION CTL_MAKE_VERSION(2, 1, 5)
 
 #include "absfont.h"
+#include "t2cstr.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -68,6 +69,7 @@ int cfrBegFont(cfrCtx h, long flags, long origin, int ttcIndex, abfTopDict **top
 #define CFR_SHORT_VF_NAME           (1 << 9)
 #define CFR_UNUSE_VF_NAMED_INSTANCE (1 << 10)
 #define CFR_CFF2_ONLY   (1<<11)
+#define CFR_SAME_SOURCE (1<<12)
 
 /* cfrBegFont() is called to initiate a new font parse. The source data stream
    (CFR_SRC_STREAM_ID) is opened, positioned at the offset specified by the
@@ -123,6 +125,13 @@ int cfrBegFont(cfrCtx h, long flags, long origin, int ttcIndex, abfTopDict **top
    CFR_CFF2_ONLY - don't read the CFF table even if it is available in the font along with CFF2.
    This flag is assumed when CFR_FLATTEN_VF is set.
 
+   CFR_SAME_SOURCE - the source data stream holds the same data as it did for
+   the previous cfrBegFont() call, e.g. when reading successive members of a
+   TrueType Collection. Members of a collection commonly share a single CFF
+   table; if this font's CFF data is at the same offset as the previous font's
+   and the same instance is selected, glyphs already decoded into the glyph
+   cache (see cfrSetGlyphCache()) are kept rather than decoded again.
+
    The "UDV" parameter specifies the User Design Vector to be used in
    flattening (snapshotting) a CFF2 variable font. If NULL, the font is
    flattened at the default instance. The parameter may be set to NULL for
@@ -303,6 +312,25 @@ void cfrSetLastResortInstanceNameCallback(cfrCtx h, cfrlastResortInstanceNameCal
    name prefix followed by "-<hex>" where <hex> is a hex string generated by
    hashing the design vector of the instance. */
 
+int cfrSetGlyphCache(cfrCtx h, size_t maxBytes);
+
+/* cfrSetGlyphCache() enables a cache of decoded charstrings (see t2cstr.h)
+   holding up to "maxBytes" bytes of glyph data. Clients that request the
+   same glyphs more than once per font, e.g. by iterating the glyphs to
+   gather their names before converting them, may then skip decoding the
+   charstrings on later requests. The cache is cleared by each call to
+   cfrBegFont() so entries are never shared between fonts or CFF2 instances,
+   unless the CFR_SAME_SOURCE flag identifies the new font as sharing the
+   previous font's CFF data.
+   A "maxBytes" value of 0 disables and frees the cache. cfrErrNoMemory is
+   returned if the cache couldn't be allocated. */
+
+void cfrGetGlyphCacheStats(cfrCtx h, t2cCacheStats *stats);
+
+/* cfrGetGlyphCacheStats() returns the counters of the glyph cache enabled
+   by cfrSetGlyphCache() via the "stats" parameter. All counters are zero if
+   the cache isn't enabled. */
+
 enum {
 #undef CTL_DCL_ERR
 #define CTL_DCL_ERR(name, string) name,
@@ -7,7 +7,7 @@
 
 #include "ctlshare.h"
 
-#define CTU_VERSION CTL_MAKE_VERSION(2, 0, 3)
+#define CTU_VERSION CTL_MAKE_VERSION(2, 1, 0)
 
 #include <stddef.h> /* For size_t */
 #include <stdio.h>  /* For size_t */
@@ -100,6 +100,64 @@ void ctuDtostr(char *buf, size_t bufLen, double value, int width, int precision)
    locale and thus the decimal point character is always a period and not
    comma. */
 
+unsigned short ctuDecrypt(unsigned short r, size_t length,
+                          const char *cipher, char *plain);
+
+/* ctuDecrypt() decrypts "length" bytes of Type 1 eexec or charstring data
+   from the "cipher" buffer to the "plain" buffer, starting with the
+   decryption state "r", and returns the state following the last byte. The
+   "cipher" and "plain" parameters may point to the same buffer. Several bytes
+   are decrypted at a time, so this is considerably faster than the byte by
+   byte loop given in the "Adobe Type 1 Font Format" specification. */
+
+unsigned long ctuHashName(const char *name);
+
+/* ctuHashName() returns the 32-bit FNV-1a hash of the null-terminated string
+   "name", e.g. a glyph name, for indexing a hash table. The value doesn't
+   depend on the size of long, so it may be saved in files. */
+
+unsigned long ctuHashCID(unsigned short cid);
+
+/* ctuHashCID() returns a 24-bit multiplicative hash of "cid" for indexing a
+   hash table. */
+
+double ctuWallTime(void);
+
+/* ctuWallTime() returns the elapsed wall clock time in seconds from an
+   arbitrary starting point, for timing intervals. On Windows the processor
+   time used by the process is returned instead. */
+
+typedef void(CTL_CDECL *ctuJobFunc)(long index, void *result, void *ctx);
+long ctuRunJobs(long count, int workers, int flags, ctuJobFunc func,
+                size_t resultSize, void *results, void *ctx);
+#define CTU_JOBS_KEEP_GOING (1 << 0) /* Run the jobs after a failed job */
+
+/* ctuRunJobs() runs "count" jobs, numbered from 0, in at most "workers"
+   forked worker processes and copies their stdout and stderr output to the
+   parent's stdout and stderr in job order once all the workers have
+   finished. Each worker takes the next job not yet taken by another worker
+   and calls "func" with the job's number, a zeroed block of "resultSize"
+   bytes for the job's result, and the "ctx" argument.
+
+   A worker has its own copy of the client's state, so anything the parent
+   needs from a job must be returned in the result block. The block of each
+   job that completed is copied to the corresponding element of the "results"
+   array, which may be NULL if "resultSize" is 0. A worker runs the jobs it
+   takes one after another, so a job must leave the state it was given as it
+   found it.
+
+   A job that ends its worker process, e.g. with a fatal error, ends the
+   output after that job's output, as in a serial run. The function returns
+   the number of jobs completed before the first failed job, i.e. "count" if
+   all the jobs succeeded. It returns -1, with errno set, if no worker could
+   be started or fork() isn't available (Windows).
+
+   If the CTU_JOBS_KEEP_GOING bit is set in "flags", a failed job's worker is
+   replaced by a new one forked from the parent and the remaining jobs are
+   run. The output of every job is copied, and the blocks of all the jobs are
+   copied to "results", so a job should record in its block that it
+   completed. The function then returns the number of jobs completed. */
+
 void ctuGetVersion(ctlVersionCallbacks *cb);
 
 /* ctuGetVersion() returns the library version number and name via the client
@@ -7,7 +7,7 @@
 
 #include "ctlshare.h"
 
-#define SFW_VERSION CTL_MAKE_VERSION(1, 0, 6)
+#define SFW_VERSION CTL_MAKE_VERSION(1, 0, 7)
 
 #include "absfont.h"
 
@@ -122,8 +122,12 @@ int sfwRegisterTable(sfwCtx h, sfwTableCallbacks *cb);
    "use_checksum" parameter to 1. The library initializes the value pointed to
    by the "use_checksum" parameter to 0 before the write_table() function is
    called so the library performs the checksum calculation by default. The
-   write_table() callback will only be called if the the corresponding
-   fill_table() callback returned a "dont_write" value of 0.
+   library computes the checksum as the data passes through the "stm_cb"
+   callbacks; if the table data is written some other way, or the callback
+   seeks the stream while writing, the library reads the table back from the
+   stream to compute the checksum instead. The write_table() callback will only
+   be called if the the corresponding fill_table() callback returned a
+   "dont_write" value of 0.
 
    The "write_seq" field is associated with the write_table() callback and is
    used to establish the order in which all the registered write_table()
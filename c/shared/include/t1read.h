@@ -7,7 +7,7 @@
 
 #include "ctlshare.h"
 
-#define T1R_VERSION CTL_MAKE_VERSION(1, 0, 45)
+#define T1R_VERSION CTL_MAKE_VERSION(1, 0, 46)
 
 #include "absfont.h"
 
@@ -33,7 +33,7 @@ extern "C" {
    t1rGetSubrs(), respectively.
 
    Multiple master fonts are always snapshot to a client-supplied instance that
-   is set via t1rBegFont().
+   is set via t1rBegFont() and may be changed via t1rSetInstance().
 
    Memory management and source data functions are provided by two sets of
    client-supplied callbacks described in ctlshare.h. */
@@ -184,6 +184,22 @@ const float *t1rGetWV(t1rCtx h, long *nMasters);
    "nMasters" parameter is set to 0 and the function returns NULL for single
    master fonts. */
 
+int t1rSetInstance(t1rCtx h, float *UDV, abfTopDict **top);
+
+/* t1rSetInstance() may be called after t1rBegFont() has parsed a multiple
+   master font in order to snapshot it to another instance without parsing
+   the font again. The "UDV" parameter specifies the new User Design Vector.
+   The weight vector is recomputed, the blended dictionary values saved during
+   the parse are blended again, and the instance FontName and XUID are remade
+   from the master values. Subsequent glyph requests are blended at the new
+   instance using the charstrings already held in the tmp stream. The glyph
+   names are restored, in case the client changed the "gname" fields of the
+   glyph info it was passed. The "top" parameter is set as by t1rBegFont().
+   The client should call t1rResetGlyphs() before requesting glyphs again.
+
+   t1rErrNotMM is returned if the font isn't a multiple master font or "UDV"
+   is NULL. */
+
 const ctlSubrs *t1rGetSubrs(t1rCtx h, int iFD, const ctlRegion **region);
 
 /* t1rGetSubrs() returns per-Private-dictionary subroutine offset data for the
@@ -44,3 +44,4 @@ CTL_DCL_ERR(t1rErrSTILimit,    "string INDEX limit exceeded")
 CTL_DCL_ERR(t1rErrSTIUndef,    "string undefined for index")
 CTL_DCL_ERR(t1rErrFontName,    "FontName missing")
 CTL_DCL_ERR(t1rErrMMParse,     "Multiple Master parse error")
+CTL_DCL_ERR(t1rErrNotMM,       "not a multiple master font")
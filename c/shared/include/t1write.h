@@ -7,7 +7,7 @@
 
 #include "ctlshare.h"
 
-#define T1W_VERSION CTL_MAKE_VERSION(1, 0, 35)
+#define T1W_VERSION CTL_MAKE_VERSION(1, 0, 36)
 
 #include "absfont.h"
 
@@ -30,17 +30,13 @@ extern "C" {
    interface in order to generate the desired font.
 
    Memory management and stream I/O are implemented via two sets of
-   client-supplied callback functions passed to t1wNew(). I/O is performed on
-   two abstract data streams:
-
-   o Type 1 data (w)
-   o temporary data (rw)
-
-   These streams are managed by a single set of client callback functions
-   enabling the client to choose from a wide variety of implementation schemes
-   ranging from disk files to memory buffers. The temporary stream is used to
-   keep the run-time memory usage within reasonable limits when handling large
-   fonts.
+   client-supplied callback functions passed to t1wNew(). Output is written to
+   the Type 1 data stream (w), which is managed by a set of client callback
+   functions enabling the client to choose from a wide variety of
+   implementation schemes ranging from disk files to memory buffers. Encrypted
+   charstrings are accumulated in memory until the font is written, and eexec
+   encryption and hexadecimal encoding are performed a buffer at a time, so no
+   temporary stream is used.
 
    Glyph data is passed to the library via the set of glyph callback functions
    defined in t1wGlyphCallbacks. */
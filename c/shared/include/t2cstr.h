@@ -11,7 +11,7 @@
 
 #include "ctlshare.h"
 
-#define T2C_VERSION CTL_MAKE_VERSION(1, 0, 23)
+#define T2C_VERSION CTL_MAKE_VERSION(1, 0, 24)
 
 #include "absfont.h"
 
@@ -153,6 +153,57 @@ int t2cParse(long offset, long endOffset, t2cAuxData *aux, unsigned short gid, c
    "callgsubr" operators. A subroutine should terminate with one of the
    preceding operators or "return". */
 
+typedef struct t2cGlyphCache_ *t2cGlyphCache;
+
+t2cGlyphCache t2cCacheNew(ctlMemoryCallbacks *mem, size_t maxBytes);
+void t2cCacheReset(t2cGlyphCache cache);
+void t2cCacheFree(t2cGlyphCache cache);
+
+/* A decoded glyph cache may be used by clients that parse the same glyphs
+   more than once, e.g. to gather glyph metrics or names before converting
+   the glyph paths. The first parse of a glyph records the sequence of glyph
+   callbacks made by t2cParse() together with their arguments; later parses
+   of the same glyph replay the recorded sequence directly to the client
+   without decoding the charstring or expanding its subroutines again.
+
+   t2cCacheNew() creates a cache that holds at most "maxBytes" bytes of
+   recorded glyph data, allocated with the memory callbacks specified by the
+   "mem" parameter. When a new recording would exceed that limit the least
+   recently used glyphs are evicted. NULL is returned if the cache couldn't be
+   allocated.
+
+   Cache entries are keyed by glyph ID and are only valid while the "aux"
+   data passed to t2cParseCached() describes the same font instance. A client
+   must therefore call t2cCacheReset() to discard all entries whenever it
+   begins a new font, or selects a different CFF2 instance or matrix.
+   t2cCacheFree() discards all entries and frees the cache. */
+
+int t2cParseCached(t2cGlyphCache cache, long offset, long endOffset, t2cAuxData *aux, unsigned short gid, cff2GlyphCallbacks *cff2, abfGlyphCallbacks *glyph, ctlMemoryCallbacks *mem);
+
+/* t2cParseCached() takes the same parameters and has the same effect as
+   t2cParse() but looks up the glyph in the "cache" parameter first. A glyph
+   whose entry was recorded with the same parse flags and the same set of
+   non-NULL glyph callbacks is replayed from the cache, including its effects
+   on the "bchar" and "achar" fields and the glyph's blendInfo. A parse
+   with the T2C_WIDTH_ONLY flag set is satisfied from a cached glyph when
+   possible but is never recorded. Charstrings that fail to parse are not
+   cached. */
+
+typedef struct
+{
+    unsigned long hits;      /* Glyphs replayed from the cache */
+    unsigned long misses;    /* Glyphs decoded from charstring data */
+    unsigned long evictions; /* Glyphs discarded to stay within the limit */
+    unsigned long entries;   /* Glyphs currently cached */
+    size_t bytes;            /* Bytes currently used by cached glyphs */
+} t2cCacheStats;
+
+void t2cCacheGetStats(t2cGlyphCache cache, t2cCacheStats *stats);
+
+/* t2cCacheGetStats() copies the cache counters to the "stats" parameter.
+   The counters accumulate until the cache is freed; they are not cleared by
+   t2cCacheReset(). */
+
 enum {
 #undef CTL_DCL_ERR
 #define CTL_DCL_ERR(name, string) name,
@@ -7,7 +7,7 @@
 
 #include "ctlshare.h"
 
-#define TTR_VERSION CTL_MAKE_VERSION(1, 0, 22)
+#define TTR_VERSION CTL_MAKE_VERSION(1, 0, 23)
 
 #include "absfont.h"
 
@@ -55,7 +55,8 @@ int ttrBegFont(ttrCtx h, long flags, long origin, int iTTC, abfTopDict **top, fl
 
 enum {
     TTR_EXACT_PATH = 1 << 0, /* Return mathematically exact path conversion */
-    TTR_BOTH_PATHS = 1 << 1  /* Return combined approx and exact conversions */
+    TTR_BOTH_PATHS = 1 << 1, /* Return combined approx and exact conversions */
+    TTR_LAZY_LOAD  = 1 << 2  /* Read per-glyph table data on first access */
 };
 
 /* TrueType curve segments are represented as quadratic Beziers but the path
@@ -69,6 +70,14 @@ enum {
    This is really only useful for comparing the quality of the approximate
    conversion compared to the exact conversion, by overprinting, for example.
 
+   Glyph outlines are always read when a glyph is requested, but by default
+   the loca, hmtx and gvar offset arrays and any HVAR metrics are read for
+   every glyph by ttrBegFont(). If TTR_LAZY_LOAD is specified, each glyph's
+   entries are instead read when the glyph, or a compound glyph using it as a
+   component, is first requested. This makes opening a large font cheaper for
+   clients that only access a few of its glyphs, at the cost of extra seeks
+   per glyph when all glyphs are read. Glyph data are the same in either mode.
+
    When parsing a TrueType Collection (TTC) the "iTTC" parameter may be used to
    index a specific font within the TTC TableDirectory. The "iTTC" must be set
    to zero when parsing regular TrueType fonts.
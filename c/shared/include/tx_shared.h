@@ -34,6 +34,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <setjmp.h>
 
 #if PLAT_MAC
 #include <console.h>
@@ -130,10 +131,11 @@ typedef struct /* Data stream */
     short flags;
 #define STM_TMP_ERR    (1 << 0) /* Temporary stream error occurred */
 #define STM_DONT_CLOSE (1 << 1) /* Don't close stream */
+#define STM_DISCARD    (1 << 2) /* Count but discard written data */
     char *filename;
     FILE *fp;
     char *buf;
-    size_t pos; /* Tmp stream position */
+    size_t pos; /* Tmp stream position; discarded byte count */
 } Stream;
 
 typedef struct /* Font record */
@@ -245,6 +247,7 @@ struct txCtx_ {
     char *modename;                   /* Name of current mode */
     void *appSpecificInfo;            /* different data for rotateFont.c & mergeFonts.c */
     void (*appSpecificFree)(txCtx h); /* free for app-specific info */
+    jmp_buf *batchEnv;                /* fatal() returns here in tx -batch mode */
     abfTopDict *top;                  /* Top dictionary */
     struct                            /* Source data */
     {
@@ -297,6 +300,7 @@ struct txCtx_ {
         char *sr; /* Source root path */
         char *sd; /* Source directory path */
         char *dd; /* Destination directory path */
+        long workers; /* Max concurrent worker processes for -a/-A (-j) */
         char src[FILENAME_MAX];
         char dst[FILENAME_MAX];
     } file;
@@ -324,26 +328,36 @@ struct txCtx_ {
         {
             unsigned short flags; /* cefEmbedSpec flags */
             char *F;
+            long split; /* Number of fonts to split subset into (-cefsplit) */
         } cef;
     } arg;
+    struct /* Instances read from each font (repeated -U, tx only) */
+    {
+        dnaDCL(char *, udvs); /* -U args */
+        int reset;            /* Font file read; next -U starts a new list */
+    } inst;
     struct /* t1read library */
     {
         t1rCtx ctx;
         Stream tmp;
         Stream dbg;
         long flags;
+        long bench; /* Font parsing benchmark repetitions */
     } t1r;
     struct /* cffread library */
     {
         cfrCtx ctx;
         Stream dbg;
         long flags;
+        long cacheKB; /* Decoded glyph cache size; 0 if disabled */
+        long bench;   /* Glyph decoding benchmark repetitions */
     } cfr;
     struct /* ttread library */
     {
         ttrCtx ctx;
         Stream dbg;
         long flags;
+        long bench; /* Glyph decoding benchmark repetitions */
     } ttr;
     struct /* svread library */
     {
@@ -377,6 +391,7 @@ struct txCtx_ {
         dnaDCL(cefSubsetGlyph, subset);
         dnaDCL(char *, gnames);
         dnaDCL(unsigned short, lookup); /* Glyph lookup */
+        long bench;                     /* Subsetting benchmark repetitions */
     } cef;
     struct /* abf facilities */
     {
@@ -431,6 +446,7 @@ struct txCtx_ {
         long maxGlyphs;
         long fd;               /* -decid target fd */
         dnaDCL(char, gnames); /* -decid glyph names */
+        long bench;           /* Font writing benchmark repetitions */
     } t1w;
     struct /* svgwrite library */
     {
@@ -565,6 +581,7 @@ void buildFontList(txCtx h);
 void callbackGlyph(txCtx h, int type, unsigned short id, char *name);
 void callbackSubset(txCtx h);
 void dcf_ParseTableArg(txCtx h, char *arg);
+void dstFileMakeAutoName(txCtx h, char *dst, char *srcname);
 void dstFileSetName(txCtx h, char *filename);
 void CTL_CDECL fatal(txCtx h, char *fmt, ...);
 void fileError(txCtx h, char *filename);
@@ -582,6 +599,7 @@ void seedtime(void);
 void setMode(txCtx h, int mode);
 void stmFree(txCtx h, Stream *s);
 void stmInit(txCtx h);
+void stmRenewTmp(txCtx h);
 void svrReadFont(txCtx h, long origin);
 void t1rReadFont(txCtx h, long origin);
 void ttrReadFont(txCtx h, long origin, int iTTC);
@@ -205,6 +205,7 @@ struct cefCtx_ {
     long flags;                   /* Status flags */
 #define DO_NEW_TABLES (1 << 0)    /* Call new table functions */
 #define CLOSE_DST_STREAM (1 << 1) /* Close destination stream */
+#define SRC_HELD (1 << 2)         /* Source font held by cefBegFont() */
     long svwFlags;                /* svgwrite library flags */
     cefEmbedSpec *spec;           /* Client's embedding spec */
     struct                        /* Streams */
@@ -212,6 +213,7 @@ struct cefCtx_ {
         void *src;
         void *dst;
         ctlStreamCallbacks cb;
+        ctlStreamCallbacks *table; /* sfntwrite stream for table being written */
     } stm;
     struct /* Source stream */
     {
@@ -247,7 +249,16 @@ struct cefCtx_ {
         CoverageFormat2 fmt2; /* Format 2 data */
     } coverage;
     dnaDCL(GlyphMap, subset); /* Working subset specification */
-    struct                    /* Client callbacks */
+    struct                    /* Held font values changed by embedding specs */
+    {
+        abfString FontName;
+        abfString CIDFontName;
+        abfString Registry;
+        abfString Ordering;
+        long Supplement;
+        dnaDCL(long, LanguageGroup); /* [FDArray.cnt] */
+    } held;
+    struct /* Client callbacks */
     {
         ctlMemoryCallbacks mem;
         ctlStreamCallbacks stm;
@@ -290,22 +301,30 @@ static void srcFillBuf(cefCtx h, long offset) {
     h->src.end = h->src.buf + h->src.length;
 }
 
-/* Open source and destination streams. */
-static void stmsOpen(cefCtx h) {
+/* Open source stream. */
+static void srcOpen(cefCtx h) {
     h->stm.src = h->cb.stm.open(&h->cb.stm, CEF_SRC_STREAM_ID, 0);
     if (h->stm.src == NULL)
         fatal(h, cefErrSrcStream);
     srcFillBuf(h, 0);
+}
+
+/* Close source stream. */
+static void srcClose(cefCtx h) {
+    if (h->cb.stm.close(&h->cb.stm, h->stm.src))
+        fatal(h, cefErrSrcStream);
+}
 
+/* Open destination stream. */
+static void dstOpen(cefCtx h) {
     h->stm.dst = h->cb.stm.open(&h->cb.stm, CEF_DST_STREAM_ID, 0);
     if (h->stm.dst == NULL)
         fatal(h, cefErrDstStream);
+    h->stm.table = NULL;
 }
 
-/* Close source and destination streams. */
-static void stmsClose(cefCtx h) {
-    if (h->cb.stm.close(&h->cb.stm, h->stm.src))
-        fatal(h, cefErrSrcStream);
+/* Close destination stream. */
+static void dstClose(cefCtx h) {
     if (h->cb.stm.close(&h->cb.stm, h->stm.dst))
         fatal(h, cefErrDstStream);
 }
@@ -356,7 +375,7 @@ static void dstWrite2(cefCtx h, unsigned short value) {
     unsigned char buf[2];
     buf[0] = (unsigned char)(value >> 8);
     buf[1] = (unsigned char)value;
-    if (h->cb.stm.write(&h->cb.stm, h->stm.dst, sizeof(buf), (char *)buf) !=
+    if (h->stm.cb.write(&h->stm.cb, h->stm.dst, sizeof(buf), (char *)buf) !=
         sizeof(buf))
         fatal(h, cefErrDstStream);
 }
@@ -368,7 +387,7 @@ static void dstWrite4(cefCtx h, unsigned long value) {
     buf[1] = (unsigned char)(value >> 16);
     buf[2] = (unsigned char)(value >> 8);
     buf[3] = (unsigned char)value;
-    if (h->cb.stm.write(&h->cb.stm, h->stm.dst, sizeof(buf), (char *)buf) !=
+    if (h->stm.cb.write(&h->stm.cb, h->stm.dst, sizeof(buf), (char *)buf) !=
         sizeof(buf))
         fatal(h, cefErrDstStream);
 }
@@ -411,6 +430,23 @@ static size_t stm_read(ctlStreamCallbacks *cb, void *stream, char **ptr) {
         return h->cb.stm.read(&h->cb.stm, stream, ptr);
 }
 
+/* Write to stream. Destination data written while sfntwrite is writing a
+   table, by cffwrite or the table writers below, is passed through the stream
+   sfntwrite provided for the table so that it can checksum the data. */
+static size_t stm_write(ctlStreamCallbacks *cb, void *stream,
+                        size_t count, char *ptr) {
+    cefCtx h = cb->indirect_ctx;
+    ctlStreamCallbacks *table = h->stm.table;
+    if (stream == h->stm.dst && table != NULL) {
+        size_t n;
+        h->stm.table = NULL; /* sfntwrite passes the data back to us */
+        n = table->write(table, stream, count, ptr);
+        h->stm.table = table;
+        return n;
+    }
+    return h->cb.stm.write(&h->cb.stm, stream, count, ptr);
+}
+
 /* Close stream. */
 static int stm_close(ctlStreamCallbacks *cb, void *stream) {
     cefCtx h = cb->indirect_ctx;
@@ -426,6 +462,7 @@ static void stmInit(cefCtx h) {
     /* Patch client callbacks */
     h->stm.cb.indirect_ctx = h; /* Provide cfembed context */
     h->stm.cb.open = stm_open;
+    h->stm.cb.write = stm_write;
     h->stm.cb.close = stm_close;
 }
 
@@ -1113,6 +1150,8 @@ static int cmapWrite(sfwTableCallbacks *cb,
     cmapFmt4 *fmt4;
     cmapFmt12 *fmt12;
 
+    h->stm.table = stm_cb;
+
     /* Write header */
     dstWrite2(h, h->cmap.tbl.version);
     dstWrite2(h, h->cmap.tbl.nEncodings);
@@ -1146,6 +1185,7 @@ static int cmapWrite(sfwTableCallbacks *cb,
     if (h->cmap.tbl._flags & FILLEDFMT12)
         cmapWriteFmt12(h);
 
+    h->stm.table = NULL;
     return 0;
 }
 
@@ -1200,10 +1240,8 @@ static int CTL_CDECL cmpNames(const void *first, const void *second) {
     return strcmp(((GlyphMap *)first)->gname, ((GlyphMap *)second)->gname);
 }
 
-/* Call t1read library to subset and convert Type 1 font data. */
-static void t1Parse(cefCtx h) {
-    long i;
-
+/* Call t1read library to parse Type 1 font data. */
+static void t1BegFont(cefCtx h, float *UDV) {
     /* Patch in filtered stream read */
     h->stm.cb.read = stm_read;
 
@@ -1215,10 +1253,17 @@ static void t1Parse(cefCtx h) {
     }
 
     /* Parse font */
-    if (t1rBegFont(h->ctx.t1r,
-                   T1R_UPDATE_OPS, h->src.origin, &h->top, h->spec->UDV))
+    if (t1rBegFont(h->ctx.t1r, T1R_UPDATE_OPS, h->src.origin, &h->top, UDV))
         fatal(h, cefErrT1Parse);
 
+    /* Restore client stream read */
+    h->stm.cb.read = h->cb.stm.read;
+}
+
+/* Call t1read library to subset and convert Type 1 font data. */
+static void t1Parse(cefCtx h) {
+    long i;
+
     if (h->top->sup.flags & ABF_CID_FONT) {
         /* CID font; check name override */
         if (h->spec->newFontName != NULL)
@@ -1244,15 +1289,10 @@ static void t1Parse(cefCtx h) {
                                   h->subset.array[i].gname, &h->cb.glyph))
                 fatal(h, cefErrNoGlyph);
     }
-
-    /* Restore client stream read */
-    h->stm.cb.read = h->cb.stm.read;
 }
 
-/* Call cffread library to subset CFF data. */
-static void cffParse(cefCtx h) {
-    long i;
-
+/* Call cffread library to parse CFF data. */
+static void cffBegFont(cefCtx h) {
     if (h->ctx.cfr == NULL) {
         /* Initialize library */
         h->ctx.cfr = cfrNew(&h->cb.mem, &h->stm.cb, CFR_CHECK_ARGS);
@@ -1263,6 +1303,11 @@ static void cffParse(cefCtx h) {
     /* Parse font */
     if (cfrBegFont(h->ctx.cfr, CFR_UPDATE_OPS, h->src.origin, 0, &h->top, NULL))
         fatal(h, cefErrCFFParse);
+}
+
+/* Call cffread library to subset CFF data. */
+static void cffParse(cefCtx h) {
+    long i;
 
     if (h->top->sup.flags & ABF_CID_FONT) {
         /* CID font; check name override */
@@ -1295,10 +1340,8 @@ static void cffParse(cefCtx h) {
     }
 }
 
-/* Call ttread library to subset TrueType data. */
-static void ttParse(cefCtx h) {
-    long i;
-
+/* Call ttread library to parse TrueType data. */
+static void ttBegFont(cefCtx h) {
     if (h->ctx.ttr == NULL) {
         /* Initialize library */
         h->ctx.ttr = ttrNew(&h->cb.mem, &h->stm.cb, TTR_CHECK_ARGS);
@@ -1309,6 +1352,11 @@ static void ttParse(cefCtx h) {
     /* Parse font */
     if (ttrBegFont(h->ctx.ttr, TTR_EXACT_PATH, h->src.origin, 0, &h->top, 0))
         fatal(h, cefErrTTParse);
+}
+
+/* Call ttread library to subset TrueType data. */
+static void ttParse(cefCtx h) {
+    long i;
 
     /* Check name override */
     if (h->spec->newFontName != NULL)
@@ -1324,6 +1372,103 @@ static void ttParse(cefCtx h) {
             fatal(h, cefErrNoGlyph);
 }
 
+/* Parse source font. */
+static void srcBegFont(cefCtx h, float *UDV) {
+    switch (h->src.type) {
+        case SRC_TYPE1:
+            t1BegFont(h, UDV);
+            break;
+        case SRC_CFF:
+            cffBegFont(h);
+            break;
+        case SRC_TRUETYPE:
+            ttBegFont(h);
+            break;
+    }
+}
+
+/* End source font parse. */
+static void srcEndFont(cefCtx h) {
+    switch (h->src.type) {
+        case SRC_TYPE1:
+            if (t1rEndFont(h->ctx.t1r))
+                fatal(h, cefErrT1Parse);
+            break;
+        case SRC_CFF:
+            if (cfrEndFont(h->ctx.cfr))
+                fatal(h, cefErrCFFParse);
+            break;
+        case SRC_TRUETYPE:
+            if (ttrEndFont(h->ctx.ttr))
+                fatal(h, cefErrTTParse);
+            break;
+    }
+}
+
+/* Save held font values that embedding specs may change. */
+static void saveHeldFont(cefCtx h) {
+    volatile long i; /* volatile suppresses optimizer warning */
+    h->held.FontName = h->top->FDArray.array[0].FontName;
+    h->held.CIDFontName = h->top->cid.CIDFontName;
+    h->held.Registry = h->top->cid.Registry;
+    h->held.Ordering = h->top->cid.Ordering;
+    h->held.Supplement = h->top->cid.Supplement;
+    dnaSET_CNT(h->held.LanguageGroup, h->top->FDArray.cnt);
+    for (i = 0; i < h->top->FDArray.cnt; i++)
+        h->held.LanguageGroup.array[i] =
+            h->top->FDArray.array[i].Private.LanguageGroup;
+}
+
+/* Reset held font for a new subset. */
+static void resetHeldFont(cefCtx h) {
+    long i;
+    int result = 0; /* Suppress optimizer warning */
+
+    switch (h->src.type) {
+        case SRC_TYPE1:
+            result = t1rResetGlyphs(h->ctx.t1r);
+            break;
+        case SRC_CFF:
+            result = cfrResetGlyphs(h->ctx.cfr);
+            break;
+        case SRC_TRUETYPE:
+            result = ttrResetGlyphs(h->ctx.ttr);
+            break;
+    }
+    if (result)
+        fatal(h, cefErrCantHappen);
+
+    h->top->FDArray.array[0].FontName = h->held.FontName;
+    h->top->cid.CIDFontName = h->held.CIDFontName;
+    h->top->cid.Registry = h->held.Registry;
+    h->top->cid.Ordering = h->held.Ordering;
+    h->top->cid.Supplement = h->held.Supplement;
+    for (i = 0; i < h->top->FDArray.cnt; i++)
+        h->top->FDArray.array[i].Private.LanguageGroup =
+            h->held.LanguageGroup.array[i];
+}
+
+/* Parse source font, unless held, and pass subset glyphs to glyph
+   callbacks. */
+static void srcSubset(cefCtx h) {
+    if (h->flags & SRC_HELD)
+        resetHeldFont(h);
+    else
+        srcBegFont(h, h->spec->UDV);
+
+    switch (h->src.type) {
+        case SRC_TYPE1:
+            t1Parse(h);
+            break;
+        case SRC_CFF:
+            cffParse(h);
+            break;
+        case SRC_TRUETYPE:
+            ttParse(h);
+            break;
+    }
+}
+
 /* Match glyph name in subset. */
 static int CTL_CDECL matchName(const void *key, const void *value) {
     return strcmp((char *)key, ((GlyphMap *)value)->gname);
@@ -1378,17 +1523,7 @@ static int CFF_Fill(sfwTableCallbacks *cb, int *dont_write) {
         cfwBegFont(h->ctx.cfw, &map_cb, 0))
         fatal(h, cefErrCffwriteFont);
 
-    switch (h->src.type) {
-        case SRC_TYPE1:
-            t1Parse(h);
-            break;
-        case SRC_CFF:
-            cffParse(h);
-            break;
-        case SRC_TRUETYPE:
-            ttParse(h);
-            break;
-    }
+    srcSubset(h);
 
     if (h->spec->flags & CEF_FORCE_LANG_1) {
         /* Force LanguageGroup 1 in all Private DICTs */
@@ -1408,20 +1543,8 @@ static int CFF_Fill(sfwTableCallbacks *cb, int *dont_write) {
         fatal(h, cefErrCffwriteFont);
 
     /* End parse */
-    switch (h->src.type) {
-        case SRC_TYPE1:
-            if (t1rEndFont(h->ctx.t1r))
-                fatal(h, cefErrT1Parse);
-            break;
-        case SRC_CFF:
-            if (cfrEndFont(h->ctx.cfr))
-                fatal(h, cefErrCFFParse);
-            break;
-        case SRC_TRUETYPE:
-            if (ttrEndFont(h->ctx.ttr))
-                fatal(h, cefErrTTParse);
-            break;
-    }
+    if (!(h->flags & SRC_HELD))
+        srcEndFont(h);
 
     if (h->spec->subset.names != NULL)
         /* Re-sort subset by id */
@@ -1440,8 +1563,10 @@ static int CFF_Write(sfwTableCallbacks *cb,
     cefCtx h = cb->ctx;
 
     /* Write CFF data */
+    h->stm.table = stm_cb;
     if (cfwEndSet(h->ctx.cfw))
         fatal(h, cefErrCffwriteFont);
+    h->stm.table = NULL;
 
     return 0;
 }
@@ -1797,6 +1922,8 @@ static int GPOSWrite(sfwTableCallbacks *cb,
        is relative to <component>. Offsets, both absolute and relative, within
        the GPOS table are shown in parentheses. */
 
+    h->stm.table = stm_cb;
+
     /* Write GPOS header */
     dstWrite4(h, 0x00010000); /* Version */
     dstWrite2(h, 0x000a);     /* ScriptList <Header> */
@@ -1845,6 +1972,7 @@ static int GPOSWrite(sfwTableCallbacks *cb,
     writePairPos1(h);
     writeCoverage(h);
 
+    h->stm.table = NULL;
     return 0;
 }
 
@@ -1986,8 +2114,11 @@ int cefMakeEmbeddingFont(cefCtx h, cefEmbedSpec *spec, cefMapCallback *map) {
     h->spec = spec;
     h->cb.map = map;
 
-    stmsOpen(h);
-    h->src.type = getFontType(h);
+    if (!(h->flags & SRC_HELD)) {
+        srcOpen(h);
+        h->src.type = getFontType(h);
+    }
+    dstOpen(h);
 
     if (spec->flags & CEF_WRITE_SVG) /* Write SVG font */
     {
@@ -2005,37 +2136,15 @@ int cefMakeEmbeddingFont(cefCtx h, cefEmbedSpec *spec, cefMapCallback *map) {
         if (svwBegFont(hSvw, h->svwFlags))
             fatal(h, cefErrCffwriteFont);
 
-        switch (h->src.type) {
-            case SRC_TYPE1:
-                t1Parse(h);
-                break;
-            case SRC_CFF:
-                cffParse(h);
-                break;
-            case SRC_TRUETYPE:
-                ttParse(h);
-                break;
-        }
+        srcSubset(h);
 
         /* Write the SVG font */
         if (svwEndFont(hSvw, h->top))
             fatal(h, cefErrCffwriteFont);
 
         /* End parse */
-        switch (h->src.type) {
-            case SRC_TYPE1:
-                if (t1rEndFont(h->ctx.t1r))
-                    fatal(h, cefErrT1Parse);
-                break;
-            case SRC_CFF:
-                if (cfrEndFont(h->ctx.cfr))
-                    fatal(h, cefErrCFFParse);
-                break;
-            case SRC_TRUETYPE:
-                if (ttrEndFont(h->ctx.ttr))
-                    fatal(h, cefErrTTParse);
-                break;
-        }
+        if (!(h->flags & SRC_HELD))
+            srcEndFont(h);
 
         svwFree(hSvw);
         h->cb.glyph = cb;
@@ -2052,7 +2161,49 @@ int cefMakeEmbeddingFont(cefCtx h, cefEmbedSpec *spec, cefMapCallback *map) {
             fatal(h, cefErrSfntwrite);
     }
 
-    stmsClose(h);
+    dstClose(h);
+    if (!(h->flags & SRC_HELD))
+        srcClose(h);
+
+    HANDLER
+    return Exception.Code;
+    END_HANDLER
+
+    return cefSuccess;
+}
+
+/* Parse source font and hold it for subsequent embedding requests. */
+int cefBegFont(cefCtx h, float *UDV) {
+    if (h->flags & SRC_HELD)
+        return cefErrBadCall;
+
+    /* Set error handler */
+    DURING_EX(h->err.env)
+
+    srcOpen(h);
+    h->src.type = getFontType(h);
+    srcBegFont(h, UDV);
+    saveHeldFont(h);
+    h->flags |= SRC_HELD;
+
+    HANDLER
+    return Exception.Code;
+    END_HANDLER
+
+    return cefSuccess;
+}
+
+/* Release held source font. */
+int cefEndFont(cefCtx h) {
+    if (!(h->flags & SRC_HELD))
+        return cefErrBadCall;
+    h->flags &= ~SRC_HELD;
+
+    /* Set error handler */
+    DURING_EX(h->err.env)
+
+    srcEndFont(h);
+    srcClose(h);
 
     HANDLER
     return Exception.Code;
@@ -2102,7 +2253,10 @@ cefCtx cefNew(ctlMemoryCallbacks *mem_cb, ctlStreamCallbacks *stm_cb,
     GPOSInit(h);
     h->stm.src = NULL;
     h->stm.dst = NULL;
+    h->stm.table = NULL;
     h->subset.size = 0;
+    h->held.LanguageGroup.size = 0;
+    h->flags = 0;
     h->ctx.dna = NULL;
 
     /* Copy callbacks */
@@ -2128,6 +2282,7 @@ cefCtx cefNew(ctlMemoryCallbacks *mem_cb, ctlStreamCallbacks *stm_cb,
     h->flags = DO_NEW_TABLES;
     h->svwFlags = 0;
     dnaINIT(h->ctx.dna, h->subset, 256, 128);
+    dnaINIT(h->ctx.dna, h->held.LanguageGroup, 1, 10);
     h->cb.glyph = cfwGlyphCallbacks;
     /* This keeps these callbacks from being used when
        writing a regular CFF, and avoids the overhead of processing the
@@ -2170,7 +2325,11 @@ void cefFree(cefCtx h) {
     if (h == NULL)
         return;
 
+    if (h->flags & SRC_HELD)
+        (void)cefEndFont(h);
+
     dnaFREE(h->subset);
+    dnaFREE(h->held.LanguageGroup);
 
     /* Free sfnt tables */
     if (h->ctx.sfw != NULL)
@@ -208,7 +208,14 @@ struct cfrCtx_ /* Context */
     {
         dnaCtx dna; /* dynarr */
         sfrCtx sfr; /* sfntread */
+        t2cGlyphCache t2c; /* t2cstr decoded glyph cache (optional) */
     } ctx;
+    struct /* Font whose glyphs are in the glyph cache */
+    {
+        Offset origin;               /* CFF data origin */
+        unsigned short axisCount;    /* CFF2 instance */
+        Fixed ndv[CFF2_MAX_AXES];
+    } cached;
     struct /* Error handling */
     {
         _Exc_Buf env;
@@ -423,6 +430,7 @@ void cfrFree(cfrCtx h) {
 
     dnaFree(h->ctx.dna);
     sfrFree(h->ctx.sfr);
+    t2cCacheFree(h->ctx.t2c);
 
     /* Close debug stream */
     if (h->stm.dbg != NULL)
@@ -2648,6 +2656,47 @@ void cfrSetLastResortInstanceNameCallback(cfrCtx h, cfrlastResortInstanceNameCal
     h->cff2.lastResortInstanceNameCallback = cb;
 }
 
+/* Enable, resize, or disable decoded glyph cache. */
+int cfrSetGlyphCache(cfrCtx h, size_t maxBytes) {
+    t2cCacheFree(h->ctx.t2c);
+    h->ctx.t2c = NULL;
+    if (maxBytes == 0)
+        return cfrSuccess;
+    h->ctx.t2c = t2cCacheNew(&h->cb.mem, maxBytes);
+    return (h->ctx.t2c == NULL) ? cfrErrNoMemory : cfrSuccess;
+}
+
+/* Get decoded glyph cache counters. */
+void cfrGetGlyphCacheStats(cfrCtx h, t2cCacheStats *stats) {
+    if (h->ctx.t2c == NULL)
+        memset(stats, 0, sizeof(*stats));
+    else
+        t2cCacheGetStats(h->ctx.t2c, stats);
+}
+
+/* Discard the cached glyphs unless they were decoded from the same CFF data
+   and instance as the font being read, as happens when the members of a
+   collection share a CFF table. */
+static void updateGlyphCache(cfrCtx h, long flags) {
+    unsigned short axisCount = 0;
+
+    if (h->ctx.t2c == NULL)
+        return;
+
+    if (h->header.major != 1 && !(flags & CFR_SHALLOW_READ))
+        axisCount = h->cff2.axisCount;
+
+    if (!(flags & CFR_SAME_SOURCE) ||
+        h->cached.origin != h->src.origin ||
+        h->cached.axisCount != axisCount ||
+        memcmp(h->cached.ndv, h->cff2.ndv, axisCount * sizeof(Fixed)) != 0)
+        t2cCacheReset(h->ctx.t2c);
+
+    h->cached.origin = h->src.origin;
+    h->cached.axisCount = axisCount;
+    memcpy(h->cached.ndv, h->cff2.ndv, axisCount * sizeof(Fixed));
+}
+
 /* ------------------------------- Interface ------------------------------- */
 
 /* Report absfont error message to debug stream. */
@@ -2763,6 +2812,8 @@ int cfrBegFont(cfrCtx h, long flags, long origin, int ttcIndex, abfTopDict **top
         }
     }
 
+    updateGlyphCache(h, flags);
+
     /* Read string INDEX  */
     if (h->header.major == 1) {
         h->region.StringINDEX.begin = h->region.TopDICTINDEX.end;
@@ -2917,7 +2968,7 @@ static void readGlyph(cfrCtx h,
     /* Parse charstring */
     info->blendInfo.vsindex = aux->default_vsIndex;
     info->blendInfo.maxstack = CFF2_MAX_OP_STACK;
-    result = t2cParse(info->sup.begin, info->sup.end, aux, gid, cff2_cb, glyph_cb, &h->cb.mem);
+    result = t2cParseCached(h->ctx.t2c, info->sup.begin, info->sup.end, aux, gid, cff2_cb, glyph_cb, &h->cb.mem);
     if (result) {
         if (info->flags & ABF_GLYPH_CID)
             message(h, "(t2c) %s <cid-%hu>", t2cErrStr(result), info->cid);
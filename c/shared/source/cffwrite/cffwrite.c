@@ -9,6 +9,7 @@
 #include "txops.h"
 #include "dictops.h"
 #include "supportexcept.h"
+#include "ctutil.h"
 
 #include "cffwrite_charset.h"
 #include "cffwrite_encoding.h"
@@ -108,6 +109,7 @@ typedef struct /* Per-font data */
     dnaDCL(FDInfo, FDArray);       /* FD array */
     dnaDCL(Glyph, glyphs);         /* Per-glyph data */
     dnaDCL(SeenGlyph, seenGlyphs); /* Per-glyph data */
+    dnaDCL(long, seenHash);        /* seenGlyphs index + 1, hashed by name/CID */
     dnaDCL(SeenDict, seenDicts);   /* Per-fontdict data */
 
     INDEX CharStrings; /* CharStrings INDEX data */
@@ -212,6 +214,7 @@ static void initFont(void *ctx, long cnt, cff_Font *font) {
         font->FDArray.func = initFDInfo;
         dnaINIT(g->ctx.dnaFail, font->glyphs, 256, 750);
         dnaINIT(g->ctx.dnaFail, font->seenGlyphs, 256, 256);
+        dnaINIT(g->ctx.dnaFail, font->seenHash, 512, 512);
         dnaINIT(g->ctx.dnaFail, font->seenDicts, 2, 2);
         font++;
     }
@@ -257,6 +260,7 @@ static void cfwControlFree(cfwCtx g) {
         dnaFREE(font->FDArray);
         dnaFREE(font->glyphs);
         dnaFREE(font->seenGlyphs);
+        dnaFREE(font->seenHash);
         dnaFREE(font->seenDicts);
     }
     dnaFREE(h->FontSet);
@@ -310,24 +314,74 @@ static void tmp2bufCopy(cfwCtx g, long length, long offset, char *ptr) {
     g->tmp.next += length;
 }
 
-/* Match glyph name. */
-static int CTL_CDECL matchSeenName(const void *key, const void *value, void *ctx) {
-    char *compStr = ((SeenGlyph *)value)->info.gname.ptr;
+/* The glyphs already added to a merged font are found through an
+   open-addressed hash of seenGlyphs indexes, keyed by glyph name or CID. Its
+   size is a power of 2 at least twice the number of seen glyphs. */
 
-    return strcmp((char *)key,
-                  compStr);
+/* Hash glyph name or CID. */
+static unsigned long hashSeenGlyph(abfGlyphInfo *info) {
+    return (info->flags & ABF_GLYPH_CID) ? ctuHashCID(info->cid)
+                                         : ctuHashName(info->gname.ptr);
 }
 
-/* Match glyph CID. */
-static int CTL_CDECL matchSeenCID(const void *key, const void *value, void *ctx) {
-    long match;
-    match = *(unsigned short *)key - ((SeenGlyph *)value)->info.cid;
+/* Return 1 if seen glyph has the same name or CID as glyph. */
+static int matchSeenGlyph(SeenGlyph *seen, abfGlyphInfo *info) {
+    if (info->flags & ABF_GLYPH_CID)
+        return (seen->info.flags & ABF_GLYPH_CID) && seen->info.cid == info->cid;
+    else
+        return !(seen->info.flags & ABF_GLYPH_CID) &&
+               strcmp(seen->info.gname.ptr, info->gname.ptr) == 0;
+}
 
-    if (match == 0) {
-        return match;
-    } else {
-        return (match > 0) ? 1 : -1;
+/* Return seenGlyphs index of glyph, or -1 if not yet seen. */
+static long findSeenGlyph(controlCtx h, abfGlyphInfo *info) {
+    long mask = h->_new->seenHash.cnt - 1;
+    long i;
+
+    if (h->_new->seenHash.cnt == 0)
+        return -1;
+
+    for (i = hashSeenGlyph(info) & mask;
+         h->_new->seenHash.array[i] != 0;
+         i = (i + 1) & mask) {
+        long seenIndex = h->_new->seenHash.array[i] - 1;
+        if (matchSeenGlyph(&h->_new->seenGlyphs.array[seenIndex], info))
+            return seenIndex;
     }
+    return -1;
+}
+
+/* Insert seenGlyphs index in hash. */
+static void insertSeenGlyph(controlCtx h, long seenIndex) {
+    long mask = h->_new->seenHash.cnt - 1;
+    long i = hashSeenGlyph(&h->_new->seenGlyphs.array[seenIndex].info) & mask;
+
+    while (h->_new->seenHash.array[i] != 0)
+        i = (i + 1) & mask;
+    h->_new->seenHash.array[i] = seenIndex + 1;
+}
+
+/* Add last seen glyph to hash, growing and rehashing it as needed. Return 1
+   on allocation failure. */
+static int hashSeenGlyphIndex(cfwCtx g) {
+    controlCtx h = g->ctx.control;
+    long size = h->_new->seenHash.cnt;
+
+    if (h->_new->seenGlyphs.cnt * 2 > size) {
+        long i;
+
+        if (size == 0)
+            size = 512;
+        while (h->_new->seenGlyphs.cnt * 2 > size)
+            size *= 2;
+        if (dnaSetCnt(&h->_new->seenHash, sizeof(long), size) == -1)
+            return 1;
+        memset(h->_new->seenHash.array, 0, size * sizeof(long));
+        for (i = 0; i < h->_new->seenGlyphs.cnt; i++)
+            insertSeenGlyph(h, i);
+    } else
+        insertSeenGlyph(h, h->_new->seenGlyphs.cnt - 1);
+    return 0;
 }
 
 /* Match font FD dict FontName. */
@@ -362,26 +416,17 @@ static int CTL_CDECL matchFontName(const void *srcName, const void *value, void
     0                         glyph not yet seen
     cfwErrGlyphPresent,       "identical charstring is already present"
     cfwErrGlyphDiffers,       "different charstring of same name is already present"
-   and returns the index of the glyph in the sorted array of glyph names in the CFF. If not
-   yet in the font, the index is one greater than the index of the glyph which sorts before the new name.
+   and returns the index of the glyph in the array of seen glyphs, or -1 if it
+   is not yet in the font.
 
  */
 long cfwSeenGlyph(cfwCtx g, abfGlyphInfo *info, int *result, long startNew, long endNew) {
     controlCtx h = g->ctx.control;
-    long seenIndex = 0;
-    int nameFound;
+    long seenIndex = findSeenGlyph(h, info);
 
     *result = 0;
 
-    if (info->flags & ABF_GLYPH_CID) {
-        nameFound = ctuLookup(&info->cid, h->_new->seenGlyphs.array, h->_new->seenGlyphs.cnt,
-                              sizeof(h->_new->seenGlyphs.array[0]), matchSeenCID, (size_t *)&seenIndex, h);
-    } else {
-        nameFound = ctuLookup(info->gname.ptr, h->_new->seenGlyphs.array, h->_new->seenGlyphs.cnt,
-                              sizeof(h->_new->seenGlyphs.array[0]), matchSeenName, (size_t *)&seenIndex, h);
-    }
-
-    if (nameFound) {
+    if (seenIndex >= 0) {
         int noMatch = 0;
         long lenNewStr = endNew - startNew;
         long glyphIndex = h->_new->seenGlyphs.array[seenIndex].glyphsIndex;
@@ -538,7 +583,7 @@ int cfwCompareFDArrays(cfwCtx g, abfTopDict *srcTop) {
 
 /* Add new glyph. */
 void cfwAddGlyph(cfwCtx g,
-                 abfGlyphInfo *info, float hAdv, long length, long offset, long seen_index) {
+                 abfGlyphInfo *info, float hAdv, long length, long offset) {
     controlCtx h = g->ctx.control;
     Glyph *glyph = NULL;
     SeenGlyph *seenGlyph = NULL;
@@ -588,33 +633,29 @@ void cfwAddGlyph(cfwCtx g,
        update the seenGlyphs list. */
 
     /* We get to here only if the new glyph does NOT have the same name as a
-       glyph which has already been seen. It is therefore added to the list.
-       'seen_index' gives the index of the new name in the alphabetic list of
-       glyph names. */
+       glyph which has already been seen. It is therefore added to the list,
+       and to the hash used to find it. */
 
     /* For CID glyphs, we also need to check if the FD is new to the dest font,
        and if so add it, and we need to fix the glyph->iFD value. This is
        currently an index into the  source font FD array */
     if (g->flags & CFW_CHECK_IF_GLYPHS_DIFFER) {
-        int needHole = seen_index < h->_new->seenGlyphs.cnt;
+        long seenIndex = dnaNext(&h->_new->seenGlyphs, sizeof(SeenGlyph));
 
         /* grow array, increment seenGlyphs.cnt */
-        if (dnaNext(&h->_new->seenGlyphs, sizeof(SeenGlyph)) == -1) {
+        if (seenIndex == -1) {
             g->err.code = cfwErrNoMemory;
             return;
         }
 
-        /* ptr to insertion-point index */
-        seenGlyph = &h->_new->seenGlyphs.array[seen_index];
-
-        /* Move higher elements (if there are any) up one index to make hole. */
-        if (needHole) {
-            memmove(seenGlyph + 1, seenGlyph,
-                    ((h->_new->seenGlyphs.cnt - 1) - seen_index) * sizeof(SeenGlyph));
-        }
-
+        seenGlyph = &h->_new->seenGlyphs.array[seenIndex];
         seenGlyph->glyphsIndex = index;
         seenGlyph->info = *info;  // I can't save a ptr to the info, as the original array of abfGlyphInfo moves when resized.
+
+        if (hashSeenGlyphIndex(g)) {
+            g->err.code = cfwErrNoMemory;
+            return;
+        }
     }
 
     if (info->flags & ABF_GLYPH_UNICODE) {
@@ -1472,7 +1513,12 @@ int cfwBegFont(cfwCtx g, cfwMapCallback *map, unsigned long maxNumSubrs) {
     h->_new->glyphs.array[0].info = NULL;
 
     /* For h->_new->seenGlyphs, we do NOT need to pre-allocate for .notdef
-       as we are not forcing it to the beginning of the list */
+       as we are not forcing it to the beginning of the list. The FontSet slot
+       may be reused from a previous font set, so the seen glyphs, which index
+       its glyphs array, are emptied like that array. The hash holds seenGlyphs
+       indexes, so it is emptied with them. */
+    h->_new->seenGlyphs.cnt = 0;
+    h->_new->seenHash.cnt = 0;
 
     h->flags &= ~(SEEN_NAME_KEYED_GLYPH | SEEN_CID_KEYED_GLYPH);
     h->mergedDicts = 0;
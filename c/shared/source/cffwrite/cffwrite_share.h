@@ -66,7 +66,7 @@ int cfwEncReal(float r, unsigned char *t);
 long cfwSeenGlyph(cfwCtx g, abfGlyphInfo *info, int *result,
                   long startNew, long endNew);
 void cfwAddGlyph(cfwCtx g, abfGlyphInfo *info, float hAdv, long length,
-                 long offset, long seen_index);
+                 long offset);
 
 /* -------------------------------- Contexts -------------------------------
 
@@ -2534,11 +2534,10 @@ static void glyphEnd(abfGlyphCallbacks *cb) {
 
     {
         /* Check if new glyph is same as old, if merging fonts */
-        long seen_index = 0;
         int errorCode = 0;
         if (g->flags & CFW_CHECK_IF_GLYPHS_DIFFER) {
             /* check and see if glyph has been already seen */
-            seen_index = cfwSeenGlyph(g, h->glyph.info, &errorCode, cstroff, h->tmpoff);
+            (void)cfwSeenGlyph(g, h->glyph.info, &errorCode, cstroff, h->tmpoff);
             if (errorCode) {
                 /* set the cfwCtx error code.*/
                 g->err.code |= errorCode;
@@ -2554,7 +2553,7 @@ static void glyphEnd(abfGlyphCallbacks *cb) {
             }
         }
         if (errorCode == 0) {
-            cfwAddGlyph(g, h->glyph.info, h->glyph.hAdv, h->tmpoff - cstroff, cstroff, seen_index);
+            cfwAddGlyph(g, h->glyph.info, h->glyph.hAdv, h->tmpoff - cstroff, cstroff);
         }
     }
 
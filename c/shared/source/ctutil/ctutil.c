@@ -12,8 +12,23 @@
 #include <stdio.h>
 #include <math.h>
 #include <stdint.h>
+#include <errno.h>
 #include "ctutil.h"
 
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define HAVE_FORK 1
+#endif
+
+/* SSE2 is part of the x86-64 baseline */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
 /* Exchange 2 values of size "s" pointed to by "a" and "b". */
 #define MAX_BUF 256
 #define EXCH(a, b, s)                              \
@@ -272,6 +287,358 @@ void ctuDtostr(char *buf, size_t bufLen, double value, int width, int precision)
     }
 }
 
+/* Type 1 encryption constants */
+#define CRYPT_MULT 52845u
+#define CRYPT_ADD  22719u
+
+/* Decrypt Type 1 eexec or charstring data. Decryption of a byte depends on
+   the previous state and cipher byte only:
+
+       r[i + 1] = (c[i] + r[i]) * MULT + ADD = r[i] * MULT + d[i]
+
+   where d[i] = c[i] * MULT + ADD. As the cipher bytes are known in advance
+   the state n bytes ahead is r[i] * MULT^n plus a sum of d terms that don't
+   depend on r, which breaks the byte-to-byte dependency chain and lets
+   several bytes be decrypted at once. All arithmetic is modulo 2^16. */
+unsigned short ctuDecrypt(unsigned short r, size_t length,
+                          const char *cipher, char *plain) {
+    const unsigned char *c = (const unsigned char *)cipher;
+    unsigned char *p = (unsigned char *)plain;
+    unsigned int s = r;
+#if HAVE_SSE2
+    if (length >= 8) {
+        /* Decrypt 8 bytes per iteration in 16-bit lanes */
+        const unsigned int K2 = CRYPT_MULT * CRYPT_MULT;
+        const unsigned int K4 = K2 * K2;
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i mult = _mm_set1_epi16((short)CRYPT_MULT);
+        const __m128i add = _mm_set1_epi16((short)CRYPT_ADD);
+        const __m128i mult2 = _mm_set1_epi16((short)K2);
+        const __m128i mult4 = _mm_set1_epi16((short)K4);
+        const __m128i powers = _mm_setr_epi16(
+            1, (short)CRYPT_MULT, (short)K2, (short)(K2 * CRYPT_MULT),
+            (short)K4, (short)(K4 * CRYPT_MULT), (short)(K4 * K2),
+            (short)(K4 * K2 * CRYPT_MULT));
+        do {
+            __m128i cw = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)c), zero);
+            __m128i sum;
+            __m128i state;
+
+            /* Prefix sums of d terms: sum[i] = d[0] * MULT^i + ... + d[i] */
+            sum = _mm_add_epi16(_mm_mullo_epi16(cw, mult), add);
+            sum = _mm_add_epi16(sum, _mm_mullo_epi16(_mm_slli_si128(sum, 2), mult));
+            sum = _mm_add_epi16(sum, _mm_mullo_epi16(_mm_slli_si128(sum, 4), mult2));
+            sum = _mm_add_epi16(sum, _mm_mullo_epi16(_mm_slli_si128(sum, 8), mult4));
+
+            /* state[i] = r * MULT^i + sum[i - 1] */
+            state = _mm_add_epi16(_mm_mullo_epi16(_mm_set1_epi16((short)s), powers),
+                                  _mm_slli_si128(sum, 2));
+            cw = _mm_xor_si128(cw, _mm_srli_epi16(state, 8));
+            _mm_storel_epi64((__m128i *)p, _mm_packus_epi16(cw, cw));
+
+            s = s * K4 * K4 + (unsigned int)_mm_extract_epi16(sum, 7);
+            c += 8;
+            p += 8;
+            length -= 8;
+        } while (length >= 8);
+    }
+#else
+    if (length >= 4) {
+        /* Decrypt 4 bytes per iteration */
+        const unsigned int K2 = CRYPT_MULT * CRYPT_MULT;
+        const unsigned int K4 = K2 * K2;
+        do {
+            unsigned int c0 = c[0], c1 = c[1], c2 = c[2], c3 = c[3];
+            unsigned int d0 = c0 * CRYPT_MULT + CRYPT_ADD;
+            unsigned int d1 = c1 * CRYPT_MULT + CRYPT_ADD;
+            unsigned int d2 = c2 * CRYPT_MULT + CRYPT_ADD;
+            unsigned int d3 = c3 * CRYPT_MULT + CRYPT_ADD;
+            unsigned int s1 = s * CRYPT_MULT + d0;
+            unsigned int s2 = s1 * CRYPT_MULT + d1;
+            unsigned int s3 = s2 * CRYPT_MULT + d2;
+            p[0] = (unsigned char)(c0 ^ ((s >> 8) & 0xff));
+            p[1] = (unsigned char)(c1 ^ ((s1 >> 8) & 0xff));
+            p[2] = (unsigned char)(c2 ^ ((s2 >> 8) & 0xff));
+            p[3] = (unsigned char)(c3 ^ ((s3 >> 8) & 0xff));
+            s = s * K4 + (((d0 * CRYPT_MULT + d1) * CRYPT_MULT + d2) * CRYPT_MULT + d3);
+            c += 4;
+            p += 4;
+            length -= 4;
+        } while (length >= 4);
+    }
+#endif
+    while (length--) {
+        unsigned int c1 = *c++;
+        *p++ = (unsigned char)(c1 ^ ((s >> 8) & 0xff));
+        s = (c1 + s) * CRYPT_MULT + CRYPT_ADD;
+    }
+    return (unsigned short)s;
+}
+
+/* Hash string (FNV-1a). */
+unsigned long ctuHashName(const char *name) {
+    unsigned long hash = 2166136261UL;
+
+    while (*name != '\0') {
+        hash ^= (unsigned char)*name++;
+        hash = (hash * 16777619UL) & 0xffffffffUL;
+    }
+    return hash;
+}
+
+/* Hash CID (Knuth's multiplicative method). */
+unsigned long ctuHashCID(unsigned short cid) {
+    return ((cid * 2654435761UL) & 0xffffffffUL) >> 8;
+}
+
+/* Return elapsed wall clock time in seconds. */
+double ctuWallTime(void) {
+#ifndef _WIN32
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#else
+    return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+#if HAVE_FORK
+/* The jobs are shared out among forked worker processes. A worker takes the
+   next job from a counter shared with the other workers, and its stdout and
+   stderr output is captured in temporary files. The extent of each job's
+   output, and its result, are recorded in memory shared with the parent,
+   which copies the output of every job in order once the workers finish. A
+   worker that replaces a failed one appends to the failed worker's captures,
+   which it shares with the parent. */
+
+typedef struct { /* Job run by a worker */
+    int worker;  /* Index of worker that took the job; -1 if none */
+    int done;    /* Job completed */
+    int failed;  /* Job ended its worker */
+    long outEnd; /* End of job's output in worker's stdout capture */
+    long errEnd; /* End of job's output in worker's stderr capture */
+} Job;
+
+typedef struct { /* Worker process */
+    pid_t pid;   /* Process id; 0 if not running */
+    FILE *out;   /* Captured stdout */
+    FILE *err;   /* Captured stderr */
+    long outPos; /* Capture output copied so far */
+    long errPos;
+} Worker;
+
+typedef struct { /* Job pool shared with the workers */
+    long count;
+    long *next; /* Next job to take */
+    Job *jobs;
+    char *blocks; /* Result blocks */
+    size_t resultSize;
+    ctuJobFunc func;
+    void *ctx;
+} Pool;
+
+/* Start worker "iWorker". Return 0 on success, else -1 with errno set. */
+static int startWorker(Pool *pool, Worker *worker, int iWorker) {
+    long nn;
+
+    fflush(stdout);
+    fflush(stderr);
+    worker->pid = fork();
+    if (worker->pid < 0) {
+        worker->pid = 0;
+        return -1;
+    } else if (worker->pid > 0) {
+        return 0;
+    }
+
+    /* Worker; a job that fails exits the worker */
+    if (dup2(fileno(worker->out), fileno(stdout)) < 0 ||
+        dup2(fileno(worker->err), fileno(stderr)) < 0)
+        _exit(EXIT_FAILURE);
+    while ((nn = __atomic_fetch_add(pool->next, 1, __ATOMIC_SEQ_CST)) <
+           pool->count) {
+        Job *job = &pool->jobs[nn];
+
+        job->worker = iWorker;
+        pool->func(nn, pool->blocks + nn * pool->resultSize, pool->ctx);
+
+        fflush(stdout);
+        fflush(stderr);
+        job->outEnd = lseek(fileno(stdout), 0, SEEK_CUR);
+        job->errEnd = lseek(fileno(stderr), 0, SEEK_CUR);
+        job->done = 1;
+    }
+    _exit(EXIT_SUCCESS);
+}
+
+/* Record the job that worker "iWorker" was running when it ended, if any, as
+   failed. Its output ends where the worker's captures end. */
+static void failJob(Pool *pool, Worker *worker, int iWorker) {
+    long i;
+
+    for (i = 0; i < pool->count; i++) {
+        Job *job = &pool->jobs[i];
+        if (job->worker == iWorker && !job->done && !job->failed) {
+            job->failed = 1;
+            job->outEnd = lseek(fileno(worker->out), 0, SEEK_CUR);
+            job->errEnd = lseek(fileno(worker->err), 0, SEEK_CUR);
+            break;
+        }
+    }
+}
+
+/* Copy captured output from the current position up to "end" (or to the end
+   of the capture if negative) to console stream. */
+static void copyCapture(FILE *capture, long *pos, long end, FILE *console) {
+    char buf[BUFSIZ];
+
+    fseek(capture, *pos, SEEK_SET);
+    while (end < 0 || *pos < end) {
+        size_t n = sizeof(buf);
+        if (end >= 0 && (long)n > end - *pos)
+            n = end - *pos;
+        n = fread(buf, 1, n, capture);
+        if (n == 0)
+            break;
+        fwrite(buf, 1, n, console);
+        *pos += n;
+    }
+    fflush(console);
+}
+#endif /* HAVE_FORK */
+
+/* Run jobs in parallel worker processes. */
+long ctuRunJobs(long count, int workers, int flags, ctuJobFunc func,
+                size_t resultSize, void *results, void *ctx) {
+#if HAVE_FORK
+    Pool pool;
+    Worker *w;
+    size_t jobsSize = sizeof(long) + count * sizeof(Job);
+    size_t size;
+    long completed;
+    long i;
+    int nWorkers;
+    int running;
+
+    /* Results follow the job array, aligned for any type */
+    jobsSize = (jobsSize + 15) & ~(size_t)15;
+    size = jobsSize + count * resultSize;
+
+    w = (Worker *)malloc(workers * sizeof(Worker));
+    if (w == NULL)
+        return -1;
+
+    /* Allocate counter, job array, and results shared with the workers */
+    pool.next = (long *)mmap(NULL, size, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (pool.next == MAP_FAILED) {
+        free(w);
+        return -1;
+    }
+    pool.count = count;
+    pool.jobs = (Job *)(pool.next + 1);
+    pool.blocks = (char *)pool.next + jobsSize;
+    pool.resultSize = resultSize;
+    pool.func = func;
+    pool.ctx = ctx;
+    *pool.next = 0;
+    for (i = 0; i < count; i++) {
+        pool.jobs[i].worker = -1;
+        pool.jobs[i].done = 0;
+        pool.jobs[i].failed = 0;
+    }
+
+    for (nWorkers = 0; nWorkers < workers; nWorkers++) {
+        Worker *worker = &w[nWorkers];
+
+        worker->outPos = worker->errPos = 0;
+        worker->out = tmpfile();
+        worker->err = tmpfile();
+        if (worker->out == NULL || worker->err == NULL ||
+            startWorker(&pool, worker, nWorkers) != 0) {
+            /* Go on with the workers already started, if any */
+            int error = errno;
+            if (worker->out != NULL)
+                fclose(worker->out);
+            if (worker->err != NULL)
+                fclose(worker->err);
+            errno = error;
+            break;
+        }
+    }
+    if (nWorkers == 0) {
+        int error = errno;
+        munmap(pool.next, size);
+        free(w);
+        errno = error;
+        return -1;
+    }
+
+    /* Wait for workers, replacing failed ones if the remaining jobs are to be
+       run */
+    running = nWorkers;
+    while (running > 0) {
+        int status;
+        pid_t pid = wait(&status);
+
+        if (pid < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        for (i = 0; i < nWorkers; i++) {
+            Worker *worker = &w[i];
+            if (worker->pid != pid)
+                continue;
+            worker->pid = 0;
+            running--;
+            if (WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS)
+                break;
+            failJob(&pool, worker, (int)i);
+            if ((flags & CTU_JOBS_KEEP_GOING) && *pool.next < count &&
+                startWorker(&pool, worker, (int)i) == 0)
+                running++;
+            break;
+        }
+    }
+
+    /* Copy output and results in order, up to the first failed job unless
+       the remaining jobs were run */
+    for (completed = i = 0; i < count; i++) {
+        Job *job = &pool.jobs[i];
+        Worker *worker;
+
+        if (job->worker < 0)
+            break; /* All workers failed */
+        worker = &w[job->worker];
+        if (!job->done && !(flags & CTU_JOBS_KEEP_GOING)) {
+            /* Worker failed on this job */
+            copyCapture(worker->out, &worker->outPos, -1, stdout);
+            copyCapture(worker->err, &worker->errPos, -1, stderr);
+            break;
+        }
+        copyCapture(worker->out, &worker->outPos, job->outEnd, stdout);
+        copyCapture(worker->err, &worker->errPos, job->errEnd, stderr);
+        if (resultSize > 0 && (job->done || (flags & CTU_JOBS_KEEP_GOING)))
+            memcpy((char *)results + i * resultSize,
+                   pool.blocks + i * resultSize, resultSize);
+        if (job->done)
+            completed++;
+    }
+
+    for (i = 0; i < nWorkers; i++) {
+        fclose(w[i].out);
+        fclose(w[i].err);
+    }
+    munmap(pool.next, size);
+    free(w);
+    return completed;
+#else
+    errno = ENOSYS;
+    return -1;
+#endif /* HAVE_FORK */
+}
+
 /* Get version numbers of libraries. */
 void ctuGetVersion(ctlVersionCallbacks *cb) {
     if (cb->called & 1 << CTU_LIB_ID) {
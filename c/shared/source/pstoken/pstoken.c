@@ -78,6 +78,29 @@ static unsigned char digit[256] = {
     99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, /* f0-ff */
 };
 
+/* Index by ascii char and return hex digit value or XX_ if not a hex digit.
+   XX_ is chosen so that a pair of digits combined as (hi << 4 | lo) exceeds
+   0xff if either isn't a hex digit. */
+#define XX_ 0x100
+static unsigned short hexdigit[256] = {
+    XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, /* 00-0f */
+    XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, /* 10-1f */
+    XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, /* 20-2f */
+      0,   1,   2,   3,   4,   5,   6,   7,   8,   9, XX_, XX_, XX_, XX_, XX_, XX_, /* 30-3f */
+    XX_,  10,  11,  12,  13,  14,  15, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, /* 40-4f */
+    XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, /* 50-5f */
+    XX_,  10,  11,  12,  13,  14,  15, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, /* 60-6f */
+    XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, /* 70-7f */
+    XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, /* 80-8f */
+    XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, /* 90-9f */
+    XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, /* a0-af */
+    XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, /* b0-bf */
+    XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, /* c0-cf */
+    XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, /* d0-df */
+    XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, /* e0-ef */
+    XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, XX_, /* f0-ff */
+};
+
 #define IS_DIGIT(c)    (digit[(uint8_t)(c)] < 10)
 #define IS_HEX(c)      (digit[(uint8_t)(c)] < 16)
 #define IS_RADIX(c, b) (digit[(uint8_t)(c)] < (b))
@@ -179,8 +202,8 @@ int pstFree(pstCtx h) {
 /* Decrypt ASCII source buffer to plain buffer. Return 1 on error else 0. */
 static int ascii_decrypt(pstCtx h, size_t length, char *buf) {
     int hi_nib = h->cipher.hi_nib;
-    char *end = buf + length;
-    char *src = buf;
+    unsigned char *end = (unsigned char *)buf + length;
+    unsigned char *src = (unsigned char *)buf;
     char *dst;
 
     /* Set plain text buffer size */
@@ -190,36 +213,49 @@ static int ascii_decrypt(pstCtx h, size_t length, char *buf) {
         return 1;
     }
 
-    /* Decrypt and copy buffer */
+    /* Convert hex to binary cipher bytes */
     dst = h->plain.array;
-    do {
-        int nib = digit[(uint8_t)(*src++)];
+    while (src < end) {
+        int nib;
+
+        /* Convert digit pairs; lines of eexec data are mostly these */
+        if (hi_nib == -1)
+            while (end - src >= 2) {
+                unsigned int byte = hexdigit[src[0]] << 4 | hexdigit[src[1]];
+                if (byte > 0xff)
+                    break;
+                *dst++ = (char)byte;
+                src += 2;
+            }
+        if (src == end)
+            break;
+
+        /* Handle whitespace and digits split by whitespace or buffers */
+        nib = digit[*src++];
         if (nib > 15)
             continue;
         else if (hi_nib == -1)
             hi_nib = nib;
         else {
-            unsigned char cipher = hi_nib << 4 | nib;
-            *dst++ = cipher ^ (h->cipher.r >> 8);
-            h->cipher.r = (cipher + h->cipher.r) * 52845 + 22719;
+            *dst++ = (char)(hi_nib << 4 | nib);
             hi_nib = -1;
         }
-    } while (src < end);
+    }
 
     /* Save possible odd nibble that's split across buffers */
     h->cipher.hi_nib = hi_nib;
 
     /* 64-bit warning fixed by cast here */
     h->plain.cnt = (long)(dst - h->plain.array);
+
+    /* Decrypt cipher bytes in place */
+    h->cipher.r = ctuDecrypt(h->cipher.r, h->plain.cnt,
+                             h->plain.array, h->plain.array);
     return 0;
 }
 
 /* Decrypt binary source buffer to plain buffer. Return 1 on error else 0. */
 static int binary_decrypt(pstCtx h, size_t length, char *buf) {
-    size_t i;
-    char *src = buf;
-    char *dst;
-
     /* Set plain text buffer size */
     /* 64-bit warning fixed by cast here */
     if (dnaSetCnt(&h->plain, 1, (long)length)) {
@@ -228,12 +264,7 @@ static int binary_decrypt(pstCtx h, size_t length, char *buf) {
     }
 
     /* Decrypt cipher buffer */
-    dst = h->plain.array;
-    for (i = 0; i < length; i++) {
-        unsigned char cipher = *src++;
-        *dst++ = cipher ^ (h->cipher.r >> 8);
-        h->cipher.r = (cipher + h->cipher.r) * 52845 + 22719;
-    }
+    h->cipher.r = ctuDecrypt(h->cipher.r, length, buf, h->plain.array);
 
     return 0;
 }
@@ -44,6 +44,7 @@ typedef struct /* Table data */
     long flags;               /* Status flags */
 #define DONT_WRITE   (1 << 0) /* Don't write this table */
 #define USE_CHECKSUM (1 << 1) /* Use the client-supplied table checksum */
+#define SUMMED       (1 << 2) /* Checksum accumulated while writing */
 } Table;
 
 struct sfwCtx_ {
@@ -57,6 +58,15 @@ struct sfwCtx_ {
         char *next; /* Next byte available in input buffer */
         long left;  /* Number of bytes available in input buffer */
     } dst;
+    struct /* Table checksum accumulator */
+    {
+        ctlStreamCallbacks cb; /* Checksumming stream passed to write_table() */
+        unsigned long value;   /* Sum of complete longs */
+        unsigned long partial; /* Bytes of incomplete long */
+        int phase;             /* Number of bytes in partial */
+        long count;            /* Bytes summed */
+        int seeked;            /* Flags stream seeked during table write */
+    } sum;
     struct /* Client callbacks */
     {
         ctlMemoryCallbacks mem;
@@ -95,6 +105,131 @@ static void dna_init(sfwCtx h) {
     h->dna = dnaNew(&cb, DNA_CHECK_ARGS);
 }
 
+/* -------------------------- Checksumming Stream -------------------------- */
+
+/* The stream callbacks passed to the write_table() callbacks are a copy of the
+   client's callbacks that accumulate the table checksum as the data is written
+   so that the tables needn't be read back. A table whose data didn't all pass
+   through this stream, or which seeked while writing, is read back instead. */
+
+/* Reset checksum accumulator. */
+static void sumReset(sfwCtx h) {
+    h->sum.value = 0;
+    h->sum.partial = 0;
+    h->sum.phase = 0;
+    h->sum.count = 0;
+    h->sum.seeked = 0;
+}
+
+/* Add data to checksum. */
+static void sumAdd(sfwCtx h, size_t count, const unsigned char *p) {
+    const unsigned char *end = p + count;
+    unsigned long sum = h->sum.value;
+
+    h->sum.count += (long)count;
+
+    /* Complete partial long */
+    if (h->sum.phase != 0) {
+        while (p < end && h->sum.phase < 4) {
+            h->sum.partial = h->sum.partial << 8 | *p++;
+            h->sum.phase++;
+        }
+        if (h->sum.phase < 4)
+            return;
+        sum += h->sum.partial;
+        h->sum.partial = 0;
+        h->sum.phase = 0;
+    }
+
+    /* Sum whole longs */
+    for (; end - p >= 4; p += 4)
+        sum += ((unsigned long)p[0] << 24 | (unsigned long)p[1] << 16 |
+                (unsigned long)p[2] << 8 | (unsigned long)p[3]);
+    h->sum.value = sum;
+
+    /* Save remaining bytes */
+    while (p < end) {
+        h->sum.partial = h->sum.partial << 8 | *p++;
+        h->sum.phase++;
+    }
+}
+
+/* Return checksum of table data padded to 4-byte boundary. */
+static unsigned long sumEnd(sfwCtx h) {
+    if (h->sum.phase == 0)
+        return h->sum.value;
+    return (h->sum.value +
+            ((h->sum.partial << 8 * (4 - h->sum.phase)) & 0xffffffffUL));
+}
+
+/* Open stream. */
+static void *sum_open(ctlStreamCallbacks *cb, int id, size_t size) {
+    sfwCtx h = cb->indirect_ctx;
+    return h->cb.stm.open(&h->cb.stm, id, size);
+}
+
+/* Seek on stream. */
+static int sum_seek(ctlStreamCallbacks *cb, void *stream, long offset) {
+    sfwCtx h = cb->indirect_ctx;
+    if (stream == h->dst.stm)
+        h->sum.seeked = 1;
+    return h->cb.stm.seek(&h->cb.stm, stream, offset);
+}
+
+/* Return stream position. */
+static long sum_tell(ctlStreamCallbacks *cb, void *stream) {
+    sfwCtx h = cb->indirect_ctx;
+    return h->cb.stm.tell(&h->cb.stm, stream);
+}
+
+/* Read stream. */
+static size_t sum_read(ctlStreamCallbacks *cb, void *stream, char **ptr) {
+    sfwCtx h = cb->indirect_ctx;
+    return h->cb.stm.read(&h->cb.stm, stream, ptr);
+}
+
+/* Write stream, accumulating destination stream checksum. */
+static size_t sum_write(ctlStreamCallbacks *cb, void *stream,
+                        size_t count, char *ptr) {
+    sfwCtx h = cb->indirect_ctx;
+    size_t n = h->cb.stm.write(&h->cb.stm, stream, count, ptr);
+    if (stream == h->dst.stm)
+        sumAdd(h, n, (unsigned char *)ptr);
+    return n;
+}
+
+/* Return stream status. */
+static int sum_status(ctlStreamCallbacks *cb, void *stream) {
+    sfwCtx h = cb->indirect_ctx;
+    return h->cb.stm.status(&h->cb.stm, stream);
+}
+
+/* Close stream. */
+static int sum_close(ctlStreamCallbacks *cb, void *stream) {
+    sfwCtx h = cb->indirect_ctx;
+    return h->cb.stm.close(&h->cb.stm, stream);
+}
+
+/* Initialize checksumming stream callbacks. */
+static void sumInit(sfwCtx h) {
+    h->sum.cb = h->cb.stm; /* Copy client stream callbacks */
+
+    /* Patch client callbacks, leaving optional ones unset if not provided */
+    h->sum.cb.indirect_ctx = h; /* Provide sfntwrite context */
+    h->sum.cb.seek = sum_seek;
+    h->sum.cb.tell = sum_tell;
+    h->sum.cb.write = sum_write;
+    h->sum.cb.xml_read = NULL;
+    if (h->cb.stm.open != NULL)
+        h->sum.cb.open = sum_open;
+    if (h->cb.stm.read != NULL)
+        h->sum.cb.read = sum_read;
+    if (h->cb.stm.status != NULL)
+        h->sum.cb.status = sum_status;
+    if (h->cb.stm.close != NULL)
+        h->sum.cb.close = sum_close;
+}
+
 /* --------------------------- Context Management -------------------------- */
 
 /* Validate client and create context. */
@@ -120,6 +255,7 @@ sfwCtx sfwNew(ctlMemoryCallbacks *mem_cb, ctlStreamCallbacks *stm_cb,
     /* Copy callbacks */
     h->cb.mem = *mem_cb;
     h->cb.stm = *stm_cb;
+    sumInit(h);
 
     /* Set error handler */
     DURING_EX(h->err.env)
@@ -404,12 +540,18 @@ static int writeTables(sfwCtx h, long origin) {
             Entry *entry = dnaNEXT(h->hdr.directory);
             int use_checksum = 0;
 
-            if (cb->write_table(cb, &h->cb.stm, h->dst.stm,
+            sumReset(h);
+            if (cb->write_table(cb, &h->sum.cb, h->dst.stm,
                                 &use_checksum, &entry->checksum))
                 return 1;
+            after = dstTell(h);
             if (use_checksum)
                 table->flags |= USE_CHECKSUM;
-            after = dstTell(h);
+            else if (!h->sum.seeked && h->sum.count == after - before) {
+                /* All table data seen by checksumming stream */
+                entry->checksum = sumEnd(h);
+                table->flags |= SUMMED;
+            }
 
             /* Pad to 4-byte boundary */
             pad = (4 - (after & 3)) & 3;
@@ -469,7 +611,6 @@ int sfwWriteTables(sfwCtx h, void *stm, ctlTag sfnt_tag) {
     long i;
     long origin;
     long offset;
-    long dirSize = HDR_SIZE + ENTRY_SIZE * h->hdr.numTables;
     char *filler = "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0";
 
     if (h->state != 3)
@@ -500,7 +641,7 @@ int sfwWriteTables(sfwCtx h, void *stm, ctlTag sfnt_tag) {
     if (writeTables(h, origin))
         return sfwErrAbort;
 
-    /* Read tables and compute table checksums */
+    /* Read back tables whose checksums weren't computed while writing */
     do_seek = 1;
     offset = 0;
     entry = h->hdr.directory.array;
@@ -509,7 +650,11 @@ int sfwWriteTables(sfwCtx h, void *stm, ctlTag sfnt_tag) {
         if (!(table->flags & DONT_WRITE)) {
             if (table->flags & USE_CHECKSUM)
                 do_seek = 1;
-            else {
+            else if (table->flags & SUMMED) {
+                if (entry->tag == CTL_TAG('h', 'e', 'a', 'd'))
+                    offset = entry->offset + HEAD_ADJUST_OFFSET;
+                do_seek = 1;
+            } else {
                 long j;
                 int nLongs = (entry->length + 3) / 4;
 
@@ -538,16 +683,17 @@ int sfwWriteTables(sfwCtx h, void *stm, ctlTag sfnt_tag) {
     writeHdr(h);
 
     if (offset != 0) {
-        /* head table present; read header and compute header checksum */
-        dstSeek(h, origin);
-        h->dst.left = 0;
-        sum = 0;
-        for (i = 0; i < dirSize; i += 4)
-            sum += read4(h);
-
-        /* Add in table checksums */
-        for (i = 0; i < h->hdr.numTables; i++)
-            sum += h->hdr.directory.array[i].checksum;
+        /* head table present; compute header checksum from the values just
+           written and add in table checksums */
+        sum = h->hdr.version;
+        sum += (unsigned long)h->hdr.numTables << 16 | h->hdr.searchRange;
+        sum += (unsigned long)h->hdr.entrySelector << 16 | h->hdr.rangeShift;
+        for (i = 0; i < h->hdr.numTables; i++) {
+            entry = &h->hdr.directory.array[i];
+            sum += entry->tag + entry->checksum * 2 + entry->offset +
+                   entry->length;
+        }
+        sum &= 0xffffffffUL;
 
         /* Write head table checksum adjustment */
         dstSeek(h, origin + offset);
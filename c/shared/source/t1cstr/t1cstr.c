@@ -1498,20 +1498,15 @@ int t1cDecrypt(int lenIV, long *length, char *cipher, char *plain) {
     else {
         /* Encrypted */
         unsigned char *c = (unsigned char *)cipher;
-        unsigned char *p = (unsigned char *)plain;
         unsigned short r = 4330; /* Initial state */
-        long cnt = *length -= lenIV;
+        *length -= lenIV;
 
         /* Prime state from random initial bytes */
         while (lenIV--)
             r = (*c++ + r) * 52845 + 22719;
 
         /* Decrypt and copy bytes */
-        while (cnt--) {
-            unsigned char c1 = *c++;
-            *p++ = c1 ^ (r >> 8);
-            r = (c1 + r) * 52845 + 22719;
-        }
+        ctuDecrypt(r, *length, (char *)c, plain);
     }
     return t1cSuccess;
 }
@@ -94,6 +94,14 @@ typedef struct /* Length delimited string for search match */
     char *value;
 } MatchStr;
 
+typedef struct /* Blended dict value */
+{
+    int iKey;     /* Key index */
+    pstType type; /* Value token type */
+    long offset;  /* Value text offset */
+    long length;  /* Value text length */
+} BlendValue;
+
 /* Module context */
 struct t1rCtx_ {
     long flags;                    /* Control flags */
@@ -106,6 +114,7 @@ struct t1rCtx_ {
 #define PRINT_STREAM   (1UL << 25) /* CoolType print steam font */
 #define CRLF_NEWLINES  (1UL << 24) /* Font uses CR/LF newlines */
 #define SEEN_NOTDEF    (1UL << 23) /* Seen .notdef glyph */
+#define MM_REPLAY      (1UL << 22) /* Replaying blended dict values */
     abfTopDict top;                /* Top dict */
     FDInfo *fd;                    /* Active FDArray element */
     dnaDCL(FDInfo, FDArray);       /* FDArray */
@@ -161,6 +170,14 @@ struct t1rCtx_ {
         } BDM;
         float *UDV; /* From client */
         float ForceBoldThreshold;
+        int kepler;                  /* Custom Kepler NDV */
+        int jenson;                  /* Custom Jenson CDV */
+        dnaDCL(BlendValue, values);  /* Blended dict values in parse order */
+        dnaDCL(char, text);          /* Blended dict value text */
+        pstToken *replay;            /* Next token when replaying a value */
+        long FontName;               /* Master FontName string index */
+        long XUIDcnt;                /* Master XUID count */
+        dnaDCL(long, gnames);        /* Glyph name string indexes */
     } mm;
     pstCtx pst; /* pstoken lib context */
     dnaCtx dna; /* dynarr lib context */
@@ -532,6 +549,9 @@ t1rCtx t1rNew(ctlMemoryCallbacks *mem_cb, ctlStreamCallbacks *stm_cb,
     newChars(h);
     newStrings(h);
     dnaINIT(h->dna, h->tmp, 250, 750);
+    dnaINIT(h->dna, h->mm.values, 20, 50);
+    dnaINIT(h->dna, h->mm.text, 1000, 2000);
+    dnaINIT(h->dna, h->mm.gnames, 256, 1000);
 
     /* Initialize pstoken library */
     h->pst = pstNew(mem_cb, stm_cb, T1R_SRC_STREAM_ID, PST_CHECK_ARGS);
@@ -572,6 +592,9 @@ void t1rFree(t1rCtx h) {
     freeChars(h);
     freeStrings(h);
     dnaFREE(h->tmp);
+    dnaFREE(h->mm.values);
+    dnaFREE(h->mm.text);
+    dnaFREE(h->mm.gnames);
 
     dnaFree(h->dna);
     pstFree(h->pst);
@@ -600,7 +623,14 @@ static void pstFatal(t1rCtx h, int err_code) {
 
 /* Get next PostScript token and store in context. Return token pointer. */
 static pstToken *getToken(t1rCtx h) {
-    int result = pstGetToken(h->pst, &h->token);
+    int result;
+    if (h->mm.replay != NULL) {
+        /* Replaying blended dict value; return saved token */
+        h->token = *h->mm.replay;
+        h->mm.replay = NULL;
+        return &h->token;
+    }
+    result = pstGetToken(h->pst, &h->token);
     if (result)
         pstFatal(h, result);
     return &h->token;
@@ -1394,7 +1424,7 @@ static void stdCDV(t1rCtx h, int nAxes, int nMasters) {
     }
 
     /* Check every master represented */
-    memset(check, 0, nMasters);
+    memset(check, 0, sizeof(check));
     for (i = 0; i < nMasters; i++)
         check[(int)order[i]] = 1;
     for (i = 0; i < nMasters; i++)
@@ -1453,6 +1483,24 @@ static void calcUDVFromWV(t1rCtx h, int nAxes, int nMasters) {
     }
 }
 
+/* Compute NDV and WV from client UDV. */
+static void mmSetWV(t1rCtx h, int nAxes, int nMasters) {
+    /* Copy UDV */
+    memcpy(h->fd->aux.UDV, h->mm.UDV, nAxes * sizeof(h->mm.UDV[0]));
+
+    /* Compute NDV */
+    if (h->mm.kepler)
+        keplerNDV(h);
+    else
+        stdNDV(h, nAxes);
+
+    /* Compute WV */
+    if (h->mm.jenson)
+        jensonCDV(h);
+    else
+        stdCDV(h, nAxes, nMasters);
+}
+
 /* Initialize MM font. */
 static void mmInit(t1rCtx h) {
     static char *jenson[] =
@@ -1482,15 +1530,15 @@ static void mmInit(t1rCtx h) {
     char *FontName = getString(h, (STI)h->fd->fdict->FontName.impl);
     if (FontName == NULL)
         fatal(h, t1rErrFontName, NULL);
-    int isJenson = bsearch(FontName, jenson, ARRAY_LEN(jenson),
-                           sizeof(jenson[0]), matchFontName) != NULL;
-    int isKepler = bsearch(FontName, kepler, ARRAY_LEN(kepler),
-                           sizeof(kepler[0]), matchFontName) != NULL;
 
     if (h->flags & MM_FONT)
         return; /* Already done */
 
     h->flags |= MM_FONT;
+    h->mm.jenson = bsearch(FontName, jenson, ARRAY_LEN(jenson),
+                           sizeof(jenson[0]), matchFontName) != NULL;
+    h->mm.kepler = bsearch(FontName, kepler, ARRAY_LEN(kepler),
+                           sizeof(kepler[0]), matchFontName) != NULL;
 
     /* Check for required keys */
     if (!h->key.seen[kBlendDesignPositions])
@@ -1513,7 +1561,7 @@ static void mmInit(t1rCtx h) {
 
     if (h->mm.UDV == NULL) {
         /* Not specified by client; use default */
-        if (isKepler) {
+        if (h->mm.kepler) {
             h->fd->aux.UDV[0] = 385;
             h->fd->aux.UDV[1] = 575;
             h->fd->aux.UDV[2] = 10;
@@ -1522,20 +1570,7 @@ static void mmInit(t1rCtx h) {
         return;
     }
 
-    /* Copy UDV */
-    memcpy(h->fd->aux.UDV, h->mm.UDV, nAxes * sizeof(h->mm.UDV[0]));
-
-    /* Compute NDV */
-    if (isKepler)
-        keplerNDV(h);
-    else
-        stdNDV(h, nAxes);
-
-    /* Compute WV */
-    if (isJenson)
-        jensonCDV(h);
-    else
-        stdCDV(h, nAxes, nMasters);
+    mmSetWV(h, nAxes, nMasters);
 }
 
 /* Fix up multiple master snapshot. */
@@ -1655,6 +1690,25 @@ static STI parseName(t1rCtx h, int kKey) {
     return 0; /* Suppress compiler warning */
 }
 
+/* Save text of blended value in current token so that it may be blended
+   again at another instance by t1rSetInstance(). */
+static void saveBlendValue(t1rCtx h, int kKey) {
+    BlendValue *value;
+    char *text;
+
+    if (!(h->flags & MM_FONT) || h->flags & MM_REPLAY)
+        return;
+
+    value = dnaNEXT(h->mm.values);
+    value->iKey = kKey;
+    value->type = h->token.type;
+    value->offset = h->mm.text.cnt;
+    value->length = h->token.length;
+    text = dnaEXTEND(h->mm.text, h->token.length + 1);
+    memcpy(text, h->token.value, h->token.length);
+    text[h->token.length] = '\0';
+}
+
 /* Parse blend array and blend elements. */
 static double parseBlend(t1rCtx h, int kKey, char **str) {
     double value;
@@ -1709,6 +1763,7 @@ static long parseInt(t1rCtx h, int kKey) {
             return pstConvInteger(h->pst, token);
         case pstArray:
         case pstProcedure:
+            saveBlendValue(h, kKey);
             p = copyArrayToken(h, token);
             return (long)RND(parseBlend(h, kKey, &p));
         default:
@@ -1727,8 +1782,11 @@ static float parseNum(t1rCtx h, int kKey, int round) {
             return (float)pstConvReal(h->pst, token);
         case pstArray:
         case pstProcedure: {
-            char *p = copyArrayToken(h, token);
-            double value = parseBlend(h, kKey, &p);
+            char *p;
+            double value;
+            saveBlendValue(h, kKey);
+            p = copyArrayToken(h, token);
+            value = parseBlend(h, kKey, &p);
             return round ? RND(value) : value;
         }
         default:
@@ -1743,6 +1801,7 @@ static int parseNumArray(t1rCtx h, int kKey,
                          int blend, int report_empty) {
     int i;
     char *p;
+    int saved = 0;
     pstToken *token = getToken(h);
 
     if (token->type != pstArray && token->type != pstProcedure)
@@ -1766,6 +1825,10 @@ static int parseNumArray(t1rCtx h, int kKey,
             case '[':
             case '{':
                 if (blend) {
+                    if (!saved) {
+                        saveBlendValue(h, kKey);
+                        saved = 1;
+                    }
                     if (i < max) {
                         double value = parseBlend(h, kKey, &p);
                         if (kKey == kFontBBox) {
@@ -1873,6 +1936,8 @@ static long parseBool(t1rCtx h, int kKey) {
             char *p = token->value + 1;
             float value = 0;
 
+            saveBlendValue(h, kKey);
+
             /* Skip initial whitespace */
             while (isspace(*p))
                 p++;
@@ -2943,25 +3008,10 @@ static void report_error(abfErrCallbacks *cb, int err_code, int iFD) {
         message(h, "%s FD[%d] (ignored)", abfErrStr(err_code), iFD);
 }
 
-/* Prepare font data for client. */
-static void prepClientData(t1rCtx h) {
+/* Add string pointers to top dict, font dicts, and glyphs. */
+static void addStrPtrs(t1rCtx h) {
     long i;
 
-    if (h->flags & SYN_FONT) {
-        /* Synthetic font; save base FontName */
-        h->top.SynBaseFontName = h->fd->fdict->FontName;
-
-        /* Restore synthetic font values */
-        h->fd->fdict->FontName = h->synthetic.FontName;
-        h->top.FullName = h->synthetic.FullName;
-        h->top.ItalicAngle = h->synthetic.ItalicAngle;
-        h->top.UniqueID = h->synthetic.UniqueID;
-        h->fd->fdict->FontMatrix = h->synthetic.FontMatrix;
-        h->top.sup.flags |= ABF_SYN_FONT;
-    }
-    if (h->flags & MM_FONT)
-        prepMMData(h);
-
     /* Add strings to top dict */
     addStrPtr(h, &h->top.version);
     addStrPtr(h, &h->top.Notice);
@@ -2982,6 +3032,44 @@ static void prepClientData(t1rCtx h) {
         addStrPtr(h, &font->FontName);
     }
 
+    if (h->flags & CID_FONT)
+        return;
+
+    /* Add strings to glyphs */
+    for (i = 0; i < h->chars.index.cnt; i++)
+        addStrPtr(h, &h->chars.index.array[i].gname);
+}
+
+/* Prepare font data for client. */
+static void prepClientData(t1rCtx h) {
+    long i;
+
+    if (h->flags & SYN_FONT) {
+        /* Synthetic font; save base FontName */
+        h->top.SynBaseFontName = h->fd->fdict->FontName;
+
+        /* Restore synthetic font values */
+        h->fd->fdict->FontName = h->synthetic.FontName;
+        h->top.FullName = h->synthetic.FullName;
+        h->top.ItalicAngle = h->synthetic.ItalicAngle;
+        h->top.UniqueID = h->synthetic.UniqueID;
+        h->fd->fdict->FontMatrix = h->synthetic.FontMatrix;
+        h->top.sup.flags |= ABF_SYN_FONT;
+    }
+    if (h->flags & MM_FONT) {
+        /* Save master values that are changed for the instance */
+        h->mm.FontName = h->fd->fdict->FontName.impl;
+        h->mm.XUIDcnt = h->top.XUID.cnt;
+        prepMMData(h);
+
+        /* Save glyph name string indexes, which clients may change */
+        dnaSET_CNT(h->mm.gnames, h->chars.index.cnt);
+        for (i = 0; i < h->chars.index.cnt; i++)
+            h->mm.gnames.array[i] = h->chars.index.array[i].gname.impl;
+    }
+
+    addStrPtrs(h);
+
     /* Prepare auxiliary data */
     for (i = 0; i < h->FDArray.cnt; i++) {
         FDInfo *fd = &h->FDArray.array[i];
@@ -3041,10 +3129,6 @@ static void prepClientData(t1rCtx h) {
     /* Name-keyed font; set source font type */
     h->top.sup.srcFontType = abfSrcFontTypeType1Name;
 
-    /* Add strings to glyphs */
-    for (i = 0; i < h->chars.index.cnt; i++)
-        addStrPtr(h, &h->chars.index.array[i].gname);
-
     /* Add glyph encodings */
     if (h->flags & STD_ENC) {
         /* Standard encoding */
@@ -3096,6 +3180,9 @@ int t1rBegFont(t1rCtx h, long flags, long origin, abfTopDict **top, float *UDV)
     h->mm.BDP.cnt = 0;
     h->mm.BDM.cnt = 0;
     h->mm.ForceBoldThreshold = 0.5;
+    h->mm.values.cnt = 0;
+    h->mm.text.cnt = 0;
+    h->mm.replay = NULL;
     tmpInit(h);
 
     /* Begin new parse */
@@ -3146,6 +3233,75 @@ int t1rBegFont(t1rCtx h, long flags, long origin, abfTopDict **top, float *UDV)
     return t1rSuccess;
 }
 
+/* Blend saved dict values again at the current instance. */
+static void replayBlendValues(t1rCtx h) {
+    long i;
+
+    h->flags |= MM_REPLAY;
+    for (i = 0; i < h->mm.values.cnt; i++) {
+        BlendValue *value = &h->mm.values.array[i];
+        char literal[64];
+        pstToken key;
+        pstToken token;
+
+        /* Make key literal */
+        literal[0] = '/';
+        strncpy(&literal[1], keys[value->iKey], sizeof(literal) - 2);
+        literal[sizeof(literal) - 1] = '\0';
+        key.type = pstLiteral;
+        key.length = (long)strlen(literal);
+        key.value = literal;
+
+        /* Make value token and parse key as though read from source */
+        token.type = value->type;
+        token.length = value->length;
+        token.value = &h->mm.text.array[value->offset];
+        h->mm.replay = &token;
+        doLiteral(h, &key);
+        h->mm.replay = NULL;
+    }
+    h->flags &= ~MM_REPLAY;
+}
+
+/* Change multiple master instance. */
+int t1rSetInstance(t1rCtx h, float *UDV, abfTopDict **top) {
+    long i;
+
+    if (!(h->flags & MM_FONT) || UDV == NULL)
+        return t1rErrNotMM;
+
+    /* Set error handler */
+    DURING_EX(h->err.env)
+
+    h->fd = &h->FDArray.array[0];
+
+    /* Restore master values */
+    h->fd->fdict->FontName.impl = h->mm.FontName;
+    h->top.XUID.cnt = h->mm.XUIDcnt;
+    for (i = 0; i < h->chars.index.cnt; i++)
+        h->chars.index.array[i].gname.impl = h->mm.gnames.array[i];
+
+    /* Compute WV and blend dict values for new instance */
+    h->mm.UDV = UDV;
+    mmSetWV(h, h->mm.BDP.cnt / h->mm.WV.cnt, h->mm.WV.cnt);
+    replayBlendValues(h);
+
+    /* The auxiliary charstring data made by prepClientData() doesn't depend
+       on the instance, except for the design and weight vectors that
+       mmSetWV() has just updated, so it isn't made again */
+    prepMMData(h);
+    addStrPtrs(h);
+    *top = &h->top;
+
+    HANDLER
+    h->mm.replay = NULL;
+    h->flags &= ~MM_REPLAY;
+    return Exception.Code;
+    END_HANDLER
+
+    return t1rSuccess;
+}
+
 /* End PostScript font parse. */
 int t1rEndFont(t1rCtx h) {
     int result = pstEndParse(h->pst);
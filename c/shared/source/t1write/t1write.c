@@ -40,7 +40,7 @@ typedef struct /* Map glyph name to its standard encoding */
 
 typedef struct /* Charstring data */
 {
-    long offset; /* Tmp stream offset */
+    long offset; /* Charstring store offset */
     size_t length;
 } Cstr;
 
@@ -75,6 +75,7 @@ struct t1wCtx_ {
 #define IN_FLEX               (1 << 7)
     abfTopDict *top;       /* Top Dict data */
     dnaDCL(Glyph, glyphs); /* Glyph data */
+    long maxCID;           /* Maximum CID seen */
     long CIDCount;         /* Computed CIDCount for font */
     struct                 /* Client-specified data */
     {
@@ -83,14 +84,7 @@ struct t1wCtx_ {
         long maxglyphs;
         char *newline;
     } arg;
-    struct /* Temporary stream */
-    {
-        long offset;   /* Buffer offset */
-        size_t length; /* Buffer length */
-        char *buf;     /* Buffer beginning */
-        char *end;     /* Buffer end */
-        char *next;    /* Next byte available (buf <= next < end) */
-    } tmp;
+    dnaDCL(char, store); /* Encrypted charstring store */
     struct /* glyph metrics */
     {
         struct abfMetricsCtx_ ctx;
@@ -110,8 +104,9 @@ struct t1wCtx_ {
     } dst;
     struct /* eexec encryption */
     {
-        unsigned short r; /* Encryption state */
-        size_t cnt;       /* Number of chars in last line */
+        unsigned short r;    /* Encryption state */
+        size_t cnt;          /* Number of chars in last line */
+        dnaDCL(char, lines); /* Hexadecimal output lines */
     } eexec;
     dnaDCL(char, cstr);  /* Charstring buffer */
     dnaDCL(Stem, cntrs); /* Counter list */
@@ -143,7 +138,6 @@ struct t1wCtx_ {
     struct /* Streams */
     {
         void *dst;
-        void *tmp;
         void *dbg;
     } stm;
     struct /* Client callbacks */
@@ -181,23 +175,48 @@ static void writeDst(t1wCtx h, size_t count, char *ptr) {
         fatal(h, t1wErrDstStream);
 }
 
-/* Hex encrypt buffer and write to dst stream. */
-static void hexEncrypt(t1wCtx h, size_t cnt, unsigned char *p, int newline) {
-    char buf[HEX_LINE_LENGTH + 2 /* Newline */];
-    char *q = buf;
+/* Encrypt "cnt" bytes from "src" to "dst" starting with state "r" and return
+   the state following the last byte. "src" and "dst" may be the same. */
+static unsigned short encrypt(unsigned short r, size_t cnt,
+                              const unsigned char *src, unsigned char *dst) {
     while (cnt--) {
-        unsigned char c = *p++ ^ h->eexec.r >> 8;
-        h->eexec.r = (c + h->eexec.r) * 52845 + 22719;
-        *q++ = hexmap[c >> 4 & 0xf];
-        *q++ = hexmap[c & 0xf];
+        unsigned char c = *src++ ^ (r >> 8);
+        r = (c + r) * 52845 + 22719;
+        *dst++ = c;
     }
-    if (newline) {
+    return r;
+}
+
+/* Hex encrypt "cnt" bytes to "q" breaking lines every "left" bytes, and return
+   the end of the encoded data. */
+static char *hexEncrypt(t1wCtx h, size_t left, size_t cnt,
+                        const unsigned char *p, char *q) {
+    unsigned short r = h->eexec.r;
+    const char *nl;
+    size_t n;
+    for (;;) {
+        const unsigned char *end;
+        n = (left < cnt) ? left : cnt;
+        end = p + n;
+        while (p < end) {
+            unsigned char c = *p++ ^ (r >> 8);
+            r = (c + r) * 52845 + 22719;
+            *q++ = hexmap[c >> 4];
+            *q++ = hexmap[c & 0xf];
+        }
+        cnt -= n;
+        if (n < left)
+            break;
+
         /* Add newline */
-        for (p = (unsigned char *)h->arg.newline; *p != '\0'; p++)
-            *q++ = *p;
+        for (nl = h->arg.newline; *nl != '\0'; nl++)
+            *q++ = *nl;
         h->eexec.cnt = 0;
+        left = HEX_LINE_BYTES;
     }
-    writeDst(h, q - buf, buf);
+    h->eexec.r = r;
+    h->eexec.cnt += n * 2;
+    return q;
 }
 
 /* Flush dst stream buffer. */
@@ -211,29 +230,23 @@ static void flushBuf(t1wCtx h) {
         unsigned char *p = (unsigned char *)h->dst.buf;
         if (h->arg.flags & T1W_ENCODE_BINARY) {
             /* Binary eexec; encrypt in-place */
-            while (cnt--) {
-                unsigned char c = *p ^ h->eexec.r >> 8;
-                h->eexec.r = (c + h->eexec.r) * 52845 + 22719;
-                *p++ = c;
-            }
-            writeDst(h, h->dst.cnt, h->dst.buf);
+            h->eexec.r = encrypt(h->eexec.r, cnt, p, p);
+            writeDst(h, cnt, h->dst.buf);
         } else {
-            /* Hexadecimal eexec */
+            /* Hexadecimal eexec; encode whole buffer and write once */
             size_t left;
+            char *end;
+            if (dnaSetCnt(&h->eexec.lines, 1,
+                          cnt * 2 + (cnt / HEX_LINE_BYTES + 1) *
+                                        strlen(h->arg.newline)) == -1)
+                fatal(h, t1wErrNoMemory);
             if (h->flags & EEXEC_BEGIN) {
                 left = (HEX_LINE_LENGTH - (sizeof(ENTER_EEXEC) - 1)) / 2;
                 h->flags &= ~EEXEC_BEGIN;
             } else
                 left = (HEX_LINE_LENGTH - h->eexec.cnt) / 2;
-            while (left <= cnt) {
-                hexEncrypt(h, left, p, 1);
-                p += left;
-                cnt -= left;
-                left = HEX_LINE_BYTES;
-            }
-            if (cnt > 0)
-                hexEncrypt(h, cnt, p, 0);
-            h->eexec.cnt += cnt * 2;
+            end = hexEncrypt(h, left, cnt, p, h->eexec.lines.array);
+            writeDst(h, end - h->eexec.lines.array, h->eexec.lines.array);
         }
     } else
         /* Write buffered bytes */
@@ -313,117 +326,55 @@ static void CTL_CDECL writeFmt(t1wCtx h, char *fmt, ...) {
 
 /* -------------------------- Charstring Handling -------------------------- */
 
-/* Fill buffer from tmp stream. */
-static void readTmp(t1wCtx h, long offset) {
-    h->tmp.offset = offset;
-    h->tmp.length = h->cb.stm.read(&h->cb.stm, h->stm.tmp, &h->tmp.buf);
-    if (h->tmp.length == 0)
-        fatal(h, t1wErrTmpStream);
-    h->tmp.next = h->tmp.buf;
-    h->tmp.end = h->tmp.buf + h->tmp.length;
-}
-
-/* Write data to tmp file. */
-static int writeTmp(t1wCtx h, long cnt, unsigned char *ptr) {
-    return h->cb.stm.write(&h->cb.stm, h->stm.tmp, cnt, (char *)ptr) !=
-           (size_t)cnt;
-}
-
-/* Encrypt charstring and write to tmp stream. */
+/* Encrypt charstring and append it to the charstring store. */
 static int saveCstr(t1wCtx h, abfGlyphInfo *info,
                     long length, unsigned char *data, Cstr *cstr) {
     /* Encrypted priming bytes */
     static const unsigned char primer[] = {0x1c, 0x60, 0xd8, 0xa8};
-    long i;
     unsigned char *p;
-    unsigned short r = 0; /* Suppress optimizer warning */
+    long index;
+    int fd = info != NULL && info->flags & ABF_GLYPH_CID &&
+             !(h->arg.flags & T1W_TYPE_HOST);
+    int nprime = (h->arg.lenIV > 0) ? h->arg.lenIV : 0;
 
     /* Remember charstring details */
-    cstr->offset = h->tmp.offset;
-    cstr->length = length;
+    cstr->offset = h->store.cnt;
+    cstr->length = fd + nprime + length;
+
+    /* Reserve space in store */
+    index = dnaExtend(&h->store, 1, cstr->length);
+    if (index == -1)
+        return 1;
+    p = (unsigned char *)&h->store.array[index];
 
-    if (info != NULL && info->flags & ABF_GLYPH_CID &&
-        !(h->arg.flags & T1W_TYPE_HOST)) {
+    if (fd)
         /* CID-keyed incremental download; write fd index */
-        unsigned char c = info->iFD;
-        if (writeTmp(h, 1, &c))
-            return 1;
-        cstr->length++;
-    }
+        *p++ = (unsigned char)info->iFD;
 
     /* Handle encryption type */
     switch (h->arg.lenIV) {
         case -1:
-            goto write_cstr;
+            memcpy(p, data, length);
+            break;
         case 0:
-            r = 4330;
+            (void)encrypt(4330, length, data, p);
             break;
         case 1:
-            if (writeTmp(h, 1, (unsigned char *)primer))
-                return 1;
-            r = 27725;
-            cstr->length += 1;
+            *p = primer[0];
+            (void)encrypt(27725, length, data, p + 1);
             break;
         case 4:
-            if (writeTmp(h, 4, (unsigned char *)primer))
-                return 1;
-            r = 17114;
-            cstr->length += 4;
+            memcpy(p, primer, 4);
+            (void)encrypt(17114, length, data, p + 4);
             break;
     }
 
-    /* Encrypt charstring in place */
-    p = data;
-    for (i = 0; i < length; i++) {
-        unsigned char c = *p ^ (r >> 8);
-        r = (c + r) * 52845 + 22719;
-        *p++ = c;
-    }
-
-    /* Write charstring */
-write_cstr:
-    if (writeTmp(h, length, data))
-        return 1;
-
-    h->tmp.offset += cstr->length;
-
     return 0;
 }
 
-/* Read charstring into dynamic charstring buffer. */
-static void readCstr(t1wCtx h, Cstr *cstr) {
-    long left;
-    long length;
-    char *p;
-    long delta = cstr->offset - h->tmp.offset;
-    if (delta >= 0 && (size_t)delta < h->tmp.length)
-        /* Offset within current buffer; reposition next byte */
-        h->tmp.next = h->tmp.buf + delta;
-    else {
-        /* Offset outside current buffer; seek to offset and fill buffer */
-        if (h->cb.stm.seek(&h->cb.stm, h->stm.tmp, cstr->offset))
-            fatal(h, t1wErrTmpStream);
-        readTmp(h, cstr->offset);
-    }
-
-    /* Fill buffer with charstring */
-    if (dnaSetCnt(&h->cstr, 1, cstr->length) == -1)
-        fatal(h, t1wErrNoMemory);
-    p = h->cstr.array;
-    length = cstr->length;
-    left = h->tmp.end - h->tmp.next;
-    while (left < length) {
-        /* Copy buffer */
-        memcpy(p, h->tmp.next, left);
-        p += left;
-        length -= left;
-
-        /* Refill buffer */
-        readTmp(h, h->tmp.offset + h->tmp.length);
-        left = h->tmp.length;
-    }
-    memcpy(p, h->tmp.next, length);
-    h->tmp.next += length;
+/* Return pointer to charstring in store. */
+static char *getCstr(t1wCtx h, Cstr *cstr) {
+    return &h->store.array[cstr->offset];
 }
 
 /* Hex encode line and write to dst stream. */
@@ -512,10 +463,8 @@ static void writeCstr(t1wCtx h, int col, Cstr *cstr, int put) {
     long length;
     char *p;
 
-    /* Read charstring from tmp stream */
-    readCstr(h, cstr);
-    length = h->cstr.cnt;
-    p = h->cstr.array;
+    length = cstr->length;
+    p = getCstr(h, cstr);
 
     if (h->arg.flags & (T1W_ENCODE_BINARY | T1W_TYPE_HOST)) {
         /* Write binary charstring */
@@ -570,7 +519,7 @@ static long saveSubr(t1wCtx h, size_t length, unsigned char *data) {
         fatal(h, t1wErrNoMemory);
     cstr = &h->subrs.array[index];
     if (saveCstr(h, NULL, length, data, cstr))
-        fatal(h, t1wErrTmpStream);
+        fatal(h, t1wErrNoMemory);
     h->size.subrs += cstr->length;
     return index;
 }
@@ -587,7 +536,7 @@ static void saveStdSubr(t1wCtx h, size_t length, const unsigned char *data) {
     (void)saveSubr(h, length, (unsigned char *)data);
 }
 
-/* Save standard subrs to tmp stream. */
+/* Save standard subrs to charstring store. */
 static void saveStdSubrs(t1wCtx h) {
     static const unsigned char subr0[] =
         /* 3 0 callother pop pop setcurrentpoint return */
@@ -1602,8 +1551,7 @@ static void writeStartData(t1wCtx h, unsigned char *FDMap, long StartDataSize,
 
     /* Write subr data */
     for (i = 0; i < h->subrs.cnt; i++) {
-        readCstr(h, &h->subrs.array[i]);
-        writeBuf(h, h->cstr.cnt, h->cstr.array);
+        writeBuf(h, h->subrs.array[i].length, getCstr(h, &h->subrs.array[i]));
     }
 
     if (h->arg.flags & T1W_TYPE_BASE)
@@ -1630,8 +1578,7 @@ static void writeStartData(t1wCtx h, unsigned char *FDMap, long StartDataSize,
 
     /* Write glyph data */
     for (i = 0; i < h->glyphs.cnt; i++) {
-        readCstr(h, &h->glyphs.array[i].cstr);
-        writeBuf(h, h->cstr.cnt, h->cstr.array);
+        writeBuf(h, h->glyphs.array[i].cstr.length, getCstr(h, &h->glyphs.array[i].cstr));
     }
 
     /* Write trailer */
@@ -1672,7 +1619,7 @@ static void writeHostCIDKeyedFont(t1wCtx h) {
     memset(FDMap, 0, sizeof(FDMap));
 
     if (host)
-        h->CIDCount++; /* Convert max CID to CIDCount */
+        h->CIDCount = h->maxCID + 1; /* Convert max CID to CIDCount */
     else
         h->CIDCount = top->cid.CIDCount; /* Set CIDCount from client */
 
@@ -1944,10 +1891,11 @@ t1wCtx t1wNew(ctlMemoryCallbacks *mem_cb, ctlStreamCallbacks *stm_cb,
     h->cntrs.size = 0;
     h->stems.size = 0;
     h->subrs.size = 0;
+    h->store.size = 0;
+    h->eexec.lines.size = 0;
     h->overflow.cnt = 0;
     h->dna = NULL;
     h->stm.dst = NULL;
-    h->stm.tmp = NULL;
     h->stm.dbg = NULL;
     h->err.code = t1wSuccess;
     h->cb.sing.get_stream = NULL;
@@ -1966,11 +1914,8 @@ t1wCtx t1wNew(ctlMemoryCallbacks *mem_cb, ctlStreamCallbacks *stm_cb,
     dnaINIT(h->dna, h->cntrs, 20, 80);
     dnaINIT(h->dna, h->stems, 20, 80);
     dnaINIT(h->dna, h->subrs, 5, 100);
-
-    /* Open tmp stream */
-    h->stm.tmp = h->cb.stm.open(&h->cb.stm, T1W_TMP_STREAM_ID, 0);
-    if (h->stm.tmp == NULL)
-        goto cleanup;
+    dnaINIT(h->dna, h->store, 50000, 500000);
+    dnaINIT(h->dna, h->eexec.lines, BUFSIZ * 2, BUFSIZ);
 
     /* Open debug stream */
     h->stm.dbg = h->cb.stm.open(&h->cb.stm, T1W_DBG_STREAM_ID, 0);
@@ -1988,10 +1933,6 @@ void t1wFree(t1wCtx h) {
     if (h == NULL)
         return;
 
-    /* Close tmp stream */
-    if (h->stm.tmp != NULL)
-        (void)h->cb.stm.close(&h->cb.stm, h->stm.tmp);
-
     /* Close debug stream */
     if (h->stm.dbg != NULL)
         (void)h->cb.stm.close(&h->cb.stm, h->stm.dbg);
@@ -2001,6 +1942,8 @@ void t1wFree(t1wCtx h) {
     dnaFREE(h->cntrs);
     dnaFREE(h->stems);
     dnaFREE(h->subrs);
+    dnaFREE(h->store);
+    dnaFREE(h->eexec.lines);
     dnaFree(h->dna);
 
     /* Free library context */
@@ -2071,6 +2014,7 @@ int t1wBegFont(t1wCtx h, long flags, int lenIV, long maxglyphs) {
         return t1wErrBadCall;
 
     /* Initialize */
+    h->maxCID = 0;
     h->CIDCount = 0;
     h->arg.flags = flags;
     h->arg.lenIV = lenIV;
@@ -2091,10 +2035,8 @@ int t1wBegFont(t1wCtx h, long flags, int lenIV, long maxglyphs) {
     h->font_bbox.right = INT16_MIN;
     h->font_bbox.top = INT16_MIN;
 
-    /* Reset tmp stream */
-    if (h->cb.stm.seek(&h->cb.stm, h->stm.tmp, 0))
-        return t1wErrTmpStream;
-    h->tmp.offset = 0;
+    /* Reset charstring store */
+    h->store.cnt = 0;
 
     /* Set error handler */
     DURING_EX(h->err.env)
@@ -2144,11 +2086,6 @@ int t1wEndFont(t1wCtx h, abfTopDict *top) {
 
     destFileOpened = 1;
 
-    /* Seek to start of tmp stream and fill buffer */
-    if (h->cb.stm.seek(&h->cb.stm, h->stm.tmp, 0))
-        fatal(h, t1wErrTmpStream);
-    readTmp(h, 0);
-
     /* if we only had empty glyphs, set bbox to zeros */
     zeroOutEmptyFontBBox(h);
 
@@ -2248,8 +2185,8 @@ static int glyphBeg(abfGlyphCallbacks *cb, abfGlyphInfo *info) {
     h->flags |= INIT_HINTS;
 
     if (info->flags & ABF_GLYPH_CID) {
-        if (h->CIDCount < info->cid)
-            h->CIDCount = info->cid;
+        if (h->maxCID < info->cid)
+            h->maxCID = info->cid;
         h->flags |= SEEN_CID_KEYED_GLYPH;
     } else {
         if (info->gname.ptr == NULL || info->gname.ptr[0] == '\0')
@@ -2919,7 +2856,7 @@ static void glyphEnd(abfGlyphCallbacks *cb) {
     /* Save charstring */
     if (saveCstr(h, glyph->info,
                  h->cstr.cnt, (unsigned char *)h->cstr.array, &glyph->cstr)) {
-        h->err.code = t1wErrTmpStream;
+        h->err.code = t1wErrNoMemory;
         return;
     }
 
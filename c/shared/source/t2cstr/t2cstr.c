@@ -21,6 +21,7 @@
 #include <math.h>
 #include <limits.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <errno.h>
 
 /* Make operator for internal use */
@@ -1857,6 +1858,587 @@ int t2cParse(long offset, long endOffset, t2cAuxData *aux, unsigned short gid, c
     return retVal;
 }
 
+/* ------------------------------ Glyph cache ------------------------------ */
+
+/* A cached glyph is stored as a flat stream of floats: an op code from the
+   enumeration below followed by the arguments of the glyph callback. Integer
+   arguments are exactly representable as floats. A blend argument is stored
+   as its value, hasBlend flag, count of blend values, and the blend values. */
+enum /* Recorded glyph callbacks */
+{
+    rec_width,   /* hAdv */
+    rec_move,    /* x0 y0 */
+    rec_line,    /* x1 y1 */
+    rec_curve,   /* x1 y1 x2 y2 x3 y3 */
+    rec_stem,    /* flags edge0 edge1 */
+    rec_flex,    /* depth x1 y1 ... x6 y6 */
+    rec_genop,   /* cnt op args... */
+    rec_seac,    /* adx ady bchar achar */
+    rec_moveVF,  /* x0 y0 (blend args) */
+    rec_lineVF,  /* x1 y1 (blend args) */
+    rec_curveVF, /* x1 y1 x2 y2 x3 y3 (blend args) */
+    rec_stemVF   /* flags edge0 edge1 (blend args) */
+};
+
+/* Parse flags that change the callbacks made for a glyph */
+#define CACHE_KEY_FLAGS \
+    (T2C_USE_MATRIX | T2C_UPDATE_OPS | T2C_IS_CFF2 | T2C_FLATTEN_BLEND)
+
+typedef struct CacheEntry_ CacheEntry;
+struct CacheEntry_ {
+    CacheEntry *prev;         /* More recently used entry */
+    CacheEntry *next;         /* Less recently used entry */
+    size_t size;              /* Allocated size of this entry */
+    long key;                 /* Parse flags and client callback mask */
+    long offset;              /* Charstring offset */
+    unsigned short gid;       /* Glyph ID */
+    unsigned short vsindex;   /* blendInfo after parse */
+    unsigned short numRegions;
+    unsigned char bchar;      /* Seac components after parse */
+    unsigned char achar;
+    long cnt;                 /* Number of elements in ops */
+    float ops[1];             /* Recorded callbacks (extends beyond struct) */
+};
+
+struct t2cGlyphCache_ {
+    ctlMemoryCallbacks *mem;
+    size_t maxBytes;
+    struct /* Entries indexed by glyph ID */
+    {
+        CacheEntry **array;
+        long size;
+    } glyphs;
+    CacheEntry *head; /* Most recently used entry */
+    CacheEntry *tail; /* Least recently used entry */
+    struct /* Recording in progress */
+    {
+        float *array;
+        long cnt;
+        long size;
+        int failed;
+    } rec;
+    abfGlyphCallbacks recorder;   /* Records and forwards to client */
+    abfGlyphCallbacks *client;    /* Client callbacks during recording */
+    float genopArgs[CFF2_MAX_OP_STACK];
+    abfBlendArg blendArgs[6];     /* Replayed blend args */
+    t2cCacheStats stats;
+};
+
+/* Reserve n elements in recording. Return NULL if recording was abandoned. */
+static float *recReserve(t2cGlyphCache cache, long n) {
+    float *p;
+
+    if (cache->rec.failed)
+        return NULL;
+
+    if ((size_t)(cache->rec.cnt + n) * sizeof(float) > cache->maxBytes) {
+        /* Glyph can never fit in cache; don't record it */
+        cache->rec.failed = 1;
+        return NULL;
+    }
+
+    if (cache->rec.cnt + n > cache->rec.size) {
+        long size = cache->rec.size * 2 + n;
+        float *array = cache->mem->manage(cache->mem, cache->rec.array,
+                                          size * sizeof(float));
+        if (array == NULL) {
+            cache->rec.failed = 1;
+            return NULL;
+        }
+        cache->rec.array = array;
+        cache->rec.size = size;
+    }
+
+    p = &cache->rec.array[cache->rec.cnt];
+    cache->rec.cnt += n;
+    return p;
+}
+
+/* Record op code and n float args. */
+static void recFloats(t2cGlyphCache cache, int op, int n, float *args) {
+    float *p = recReserve(cache, 1 + n);
+    if (p != NULL) {
+        *p++ = (float)op;
+        memcpy(p, args, n * sizeof(float));
+    }
+}
+
+/* Record blend arg. */
+static void recBlendArg(t2cGlyphCache cache, abfBlendArg *arg) {
+    int n = arg->hasBlend ? cache->client->info->blendInfo.numRegions : 0;
+    float *p = recReserve(cache, 3 + n);
+    if (p != NULL) {
+        p[0] = arg->value;
+        p[1] = (float)arg->hasBlend;
+        p[2] = (float)n;
+        memcpy(&p[3], arg->blendValues, n * sizeof(float));
+    }
+}
+
+/* Record op code and n blend args. */
+static void recBlendArgs(t2cGlyphCache cache, int op, int n, abfBlendArg **args) {
+    float *p = recReserve(cache, 1);
+    int i;
+    if (p != NULL)
+        *p = (float)op;
+    for (i = 0; i < n; i++)
+        recBlendArg(cache, args[i]);
+}
+
+static void recWidth(abfGlyphCallbacks *cb, float hAdv) {
+    t2cGlyphCache cache = cb->direct_ctx;
+    recFloats(cache, rec_width, 1, &hAdv);
+    cache->client->width(cache->client, hAdv);
+}
+
+static void recMove(abfGlyphCallbacks *cb, float x0, float y0) {
+    t2cGlyphCache cache = cb->direct_ctx;
+    float args[2];
+    args[0] = x0;
+    args[1] = y0;
+    recFloats(cache, rec_move, 2, args);
+    cache->client->move(cache->client, x0, y0);
+}
+
+static void recLine(abfGlyphCallbacks *cb, float x1, float y1) {
+    t2cGlyphCache cache = cb->direct_ctx;
+    float args[2];
+    args[0] = x1;
+    args[1] = y1;
+    recFloats(cache, rec_line, 2, args);
+    cache->client->line(cache->client, x1, y1);
+}
+
+static void recCurve(abfGlyphCallbacks *cb,
+                     float x1, float y1,
+                     float x2, float y2,
+                     float x3, float y3) {
+    t2cGlyphCache cache = cb->direct_ctx;
+    float args[6];
+    args[0] = x1;
+    args[1] = y1;
+    args[2] = x2;
+    args[3] = y2;
+    args[4] = x3;
+    args[5] = y3;
+    recFloats(cache, rec_curve, 6, args);
+    cache->client->curve(cache->client, x1, y1, x2, y2, x3, y3);
+}
+
+static void recStem(abfGlyphCallbacks *cb,
+                    int flags, float edge0, float edge1) {
+    t2cGlyphCache cache = cb->direct_ctx;
+    float args[3];
+    args[0] = (float)flags;
+    args[1] = edge0;
+    args[2] = edge1;
+    recFloats(cache, rec_stem, 3, args);
+    cache->client->stem(cache->client, flags, edge0, edge1);
+}
+
+static void recFlex(abfGlyphCallbacks *cb, float depth,
+                    float x1, float y1,
+                    float x2, float y2,
+                    float x3, float y3,
+                    float x4, float y4,
+                    float x5, float y5,
+                    float x6, float y6) {
+    t2cGlyphCache cache = cb->direct_ctx;
+    float args[13];
+    args[0] = depth;
+    args[1] = x1;
+    args[2] = y1;
+    args[3] = x2;
+    args[4] = y2;
+    args[5] = x3;
+    args[6] = y3;
+    args[7] = x4;
+    args[8] = y4;
+    args[9] = x5;
+    args[10] = y5;
+    args[11] = x6;
+    args[12] = y6;
+    recFloats(cache, rec_flex, 13, args);
+    cache->client->flex(cache->client, depth,
+                        x1, y1, x2, y2, x3, y3, x4, y4, x5, y5, x6, y6);
+}
+
+static void recGenop(abfGlyphCallbacks *cb, int cnt, float *args, int op) {
+    t2cGlyphCache cache = cb->direct_ctx;
+    float *p = recReserve(cache, 3 + cnt);
+    if (p != NULL) {
+        p[0] = (float)rec_genop;
+        p[1] = (float)cnt;
+        p[2] = (float)op;
+        memcpy(&p[3], args, cnt * sizeof(float));
+    }
+    cache->client->genop(cache->client, cnt, args, op);
+}
+
+static void recSeac(abfGlyphCallbacks *cb,
+                    float adx, float ady, int bchar, int achar) {
+    t2cGlyphCache cache = cb->direct_ctx;
+    float args[4];
+    args[0] = adx;
+    args[1] = ady;
+    args[2] = (float)bchar;
+    args[3] = (float)achar;
+    recFloats(cache, rec_seac, 4, args);
+    cache->client->seac(cache->client, adx, ady, bchar, achar);
+}
+
+static void recMoveVF(abfGlyphCallbacks *cb, abfBlendArg *x0, abfBlendArg *y0) {
+    t2cGlyphCache cache = cb->direct_ctx;
+    abfBlendArg *args[2];
+    args[0] = x0;
+    args[1] = y0;
+    recBlendArgs(cache, rec_moveVF, 2, args);
+    cache->client->moveVF(cache->client, x0, y0);
+}
+
+static void recLineVF(abfGlyphCallbacks *cb, abfBlendArg *x1, abfBlendArg *y1) {
+    t2cGlyphCache cache = cb->direct_ctx;
+    abfBlendArg *args[2];
+    args[0] = x1;
+    args[1] = y1;
+    recBlendArgs(cache, rec_lineVF, 2, args);
+    cache->client->lineVF(cache->client, x1, y1);
+}
+
+static void recCurveVF(abfGlyphCallbacks *cb,
+                       abfBlendArg *x1, abfBlendArg *y1,
+                       abfBlendArg *x2, abfBlendArg *y2,
+                       abfBlendArg *x3, abfBlendArg *y3) {
+    t2cGlyphCache cache = cb->direct_ctx;
+    abfBlendArg *args[6];
+    args[0] = x1;
+    args[1] = y1;
+    args[2] = x2;
+    args[3] = y2;
+    args[4] = x3;
+    args[5] = y3;
+    recBlendArgs(cache, rec_curveVF, 6, args);
+    cache->client->curveVF(cache->client, x1, y1, x2, y2, x3, y3);
+}
+
+static void recStemVF(abfGlyphCallbacks *cb,
+                      int flags, abfBlendArg *edge0, abfBlendArg *edge1) {
+    t2cGlyphCache cache = cb->direct_ctx;
+    float *p = recReserve(cache, 2);
+    if (p != NULL) {
+        p[0] = (float)rec_stemVF;
+        p[1] = (float)flags;
+    }
+    recBlendArg(cache, edge0);
+    recBlendArg(cache, edge1);
+    cache->client->stemVF(cache->client, flags, edge0, edge1);
+}
+
+/* Return mask of non-NULL client callbacks. */
+static long clientMask(abfGlyphCallbacks *glyph) {
+    long mask = 0;
+    if (glyph->width != NULL)
+        mask |= 1 << 0;
+    if (glyph->move != NULL)
+        mask |= 1 << 1;
+    if (glyph->line != NULL)
+        mask |= 1 << 2;
+    if (glyph->curve != NULL)
+        mask |= 1 << 3;
+    if (glyph->stem != NULL)
+        mask |= 1 << 4;
+    if (glyph->flex != NULL)
+        mask |= 1 << 5;
+    if (glyph->genop != NULL)
+        mask |= 1 << 6;
+    if (glyph->seac != NULL)
+        mask |= 1 << 7;
+    if (glyph->moveVF != NULL)
+        mask |= 1 << 8;
+    if (glyph->lineVF != NULL)
+        mask |= 1 << 9;
+    if (glyph->curveVF != NULL)
+        mask |= 1 << 10;
+    if (glyph->stemVF != NULL)
+        mask |= 1 << 11;
+    return mask;
+}
+
+/* Initialize recorder callbacks with the same NULL pattern as the client's. */
+static void initRecorder(t2cGlyphCache cache, abfGlyphCallbacks *glyph) {
+    abfGlyphCallbacks *rec = &cache->recorder;
+
+    memset(rec, 0, sizeof(*rec));
+    rec->direct_ctx = cache;
+    rec->indirect_ctx = glyph->indirect_ctx;
+    rec->info = glyph->info;
+    rec->width = (glyph->width != NULL) ? recWidth : NULL;
+    rec->move = (glyph->move != NULL) ? recMove : NULL;
+    rec->line = (glyph->line != NULL) ? recLine : NULL;
+    rec->curve = (glyph->curve != NULL) ? recCurve : NULL;
+    rec->stem = (glyph->stem != NULL) ? recStem : NULL;
+    rec->flex = (glyph->flex != NULL) ? recFlex : NULL;
+    rec->genop = (glyph->genop != NULL) ? recGenop : NULL;
+    rec->seac = (glyph->seac != NULL) ? recSeac : NULL;
+    rec->moveVF = (glyph->moveVF != NULL) ? recMoveVF : NULL;
+    rec->lineVF = (glyph->lineVF != NULL) ? recLineVF : NULL;
+    rec->curveVF = (glyph->curveVF != NULL) ? recCurveVF : NULL;
+    rec->stemVF = (glyph->stemVF != NULL) ? recStemVF : NULL;
+
+    cache->client = glyph;
+    cache->rec.cnt = 0;
+    cache->rec.failed = 0;
+}
+
+/* Read recorded blend arg. */
+static float *readBlendArg(float *p, abfBlendArg *arg) {
+    int n = (int)p[2];
+    arg->value = p[0];
+    arg->hasBlend = (int)p[1];
+    memcpy(arg->blendValues, &p[3], n * sizeof(float));
+    return p + 3 + n;
+}
+
+/* Replay cached glyph to client. */
+static void replayGlyph(t2cGlyphCache cache, CacheEntry *entry,
+                        abfGlyphCallbacks *glyph, int widthOnly) {
+    float *p = entry->ops;
+    float *end = p + entry->cnt;
+    abfBlendArg *args = cache->blendArgs;
+    int i;
+
+    while (p < end)
+        switch ((int)*p++) {
+            case rec_width:
+                glyph->width(glyph, p[0]);
+                if (widthOnly)
+                    return;
+                p += 1;
+                break;
+            case rec_move:
+                glyph->move(glyph, p[0], p[1]);
+                p += 2;
+                break;
+            case rec_line:
+                glyph->line(glyph, p[0], p[1]);
+                p += 2;
+                break;
+            case rec_curve:
+                glyph->curve(glyph, p[0], p[1], p[2], p[3], p[4], p[5]);
+                p += 6;
+                break;
+            case rec_stem:
+                glyph->stem(glyph, (int)p[0], p[1], p[2]);
+                p += 3;
+                break;
+            case rec_flex:
+                glyph->flex(glyph, p[0],
+                            p[1], p[2], p[3], p[4], p[5], p[6],
+                            p[7], p[8], p[9], p[10], p[11], p[12]);
+                p += 13;
+                break;
+            case rec_genop: {
+                int cnt = (int)p[0];
+                int op = (int)p[1];
+                /* Pass a copy so the client can't modify the cache */
+                memcpy(cache->genopArgs, &p[2], cnt * sizeof(float));
+                glyph->genop(glyph, cnt, cache->genopArgs, op);
+                p += 2 + cnt;
+                break;
+            }
+            case rec_seac:
+                glyph->seac(glyph, p[0], p[1], (int)p[2], (int)p[3]);
+                p += 4;
+                break;
+            case rec_moveVF:
+                for (i = 0; i < 2; i++)
+                    p = readBlendArg(p, &args[i]);
+                glyph->moveVF(glyph, &args[0], &args[1]);
+                break;
+            case rec_lineVF:
+                for (i = 0; i < 2; i++)
+                    p = readBlendArg(p, &args[i]);
+                glyph->lineVF(glyph, &args[0], &args[1]);
+                break;
+            case rec_curveVF:
+                for (i = 0; i < 6; i++)
+                    p = readBlendArg(p, &args[i]);
+                glyph->curveVF(glyph, &args[0], &args[1], &args[2],
+                               &args[3], &args[4], &args[5]);
+                break;
+            case rec_stemVF: {
+                int flags = (int)*p++;
+                for (i = 0; i < 2; i++)
+                    p = readBlendArg(p, &args[i]);
+                glyph->stemVF(glyph, flags, &args[0], &args[1]);
+                break;
+            }
+        }
+}
+
+/* Unlink entry from LRU list. */
+static void unlinkEntry(t2cGlyphCache cache, CacheEntry *entry) {
+    if (entry->prev != NULL)
+        entry->prev->next = entry->next;
+    else
+        cache->head = entry->next;
+    if (entry->next != NULL)
+        entry->next->prev = entry->prev;
+    else
+        cache->tail = entry->prev;
+}
+
+/* Link entry at head of LRU list. */
+static void linkEntry(t2cGlyphCache cache, CacheEntry *entry) {
+    entry->prev = NULL;
+    entry->next = cache->head;
+    if (cache->head != NULL)
+        cache->head->prev = entry;
+    else
+        cache->tail = entry;
+    cache->head = entry;
+}
+
+/* Remove entry from cache and free it. */
+static void removeEntry(t2cGlyphCache cache, CacheEntry *entry) {
+    unlinkEntry(cache, entry);
+    cache->glyphs.array[entry->gid] = NULL;
+    cache->stats.bytes -= entry->size;
+    cache->stats.entries--;
+    cache->mem->manage(cache->mem, entry, 0);
+}
+
+/* Save completed recording as glyph's cache entry. */
+static void addEntry(t2cGlyphCache cache, unsigned short gid, long key,
+                     long offset, t2cAuxData *aux, abfGlyphInfo *info) {
+    size_t size = offsetof(CacheEntry, ops) + cache->rec.cnt * sizeof(float);
+    CacheEntry *entry;
+
+    if (size > cache->maxBytes)
+        return;
+
+    if (gid >= cache->glyphs.size) {
+        /* Grow glyph table */
+        long newSize = cache->glyphs.size * 2;
+        CacheEntry **array;
+        if (newSize <= gid)
+            newSize = gid + 256;
+        array = cache->mem->manage(cache->mem, cache->glyphs.array,
+                                   newSize * sizeof(CacheEntry *));
+        if (array == NULL)
+            return;
+        memset(&array[cache->glyphs.size], 0,
+               (newSize - cache->glyphs.size) * sizeof(CacheEntry *));
+        cache->glyphs.array = array;
+        cache->glyphs.size = newSize;
+    } else if (cache->glyphs.array[gid] != NULL) {
+        /* Replace stale entry */
+        removeEntry(cache, cache->glyphs.array[gid]);
+    }
+
+    /* Evict least recently used entries */
+    while (cache->stats.bytes + size > cache->maxBytes && cache->tail != NULL) {
+        removeEntry(cache, cache->tail);
+        cache->stats.evictions++;
+    }
+
+    entry = cache->mem->manage(cache->mem, NULL, size);
+    if (entry == NULL)
+        return;
+
+    entry->size = size;
+    entry->key = key;
+    entry->offset = offset;
+    entry->gid = gid;
+    entry->vsindex = info->blendInfo.vsindex;
+    entry->numRegions = info->blendInfo.numRegions;
+    entry->bchar = aux->bchar;
+    entry->achar = aux->achar;
+    entry->cnt = cache->rec.cnt;
+    memcpy(entry->ops, cache->rec.array, cache->rec.cnt * sizeof(float));
+
+    linkEntry(cache, entry);
+    cache->glyphs.array[gid] = entry;
+    cache->stats.bytes += size;
+    cache->stats.entries++;
+}
+
+/* Create new glyph cache. */
+t2cGlyphCache t2cCacheNew(ctlMemoryCallbacks *mem, size_t maxBytes) {
+    t2cGlyphCache cache = mem->manage(mem, NULL, sizeof(struct t2cGlyphCache_));
+    if (cache == NULL)
+        return NULL;
+    memset(cache, 0, sizeof(struct t2cGlyphCache_));
+    cache->mem = mem;
+    cache->maxBytes = maxBytes;
+    return cache;
+}
+
+/* Discard all cache entries. */
+void t2cCacheReset(t2cGlyphCache cache) {
+    while (cache->head != NULL)
+        removeEntry(cache, cache->head);
+}
+
+/* Free glyph cache. */
+void t2cCacheFree(t2cGlyphCache cache) {
+    if (cache == NULL)
+        return;
+    t2cCacheReset(cache);
+    cache->mem->manage(cache->mem, cache->glyphs.array, 0);
+    cache->mem->manage(cache->mem, cache->rec.array, 0);
+    cache->mem->manage(cache->mem, cache, 0);
+}
+
+/* Get cache counters. */
+void t2cCacheGetStats(t2cGlyphCache cache, t2cCacheStats *stats) {
+    *stats = cache->stats;
+}
+
+/* Parse Type 2 charstring, replaying it from the cache if possible. */
+int t2cParseCached(t2cGlyphCache cache, long offset, long endOffset, t2cAuxData *aux, unsigned short gid, cff2GlyphCallbacks *cff2, abfGlyphCallbacks *glyph, ctlMemoryCallbacks *mem) {
+    long key;
+    CacheEntry *entry;
+    int retVal;
+
+    if (cache == NULL)
+        return t2cParse(offset, endOffset, aux, gid, cff2, glyph, mem);
+
+    key = (aux->flags & CACHE_KEY_FLAGS) | clientMask(glyph) << 16;
+    entry = (gid < cache->glyphs.size) ? cache->glyphs.array[gid] : NULL;
+    if (entry != NULL && entry->key == key && entry->offset == offset) {
+        /* Hit; make most recently used and replay */
+        cache->stats.hits++;
+        unlinkEntry(cache, entry);
+        linkEntry(cache, entry);
+        if (aux->flags & T2C_WIDTH_ONLY) {
+            aux->bchar = 0;
+            aux->achar = 0;
+            replayGlyph(cache, entry, glyph, 1);
+        } else {
+            aux->bchar = entry->bchar;
+            aux->achar = entry->achar;
+            glyph->info->blendInfo.vsindex = entry->vsindex;
+            glyph->info->blendInfo.numRegions = entry->numRegions;
+            replayGlyph(cache, entry, glyph, 0);
+        }
+        return t2cSuccess;
+    }
+
+    cache->stats.misses++;
+    if (aux->flags & T2C_WIDTH_ONLY)
+        return t2cParse(offset, endOffset, aux, gid, cff2, glyph, mem);
+
+    /* Miss; parse via recorder and save recording if complete */
+    initRecorder(cache, glyph);
+    retVal = t2cParse(offset, endOffset, aux, gid, cff2, &cache->recorder, mem);
+    cache->client = NULL;
+    if (retVal == t2cSuccess && !cache->rec.failed)
+        addEntry(cache, gid, key, offset, aux, glyph->info);
+
+    return retVal;
+}
+
 /* Get version numbers of libraries. */
 void t2cGetVersion(ctlVersionCallbacks *cb) {
     if (cb->called & 1 << T2C_LIB_ID)
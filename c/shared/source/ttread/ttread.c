@@ -245,6 +245,9 @@ typedef struct /* glyf table */
     dnaDCL(ptRange, ranges);
     dnaDCL(glyfCoord, coords);
     long offset;
+    long locaOffset;    /* loca table offset (TTR_LAZY_LOAD) */
+    long hmtxOffset;    /* hmtx table offset (TTR_LAZY_LOAD) */
+    uFWord lastAdv;     /* Advance of glyphs past the long metrics (TTR_LAZY_LOAD) */
 } glyfTbl;
 
 typedef struct
@@ -351,8 +354,24 @@ typedef struct  /* gvar table */
 #define gvar_FLAG_32BIT_OFFSET  1
     uint16_t flags;
     uint32_t dataArrayOffset;
+    unsigned long dataOffsetsOffset; /* Offset of dataOffsets (TTR_LAZY_LOAD) */
     dnaDCL(uint32_t, dataOffsets);
     dnaDCL(Fixed, sharedTuples);
+    dnaDCL(Fixed, sharedScalars);   /* Shared tuple scalars at current instance */
+    struct                          /* Glyph delta buffers, reused across glyphs */
+    {
+        dnaDCL(int16_t, xIntDeltas);
+        dnaDCL(int16_t, yIntDeltas);
+        dnaDCL(Fixed, xDeltas);     /* Deltas of current tuple */
+        dnaDCL(Fixed, yDeltas);
+        dnaDCL(Fixed, xDeltaSums);  /* Sum of deltas over all tuples */
+        dnaDCL(Fixed, yDeltaSums);
+        dnaDCL(int16_t, xOrig);     /* Original outline for interpolation */
+        dnaDCL(int16_t, yOrig);
+        dnaDCL(boolean, hasDelta);
+        dnaDCL(uint16_t, sharedPoints);
+        dnaDCL(uint16_t, privatePoints);
+    } glyph;
 } gvarTbl;
 
 /* Glyph names for Standard Apple Glyph Ordering */
@@ -367,6 +386,7 @@ typedef struct /* Glyph data */
 {
     uint16_t flags;    /* Metrics */
 #define GLYPH_MTX_SET   (1<<0)  /* Metrics has been calculated */
+#define GLYPH_LOADED    (1<<1)  /* loca entry and metrics read (TTR_LAZY_LOAD) */
     uFWord hAdv;       /* Horizontal advance */
     FWord xMin;        /* Left of bounding box */
     FWord lsb;         /* Left side-bearing */
@@ -544,6 +564,18 @@ ttrCtx ttrNew(ctlMemoryCallbacks *mem_cb, ctlStreamCallbacks *stm_cb,
     h->gvar.dataArrayOffset = 0;
     h->gvar.dataOffsets.size = 0;
     h->gvar.sharedTuples.size = 0;
+    h->gvar.sharedScalars.size = 0;
+    h->gvar.glyph.xIntDeltas.size = 0;
+    h->gvar.glyph.yIntDeltas.size = 0;
+    h->gvar.glyph.xDeltas.size = 0;
+    h->gvar.glyph.yDeltas.size = 0;
+    h->gvar.glyph.xDeltaSums.size = 0;
+    h->gvar.glyph.yDeltaSums.size = 0;
+    h->gvar.glyph.xOrig.size = 0;
+    h->gvar.glyph.yOrig.size = 0;
+    h->gvar.glyph.hasDelta.size = 0;
+    h->gvar.glyph.sharedPoints.size = 0;
+    h->gvar.glyph.privatePoints.size = 0;
     h->tmp0.size = 0;
     h->tmp1.size = 0;
     h->stm.dbg = NULL;
@@ -583,6 +615,18 @@ ttrCtx ttrNew(ctlMemoryCallbacks *mem_cb, ctlStreamCallbacks *stm_cb,
     dnaINIT(h->ctx.dna, h->glyf.coords, 500, 1000);
     dnaINIT(h->ctx.dna, h->gvar.dataOffsets, 0, 500);
     dnaINIT(h->ctx.dna, h->gvar.sharedTuples, 0, 500);
+    dnaINIT(h->ctx.dna, h->gvar.sharedScalars, 0, 100);
+    dnaINIT(h->ctx.dna, h->gvar.glyph.xIntDeltas, 0, 500);
+    dnaINIT(h->ctx.dna, h->gvar.glyph.yIntDeltas, 0, 500);
+    dnaINIT(h->ctx.dna, h->gvar.glyph.xDeltas, 0, 500);
+    dnaINIT(h->ctx.dna, h->gvar.glyph.yDeltas, 0, 500);
+    dnaINIT(h->ctx.dna, h->gvar.glyph.xDeltaSums, 0, 500);
+    dnaINIT(h->ctx.dna, h->gvar.glyph.yDeltaSums, 0, 500);
+    dnaINIT(h->ctx.dna, h->gvar.glyph.xOrig, 0, 500);
+    dnaINIT(h->ctx.dna, h->gvar.glyph.yOrig, 0, 500);
+    dnaINIT(h->ctx.dna, h->gvar.glyph.hasDelta, 0, 500);
+    dnaINIT(h->ctx.dna, h->gvar.glyph.sharedPoints, 0, 500);
+    dnaINIT(h->ctx.dna, h->gvar.glyph.privatePoints, 0, 500);
     dnaINIT(h->ctx.dna, h->tmp0, 200, 500);
     dnaINIT(h->ctx.dna, h->tmp1, 200, 500);
 
@@ -623,6 +667,18 @@ void ttrFree(ttrCtx h) {
     dnaFREE(h->glyf.coords);
     dnaFREE(h->gvar.dataOffsets);
     dnaFREE(h->gvar.sharedTuples);
+    dnaFREE(h->gvar.sharedScalars);
+    dnaFREE(h->gvar.glyph.xIntDeltas);
+    dnaFREE(h->gvar.glyph.yIntDeltas);
+    dnaFREE(h->gvar.glyph.xDeltas);
+    dnaFREE(h->gvar.glyph.yDeltas);
+    dnaFREE(h->gvar.glyph.xDeltaSums);
+    dnaFREE(h->gvar.glyph.yDeltaSums);
+    dnaFREE(h->gvar.glyph.xOrig);
+    dnaFREE(h->gvar.glyph.yOrig);
+    dnaFREE(h->gvar.glyph.hasDelta);
+    dnaFREE(h->gvar.glyph.sharedPoints);
+    dnaFREE(h->gvar.glyph.privatePoints);
     dnaFREE(h->tmp0);
     dnaFREE(h->tmp1);
 
@@ -949,6 +1005,56 @@ static void maxpRead(ttrCtx h) {
     h->maxp.maxComponentDepth = read2(h);
 }
 
+/* Read the loca entry and metrics of a glyph on first access when the font
+   was opened with TTR_LAZY_LOAD, giving the same results as locaRead(),
+   hmtxRead() and the variable metrics lookup in ttrBegFont() do for all glyphs
+   otherwise. N.B. this moves the source position. */
+static void glyphLoad(ttrCtx h, GID gid) {
+    Glyph *glyph = &h->glyphs.array[gid];
+    long nLong = h->hhea.numberOfLongHorMetrics;
+    Offset begin;
+    Offset end;
+
+    if (!(h->client_flags & TTR_LAZY_LOAD) || (glyph->flags & GLYPH_LOADED))
+        return;
+    glyph->flags |= GLYPH_LOADED;
+
+    /* Read loca entry */
+    if (h->head.indexToLocFormat == 0) {
+        srcSeek(h, h->glyf.locaOffset + gid * 2);
+        begin = 2 * read2(h);
+        end = 2 * read2(h);
+    } else {
+        srcSeek(h, h->glyf.locaOffset + gid * 4);
+        begin = read4(h);
+        end = read4(h);
+    }
+    if (end >= begin) {
+        glyph->info.sup.begin = begin;
+        glyph->info.sup.end = end;
+    }
+
+    /* Read metrics */
+    if (h->vf.UDV && h->vf.axisCount > 0 && !(h->vf.flags & VF_FLAG_HMETRICS)) {
+        var_glyphMetrics metrics;
+        if (!var_lookuphmtx(&h->cb.shstm, h->vf.hmtx, h->vf.axisCount, h->vf.ndv, gid, &metrics)) {
+            glyph->flags |= GLYPH_MTX_SET;
+            glyph->hAdv = (uFWord)round(metrics.width);
+            glyph->lsb = (FWord)round(metrics.sideBearing);
+            return;
+        }
+    }
+    if (gid < nLong) {
+        srcSeek(h, h->glyf.hmtxOffset + gid * 4);
+        glyph->hAdv = read2(h);
+        glyph->lsb = sread2(h);
+    } else {
+        srcSeek(h, h->glyf.hmtxOffset + nLong * 4 + (gid - nLong) * 2);
+        glyph->hAdv = h->glyf.lastAdv;
+        glyph->lsb = sread2(h);
+    }
+}
+
 /* Read loca table. */
 static void locaRead(ttrCtx h) {
     long i;
@@ -972,6 +1078,12 @@ static void locaRead(ttrCtx h) {
             fatal(h, ttrErrLocaFormat, NULL);
     }
 
+    if (h->client_flags & TTR_LAZY_LOAD) {
+        /* Offsets are read by glyphLoad() */
+        h->glyf.locaOffset = table->offset;
+        return;
+    }
+
     /* Read offset array (note there are numGlyphs+1 offsets) */
     for (i = 0; i < h->glyphs.cnt; i++) {
         Offset end;
@@ -1002,6 +1114,20 @@ static void hmtxRead(ttrCtx h) {
     }
     srcSeek(h, table->offset);
 
+    if (h->client_flags & TTR_LAZY_LOAD) {
+        /* Metrics are read by glyphLoad() */
+        long nLong = h->hhea.numberOfLongHorMetrics;
+        h->glyf.hmtxOffset = table->offset;
+        h->glyf.lastAdv = 0;
+        if (nLong > h->glyphs.cnt)
+            nLong = h->glyphs.cnt;
+        if (nLong > 0) {
+            glyphLoad(h, (GID)(nLong - 1));
+            h->glyf.lastAdv = h->glyphs.array[nLong - 1].hAdv;
+        }
+        return;
+    }
+
     /* Read long horizontal metrics */
     for (i = 0; (i < h->hhea.numberOfLongHorMetrics) && (i < h->glyphs.cnt); i++) {
         FWord hAdv = read2(h);
@@ -1049,14 +1175,23 @@ static void gvarRead(ttrCtx h) {
     h->gvar.glyphCount = read2(h);
     h->gvar.flags = read2(h);
     h->gvar.dataArrayOffset = read4(h);
-    dnaSET_CNT(h->gvar.dataOffsets, h->gvar.glyphCount + 1);
+    h->gvar.dataOffsetsOffset = srcTell(h);
 
-    /* Read glyph variation data offsets */
-    for (i = 0; i < h->gvar.dataOffsets.cnt; i++) {
-        if (h->gvar.flags & gvar_FLAG_32BIT_OFFSET)
-            h->gvar.dataOffsets.array[i] = read4(h);
-        else  /* N.B. 16-bit offsets in table are divided by 2 */
-            h->gvar.dataOffsets.array[i] = read2(h) * 2;
+    if (h->client_flags & TTR_LAZY_LOAD) {
+        /* Offsets are read by gvarGetDataOffsets(); skip to shared tuples */
+        h->gvar.dataOffsets.cnt = 0;
+        srcSeek(h, h->gvar.dataOffsetsOffset + (h->gvar.glyphCount + 1) *
+                       ((h->gvar.flags & gvar_FLAG_32BIT_OFFSET) ? 4 : 2));
+    } else {
+        dnaSET_CNT(h->gvar.dataOffsets, h->gvar.glyphCount + 1);
+
+        /* Read glyph variation data offsets */
+        for (i = 0; i < h->gvar.dataOffsets.cnt; i++) {
+            if (h->gvar.flags & gvar_FLAG_32BIT_OFFSET)
+                h->gvar.dataOffsets.array[i] = read4(h);
+            else  /* N.B. 16-bit offsets in table are divided by 2 */
+                h->gvar.dataOffsets.array[i] = read2(h) * 2;
+        }
     }
 
     /* Read shared tuples */
@@ -1065,6 +1200,27 @@ static void gvarRead(ttrCtx h) {
         h->gvar.sharedTuples.array[i] = (Fixed)sread2(h) << 2; /* Fixed 2.14 to 16.16 */
 }
 
+/* Get the bounds of a glyph's variation data. */
+static void gvarGetDataOffsets(ttrCtx h, GID gid, uint32_t *begin, uint32_t *end) {
+    *begin = *end = 0; /* Set on every path; the compiler can't tell fatal() doesn't return */
+    if (!(h->client_flags & TTR_LAZY_LOAD)) {
+        if (gid >= h->gvar.dataOffsets.cnt)
+            fatal(h, ttrErrBadGlyphData, "no gvar data for gid [%d]", gid);
+        *begin = h->gvar.dataOffsets.array[gid];
+        *end = h->gvar.dataOffsets.array[gid + 1];
+    } else if (gid >= h->gvar.glyphCount) {
+        fatal(h, ttrErrBadGlyphData, "no gvar data for gid [%d]", gid);
+    } else if (h->gvar.flags & gvar_FLAG_32BIT_OFFSET) {
+        srcSeek(h, h->gvar.dataOffsetsOffset + gid * 4);
+        *begin = read4(h);
+        *end = read4(h);
+    } else {  /* N.B. 16-bit offsets in table are divided by 2 */
+        srcSeek(h, h->gvar.dataOffsetsOffset + gid * 2);
+        *begin = read2(h) * 2;
+        *end = read2(h) * 2;
+    }
+}
+
 static unsigned long gvarReadPackedPointNumbers(ttrCtx h, unsigned long pointCount, uint16_t* pnts, unsigned long maxPoints) {
     unsigned long index = 0;
     uint16_t runCount = 0;
@@ -1163,12 +1319,26 @@ static unsigned long gvarReadPackedDeltas(ttrCtx h, int16_t* deltas, long deltaC
     return deltaCount;
 }
 
+/* Return fixmul(FixInt(i), f). The product of an integer and a Fixed is exact
+   in 64 bits, so this avoids the library's double-precision arithmetic and
+   keeps the interpolation loops free of calls. */
+static Fixed gvarMulInt(int i, Fixed f) {
+    int64_t p = (int64_t)FixInt(i) * f / 65536;
+
+    if (p >= FixedPosInf)
+        return FixedPosInf;
+    else if (p <= FixedNegInf)
+        return FixedNegInf;
+    return (Fixed)p;
+}
+
 static void gvarInterpolateIntermCoord(
     int untouch1, int untouch2,
     int touch1, int touch2,
     int16_t* coords,
     Fixed *deltas) {
     int p;
+    int coord1, coord2;
     Fixed delta1, delta2;
     Fixed scale = 0;
 
@@ -1181,28 +1351,26 @@ static void gvarInterpolateIntermCoord(
         touch2 = p;
     }
 
+    coord1 = coords[touch1];
+    coord2 = coords[touch2];
     delta1 = deltas[touch1];
     delta2 = deltas[touch2];
 
-    if (delta1 == delta2 || coords[touch1] != coords[touch2]) {
-        if (coords[touch1] != coords[touch2])
-            scale = fixdiv(delta2 - delta1, FixInt(coords[touch2] - coords[touch1]));
+    if (delta1 == delta2 || coord1 != coord2) {
+        if (coord1 != coord2)
+            scale = fixdiv(delta2 - delta1, FixInt(coord2 - coord1));
         else
             scale = 0;
 
         for (p = untouch1; p <= untouch2; p++) {
-            Fixed delta;
             int v = coords[p];
 
-            if (v <= coords[touch1])
-                delta = delta1;
-            else if (v >= coords[touch2])
-                delta = delta2;
-            else {
-                delta = delta1 + fixmul(FixInt(v - coords[touch1]), scale);
-            }
-
-            deltas[p] = delta;
+            if (v <= coord1)
+                deltas[p] = delta1;
+            else if (v >= coord2)
+                deltas[p] = delta2;
+            else
+                deltas[p] = delta1 + gvarMulInt(v - coord1, scale);
         }
     }
 }
@@ -1277,9 +1445,39 @@ static void gvarInterpolateDeltas(ttrCtx h, int nContours, ptRange *ranges, int
     }
 }
 
+/* Compute the scalars of the shared tuples at the current instance. A shared
+   tuple without intermediate coordinates has the same scalar in every glyph,
+   so it is computed once per font rather than once per glyph. */
+static void gvarCalcSharedScalars(ttrCtx h) {
+    long i;
+
+    if (h->gvar.sharedTuples.cnt != (long)h->gvar.sharedTupleCount * h->gvar.axisCount) {
+        h->gvar.sharedScalars.cnt = 0;
+        return;
+    }
+
+    dnaSET_CNT(h->gvar.sharedScalars, h->gvar.sharedTupleCount);
+    for (i = 0; i < h->gvar.sharedScalars.cnt; i++)
+        h->gvar.sharedScalars.array[i] =
+            calculateScalar(h, 0, &h->gvar.sharedTuples.array[i * h->gvar.axisCount], NULL, NULL);
+}
+
+/* Add the deltas of one tuple to the glyph's running sums. */
+static void gvarAddDeltas(Fixed *sums, Fixed *deltas, long cnt) {
+    long i;
+
+    for (i = 0; i < cnt; i++)
+        sums[i] += deltas[i];
+}
+
 /* apply glyph variation data to points in a glyph
  * if nContours < 0, the glyph is a compound glyph
- * delta values for a component apply to all its points */
+ * delta values for a component apply to all its points
+ *
+ * Points are held as separate x and y arrays while the deltas are summed and
+ * tuple scalars are never 0 or more than 1.0 here, so a scaled delta is just
+ * the integer product delta * scalar; this is what fixmul(FixInt(delta),
+ * scalar) returns and it lets the compiler vectorize the delta loops. */
 static void applyGlyphVariationDeltas(ttrCtx h, GID gid, int nContours, int nPoints, int nTotalPoints,
                                       int ptBase, glyfCoord *coords, ptRange *ranges) {
     Fixed imStart[VF_MAX_AXES];
@@ -1293,17 +1491,18 @@ static void applyGlyphVariationDeltas(ttrCtx h, GID gid, int nContours, int nPoi
     unsigned long pntCount;
     unsigned int bAllPoints = 0;
     unsigned int bAllSharedPoints = 0;
-    dnaDCL(int16_t, xIntDeltas);
-    dnaDCL(int16_t, yIntDeltas);
-    dnaDCL(Fixed, xFixedDeltas);
-    dnaDCL(Fixed, yFixedDeltas);
-    dnaDCL(Fixed, xDeltaSums);
-    dnaDCL(Fixed, yDeltaSums);
-    dnaDCL(int16_t, xOrig);
-    dnaDCL(int16_t, yOrig);
-    dnaDCL(boolean, bHasDelta);
-    dnaDCL(uint16_t, sharedPoints);
-    dnaDCL(uint16_t, privatePoints);
+    int16_t *xIntDeltas;
+    int16_t *yIntDeltas;
+    Fixed *xDeltas;
+    Fixed *yDeltas;
+    Fixed *xDeltaSums;
+    Fixed *yDeltaSums;
+    int16_t *xOrig;
+    int16_t *yOrig;
+    boolean *hasDelta;
+    uint16_t *sharedPoints;
+    uint16_t *privatePoints;
+    long sharedPointsCount = 0;
     long pointIndicesCount;
     uint16_t *pointIndices;
     int nComponents = nPoints;
@@ -1312,11 +1511,11 @@ static void applyGlyphVariationDeltas(ttrCtx h, GID gid, int nContours, int nPoi
     uint16_t hmtxPhantomCnt = 0;
     Fixed scalar;
     uint16_t variationDataSize;
+    uint32_t dataBegin;
+    uint32_t dataEnd;
 
-    if (gid >= h->gvar.dataOffsets.cnt)
-        fatal(h, ttrErrBadGlyphData, "no gvar data for gid [%d]", gid);
-
-    if (h->gvar.dataOffsets.array[gid] >= h->gvar.dataOffsets.array[gid + 1])
+    gvarGetDataOffsets(h, gid, &dataBegin, &dataEnd);
+    if (dataBegin >= dataEnd)
         return; /* ignore if glyph variation data for this glyph is empty */
 
     if (h->vf.flags & VF_FLAG_HMETRICS)
@@ -1324,34 +1523,31 @@ static void applyGlyphVariationDeltas(ttrCtx h, GID gid, int nContours, int nPoi
 
     nPoints += PHANTOM_COUNT; /* add phantom points */
     nTotalPoints += PHANTOM_COUNT; /* add phantom points */
-    dnaINIT(h->ctx.dna, xIntDeltas, nPoints, 0);
-    dnaINIT(h->ctx.dna, yIntDeltas, nPoints, 0);
-    dnaINIT(h->ctx.dna, sharedPoints, nPoints, 0);
-    dnaINIT(h->ctx.dna, privatePoints, nPoints, 0);
-    dnaINIT(h->ctx.dna, xFixedDeltas, nTotalPoints, 0);
-    dnaINIT(h->ctx.dna, yFixedDeltas, nTotalPoints, 0);
-    dnaINIT(h->ctx.dna, xDeltaSums, nTotalPoints, 0);
-    dnaINIT(h->ctx.dna, yDeltaSums, nTotalPoints, 0);
-    dnaINIT(h->ctx.dna, xOrig, nTotalPoints, 0);
-    dnaINIT(h->ctx.dna, yOrig, nTotalPoints, 0);
-    dnaINIT(h->ctx.dna, bHasDelta, nTotalPoints, 0);
-    dnaSET_CNT(xIntDeltas, nPoints);
-    dnaSET_CNT(yIntDeltas, nPoints);
-    dnaSET_CNT(sharedPoints, nPoints);
-    dnaSET_CNT(privatePoints, nPoints);
-    dnaSET_CNT(xFixedDeltas, nTotalPoints);
-    dnaSET_CNT(yFixedDeltas, nTotalPoints);
-    dnaSET_CNT(xDeltaSums, nTotalPoints);
-    dnaSET_CNT(yDeltaSums, nTotalPoints);
-    dnaSET_CNT(xOrig, nTotalPoints);
-    dnaSET_CNT(yOrig, nTotalPoints);
-    dnaSET_CNT(bHasDelta, nTotalPoints);
-    memset(imStart, 0, sizeof(Fixed) * VF_MAX_AXES);
-    memset(imEnd, 0, sizeof(Fixed) * VF_MAX_AXES);
-    memset(peakTupleCoords, 0, sizeof(Fixed) * VF_MAX_AXES);
-    memset(xDeltaSums.array, 0, sizeof(Fixed) * nTotalPoints);
-    memset(yDeltaSums.array, 0, sizeof(Fixed) * nTotalPoints);
-    tupleHeaderOffset = h->gvar.tableOffset + h->gvar.dataArrayOffset + h->gvar.dataOffsets.array[gid];
+    dnaSET_CNT(h->gvar.glyph.xIntDeltas, nPoints);
+    dnaSET_CNT(h->gvar.glyph.yIntDeltas, nPoints);
+    dnaSET_CNT(h->gvar.glyph.sharedPoints, nPoints);
+    dnaSET_CNT(h->gvar.glyph.privatePoints, nPoints);
+    dnaSET_CNT(h->gvar.glyph.xDeltas, nTotalPoints);
+    dnaSET_CNT(h->gvar.glyph.yDeltas, nTotalPoints);
+    dnaSET_CNT(h->gvar.glyph.xDeltaSums, nTotalPoints);
+    dnaSET_CNT(h->gvar.glyph.yDeltaSums, nTotalPoints);
+    dnaSET_CNT(h->gvar.glyph.xOrig, nTotalPoints);
+    dnaSET_CNT(h->gvar.glyph.yOrig, nTotalPoints);
+    dnaSET_CNT(h->gvar.glyph.hasDelta, nTotalPoints);
+    xIntDeltas = h->gvar.glyph.xIntDeltas.array;
+    yIntDeltas = h->gvar.glyph.yIntDeltas.array;
+    sharedPoints = h->gvar.glyph.sharedPoints.array;
+    privatePoints = h->gvar.glyph.privatePoints.array;
+    xDeltas = h->gvar.glyph.xDeltas.array;
+    yDeltas = h->gvar.glyph.yDeltas.array;
+    xDeltaSums = h->gvar.glyph.xDeltaSums.array;
+    yDeltaSums = h->gvar.glyph.yDeltaSums.array;
+    xOrig = h->gvar.glyph.xOrig.array;
+    yOrig = h->gvar.glyph.yOrig.array;
+    hasDelta = h->gvar.glyph.hasDelta.array;
+    memset(xDeltaSums, 0, sizeof(Fixed) * nTotalPoints);
+    memset(yDeltaSums, 0, sizeof(Fixed) * nTotalPoints);
+    tupleHeaderOffset = h->gvar.tableOffset + h->gvar.dataArrayOffset + dataBegin;
     srcSeek(h, tupleHeaderOffset);
 
     tupleCount = read2(h);
@@ -1371,24 +1567,22 @@ static void applyGlyphVariationDeltas(ttrCtx h, GID gid, int nContours, int nPoi
         if (pntCount == 0) {
             bAllSharedPoints = 1;
         } else {
-            dnaSET_CNT(sharedPoints, gvarReadPackedPointNumbers(h, pntCount, &sharedPoints.array[0], nPoints));
-            pointIndices = privatePoints.array;
+            sharedPointsCount = gvarReadPackedPointNumbers(h, pntCount, sharedPoints, nPoints);
+            pointIndices = privatePoints;
         }
         serializedDataOffset = srcTell(h);
     }
 
     /* original outline points are used to interpolate untouched points */
     for (j = 0; j < nPoints; j++) {
-        xOrig.array[j] = coords[j].x;
-        yOrig.array[j] = coords[j].y;
+        xOrig[j] = coords[j].x;
+        yOrig[j] = coords[j].y;
     }
 
     tupleCount &= gvar_FLAG_COUNT_MASK;
     for (i = 0; i < tupleCount; i++, serializedDataOffset += variationDataSize) {
         uint16_t tupleIndex;
-
-        memset(xFixedDeltas.array, 0, sizeof(Fixed) * nTotalPoints);
-        memset(yFixedDeltas.array, 0, sizeof(Fixed) * nTotalPoints);
+        long deltaCount;
 
         srcSeek(h, tupleHeaderOffset);
         variationDataSize = read2(h);
@@ -1406,7 +1600,7 @@ static void applyGlyphVariationDeltas(ttrCtx h, GID gid, int nContours, int nPoi
             if (h->gvar.sharedTuples.cnt > 0)
                 peakTupleCoordsToUse = &h->gvar.sharedTuples.array[index * h->gvar.axisCount];
             else
-                goto exit; /* Return from here as we don't have peakTupleCoords. */
+                return; /* Return from here as we don't have peakTupleCoords. */
         }
 
         if (tupleIndex & gvar_FLAG_INTERMEDIATE_TUPLE) {
@@ -1418,7 +1612,11 @@ static void applyGlyphVariationDeltas(ttrCtx h, GID gid, int nContours, int nPoi
         }
         tupleHeaderOffset = srcTell(h);
 
-        scalar = calculateScalar(h, tupleIndex, peakTupleCoordsToUse, imStart, imEnd);
+        if (!(tupleIndex & (gvar_FLAG_EMBEDDED_PEAK_TUPLE | gvar_FLAG_INTERMEDIATE_TUPLE)) &&
+            h->gvar.sharedScalars.cnt > 0)
+            scalar = h->gvar.sharedScalars.array[tupleIndex & gvar_FLAG_TUPLE_INDEX_MASK];
+        else
+            scalar = calculateScalar(h, tupleIndex, peakTupleCoordsToUse, imStart, imEnd);
 
         if (scalar == 0)
             continue;
@@ -1432,15 +1630,14 @@ static void applyGlyphVariationDeltas(ttrCtx h, GID gid, int nContours, int nPoi
                 bAllPoints = 1;
                 pointIndicesCount = 0;
             } else {
-                dnaSET_CNT(privatePoints, gvarReadPackedPointNumbers(h, pntCount, &privatePoints.array[0], nPoints));
+                pointIndicesCount = gvarReadPackedPointNumbers(h, pntCount, privatePoints, nPoints);
                 bAllPoints = 0;
-                pointIndices = privatePoints.array;
-                pointIndicesCount = privatePoints.cnt;
+                pointIndices = privatePoints;
             }
         } else {
             if (!bAllSharedPoints) {
-                pointIndices = sharedPoints.array;
-                pointIndicesCount = sharedPoints.cnt;
+                pointIndices = sharedPoints;
+                pointIndicesCount = sharedPointsCount;
             } else
                 pointIndicesCount = 0;
 
@@ -1448,44 +1645,46 @@ static void applyGlyphVariationDeltas(ttrCtx h, GID gid, int nContours, int nPoi
         }
 
         /* read deltas for x and y coordinates. */
-        xIntDeltas.cnt = gvarReadPackedDeltas(h, xIntDeltas.array, pointIndicesCount ? pointIndicesCount : nPoints);
-        if (!xIntDeltas.cnt)
+        deltaCount = pointIndicesCount ? pointIndicesCount : nPoints;
+        if (!gvarReadPackedDeltas(h, xIntDeltas, deltaCount))
+            continue;
+        if (!gvarReadPackedDeltas(h, yIntDeltas, deltaCount))
             continue;
 
-        yIntDeltas.cnt = gvarReadPackedDeltas(h, yIntDeltas.array, pointIndicesCount ? pointIndicesCount : nPoints);
-        if (!yIntDeltas.cnt)
+        if (bAllPoints && nContours >= 0) {
+            /* simple glyph: outline points then the phantom points used for
+               metrics have a delta each and are summed directly. */
+            long cnt = nPoints - PHANTOM_COUNT + hmtxPhantomCnt;
+
+            for (j = 0; j < cnt; j++) {
+                xDeltaSums[j] += xIntDeltas[j] * scalar;
+                yDeltaSums[j] += yIntDeltas[j] * scalar;
+            }
             continue;
+        }
 
-        if (bAllPoints) {
-            if (nContours >= 0) { /* simple glyph */
-                for (j = 0; j < nPoints - PHANTOM_COUNT; j++) {
-                    xFixedDeltas.array[j] = fixmul(FixInt(xIntDeltas.array[j]), scalar);
-                    yFixedDeltas.array[j] = fixmul(FixInt(yIntDeltas.array[j]), scalar);
-                }
-                /* apply deltas to phantom points of a simple glyph */
-                for (l = 0; l < hmtxPhantomCnt; l++, j++) {
-                    xFixedDeltas.array[j] = fixmul(FixInt(xIntDeltas.array[j]), scalar);
-                    yFixedDeltas.array[j] = fixmul(FixInt(yIntDeltas.array[j]), scalar);
+        memset(xDeltas, 0, sizeof(Fixed) * nTotalPoints);
+        memset(yDeltas, 0, sizeof(Fixed) * nTotalPoints);
+
+        if (bAllPoints) {  /* compound glyph */
+            for (j = 0; j < nComponents; j++) {
+                Fixed xDelta = xIntDeltas[j] * scalar;
+                Fixed yDelta = yIntDeltas[j] * scalar;
+
+                k = ranges[j].begPt-ptBase;
+                for (; k <= ranges[j].endPt-ptBase; k++) {
+                    xDeltas[k] = xDelta;
+                    yDeltas[k] = yDelta;
                 }
-            } else {  /* compound glyph */
-                for (j = 0; j < nComponents; j++) {
-                    k = ranges[j].begPt-ptBase;
-                    for (; k <= ranges[j].endPt-ptBase; k++) {
-                        xFixedDeltas.array[k] = fixmul(FixInt(xIntDeltas.array[j]), scalar);
-                        yFixedDeltas.array[k] = fixmul(FixInt(yIntDeltas.array[j]), scalar);
-                    }
-                    /* apply deltas to phantom points of a component glyph */
-                    for (l = 0; l < hmtxPhantomCnt; l++, k++) {
-                        xFixedDeltas.array[k] = fixmul(FixInt(xIntDeltas.array[j]), scalar);
-                        yFixedDeltas.array[k] = fixmul(FixInt(yIntDeltas.array[j]), scalar);
-                    }
+                /* apply deltas to phantom points of a component glyph */
+                for (l = 0; l < hmtxPhantomCnt; l++, k++) {
+                    xDeltas[k] = xDelta;
+                    yDeltas[k] = yDelta;
                 }
             }
         } else if (nContours >= 0) {
             /* simple glyph, apply delta to some points */
-            for (j = 0; j < nPoints; j++) {
-                bHasDelta.array[j] = 0;
-            }
+            memset(hasDelta, 0, sizeof(boolean) * nPoints);
 
             /* apply delta values to points whose delta values are given in 'gvar' table. */
             for (j = 0; j < pointIndicesCount; j++) {
@@ -1494,14 +1693,14 @@ static void applyGlyphVariationDeltas(ttrCtx h, GID gid, int nContours, int nPoi
                 if (index >= nPoints)
                     continue;
 
-                xFixedDeltas.array[index] = fixmul(FixInt(xIntDeltas.array[j]), scalar);
-                yFixedDeltas.array[index] = fixmul(FixInt(yIntDeltas.array[j]), scalar);
+                xDeltas[index] = xIntDeltas[j] * scalar;
+                yDeltas[index] = yIntDeltas[j] * scalar;
 
-                bHasDelta.array[index] = 1;
+                hasDelta[index] = 1;
             }
 
             /* interpolate untouched points similar to 'iup' instruction. */
-            gvarInterpolateDeltas(h, nContours, ranges, ptBase, xOrig.array, yOrig.array, bHasDelta.array, xFixedDeltas.array, yFixedDeltas.array);
+            gvarInterpolateDeltas(h, nContours, ranges, ptBase, xOrig, yOrig, hasDelta, xDeltas, yDeltas);
         } else {
             /* compound glyph, apply delta to some components */
             for (j = 0; j < pointIndicesCount; j++) {
@@ -1513,37 +1712,24 @@ static void applyGlyphVariationDeltas(ttrCtx h, GID gid, int nContours, int nPoi
                 if (index < nComponents) {
                     k = ranges[index].begPt-ptBase;
                     for (; k <= ranges[index].endPt-ptBase; k++) {
-                        xFixedDeltas.array[k] = fixmul(FixInt(xIntDeltas.array[j]), scalar);
-                        yFixedDeltas.array[k] = fixmul(FixInt(yIntDeltas.array[j]), scalar);
+                        xDeltas[k] = xIntDeltas[j] * scalar;
+                        yDeltas[k] = yIntDeltas[j] * scalar;
                     }
                 } else if (index < nPoints + hmtxPhantomCnt) {
                     long phantomIndex = (index - nComponents) + ranges[nComponents-1].endPt - ptBase + 1;
-                    xFixedDeltas.array[phantomIndex] = fixmul(FixInt(xIntDeltas.array[j]), scalar);
-                    yFixedDeltas.array[phantomIndex] = fixmul(FixInt(yIntDeltas.array[j]), scalar);
+                    xDeltas[phantomIndex] = xIntDeltas[j] * scalar;
+                    yDeltas[phantomIndex] = yIntDeltas[j] * scalar;
                 }
             }
         }
-        for (j = 0; j < nTotalPoints; j++) {
-            xDeltaSums.array[j] += xFixedDeltas.array[j];
-            yDeltaSums.array[j] += yFixedDeltas.array[j];
-        }
+        gvarAddDeltas(xDeltaSums, xDeltas, nTotalPoints);
+        gvarAddDeltas(yDeltaSums, yDeltas, nTotalPoints);
     }
 
     for (j = 0; j < nTotalPoints; j++) {
-        coords[j].x += FRound(xDeltaSums.array[j]);
-        coords[j].y += FRound(yDeltaSums.array[j]);
+        coords[j].x += FRound(xDeltaSums[j]);
+        coords[j].y += FRound(yDeltaSums[j]);
     }
-
-exit: /* free the memory if any. */
-    dnaFREE(xIntDeltas);
-    dnaFREE(yIntDeltas);
-    dnaFREE(xDeltaSums);
-    dnaFREE(yDeltaSums);
-    dnaFREE(xOrig);
-    dnaFREE(yOrig);
-    dnaFREE(bHasDelta);
-    dnaFREE(sharedPoints);
-    dnaFREE(privatePoints);
 }
 
 /* Read name table. */
@@ -2590,6 +2776,7 @@ int ttrBegFont(ttrCtx h, long flags, long origin, int iTTC, abfTopDict **top, fl
     OS_2Read(h);
 
     h->gvar.axisCount = 0;
+    h->gvar.sharedScalars.cnt = 0;
     h->vf.UDV = UDV;
 
     /* Load variable font tables */
@@ -2619,6 +2806,8 @@ int ttrBegFont(ttrCtx h, long flags, long origin, int iTTC, abfTopDict **top, fl
             if (var_normalizeCoords(&h->cb.shstm, h->vf.axes, userCoords, h->vf.ndv))
                 fatal(h, ttrErrGeometry, "failed to normalize design vector");
 
+            gvarCalcSharedScalars(h);
+
             /* check HVAR table's availability */
             h->vf.flags = 0;
             if (!sfrGetTableByTag(h->ctx.sfr, CTL_TAG('H', 'V', 'A', 'R')))
@@ -2631,9 +2820,11 @@ int ttrBegFont(ttrCtx h, long flags, long origin, int iTTC, abfTopDict **top, fl
     for (i = 0; i < h->glyphs.cnt; i++) {
         Glyph *glyph = &h->glyphs.array[i];
         abfGlyphInfo *info = &glyph->info;
+        glyph->flags = 0;
         abfInitGlyphInfo(info);
         info->tag = (unsigned short)i;
-        if (h->vf.UDV && h->vf.axisCount > 0 && !(h->vf.flags & VF_FLAG_HMETRICS)) {
+        if (h->vf.UDV && h->vf.axisCount > 0 && !(h->vf.flags & VF_FLAG_HMETRICS) &&
+            !(h->client_flags & TTR_LAZY_LOAD)) {
             var_glyphMetrics    metrics;
             if (!var_lookuphmtx(&h->cb.shstm, h->vf.hmtx, h->vf.axisCount, h->vf.ndv, (unsigned short)i, &metrics)) {
                 glyph->flags |= GLYPH_MTX_SET;
@@ -2644,8 +2835,8 @@ int ttrBegFont(ttrCtx h, long flags, long origin, int iTTC, abfTopDict **top, fl
     }
 
     /* Read auxiliary glyph info */
-    hmtxRead(h);
     locaRead(h);
+    hmtxRead(h);
     table = sfrGetTableByTag(h->ctx.sfr, CTL_TAG('g', 'l', 'y', 'f'));
     if (table == NULL)
         return ttrErrNoGlyph;
@@ -2859,6 +3050,8 @@ static void glyfReadCompound(ttrCtx h, GID gid, GID *mtx_gid, int depth) {
         /* Save current offset */
         saveoff = srcTell(h);
 
+        glyphLoad(h, component);
+
         /* Read component glyph */
         if (h->glyphs.array[component].info.sup.begin == ABF_UNSET_INT) {
             iStart = h->glyf.coords.cnt;
@@ -3251,6 +3444,8 @@ static void readGlyph(ttrCtx h,
     int nContours = 0;
     Glyph *glyph = &h->glyphs.array[gid];
 
+    glyphLoad(h, gid);
+
     /* Begin glyph and mark it as seen */
     result = glyph_cb->beg(glyph_cb, &glyph->info);
     glyph->info.flags |= ABF_GLYPH_SEEN;
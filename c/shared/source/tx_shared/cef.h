@@ -1,5 +1,6 @@
 "[-cef options: default none]\n"
 "-F <FontName>   replace FontName in output file\n"
+"-cefsplit <n>   split subset into <n> fonts, parsing source font once\n"
 "-cefsvg         generate SVG font instead of CEF font\n"
 "\n"
 "CEF mode writes CEF (Compact Embedded Font) formatted data from an abstract\n"
@@ -7,6 +8,16 @@
 "replaces the one from the source font. The -cefsvg option tells the cefembed\n"
 "library to write out an SVG font instead of a CEF font.\n"
 "\n"
+"The -cefsplit option divides the subset into <n> parts of consecutive glyphs\n"
+"and writes each part as a separate font to the destination filename followed\n"
+"by a . (period) and the part number, starting from 1. The source font is\n"
+"parsed only once and held by the cefembed library while the parts are made.\n"
+"With -bench the parts are also made the specified number of times, once by\n"
+"parsing the source font for each part and once from the held font, and both\n"
+"rates are reported to stderr in subsets per second, e.g.:\n"
+"\n"
+"    tx -cef -cefsplit 100 -bench 10 font.otf\n"
+"\n"
 "For example, the command:\n"
 "\n"
 "    tx -cef -g C,E,F -a rdr_____.pfb\n"
@@ -43,6 +43,8 @@ void CTL_CDECL fatal(txCtx h, char *fmt, ...) {
         fprintf(stderr, "\n");
     }
     fprintf(stderr, "%s: fatal error\n", h->progname);
+    if (h->batchEnv != NULL)
+        longjmp(*h->batchEnv, 1); /* Batch mode discards context and goes on */
     h->appSpecificFree(h);
     exit(EXIT_FAILURE);
 }
@@ -259,7 +261,9 @@ static void *stm_open(ctlStreamCallbacks *cb, int id, size_t size) {
         case SVW_DST_STREAM_ID:
             /* Open destination stream */
             s = &h->dst.stm;
-            if (strcmp(s->filename, "-") == 0)
+            if (s->flags & STM_DISCARD)
+                s->pos = 0;
+            else if (strcmp(s->filename, "-") == 0)
                 s->fp = stdout;
             else {
                 s->fp = fopen(s->filename, "wb");
@@ -436,6 +440,10 @@ static size_t stm_write(ctlStreamCallbacks *cb, void *stream,
         case stm_Src:
         case stm_SrcUFO:
         case stm_Dst:
+            if (s->flags & STM_DISCARD) {
+                s->pos += count;
+                return count;
+            }
             return fwrite(ptr, 1, count, s->fp);
         case stm_Tmp:
             return tmp_write(s, count, ptr);
@@ -515,6 +523,25 @@ void stmFree(txCtx h, Stream *s) {
         (void)fclose(s->fp);
 }
 
+/* Replace tmp files already opened by library contexts with new ones. Used
+   by forked worker processes so that they don't share tmp file positions
+   with the parent or with each other. */
+void stmRenewTmp(txCtx h) {
+    Stream *tmps[] = {&h->cef.tmp0, &h->cef.tmp1, &h->t1r.tmp, &h->svr.tmp,
+                      &h->cfw.tmp, &h->t1w.tmp, &h->svw.tmp};
+    size_t i;
+
+    for (i = 0; i < ARRAY_LEN(tmps); i++) {
+        Stream *s = tmps[i];
+        if (s->fp != NULL) {
+            (void)fclose(s->fp);
+            s->fp = tmpfile();
+            if (s->fp == NULL)
+                fileError(h, s->filename);
+        }
+    }
+}
+
 /* Initialize stream callbacks and stream records. */
 void stmInit(txCtx h) {
     h->cb.stm.direct_ctx = h;
@@ -563,25 +590,34 @@ void dstFileSetName(txCtx h, char *filename) {
         strcpy(h->file.dst, filename);
 }
 
+/* Make automatic destination filename for -a from source filename. */
+void dstFileMakeAutoName(txCtx h, char *dst, char *srcname) {
+    char buf[FILENAME_MAX];
+    char *p = strrchr(srcname, '/');
+    if (p == NULL)
+        p = strrchr(srcname, '\\');
+    strcpy(buf, (p == NULL) ? srcname : p + 1);
+    p = strrchr(buf, '.');
+    if (p != NULL)
+        *p = '\0';
+
+    if (h->file.dd != NULL)
+        sprintf(dst, "%s/%s.%s", h->file.dd, buf, h->modename);
+    else
+        sprintf(dst, "%s.%s", buf, h->modename);
+}
+
 /* Set automatic destination filename. */
 static void dstFileSetAutoName(txCtx h, abfTopDict *top) {
-    char buf[FILENAME_MAX];
     char *filename;
 
     if (h->flags & AUTO_FILE_FROM_FILE) {
-        char *p = strrchr(h->file.src, '/');
-        if (p == NULL)
-            p = strrchr(h->file.src, '\\');
-        strcpy(buf, (p == NULL) ? h->file.src : p + 1);
-        p = strrchr(buf, '.');
-        if (p != NULL)
-            *p = '\0';
-        filename = buf;
-    } else if (h->flags & AUTO_FILE_FROM_FONT)
-        filename = (top->sup.flags & ABF_CID_FONT) ? top->cid.CIDFontName.ptr : top->FDArray.array[0].FontName.ptr;
-    else
+        dstFileMakeAutoName(h, h->file.dst, h->file.src);
+        return;
+    } else if (!(h->flags & AUTO_FILE_FROM_FONT))
         return;
 
+    filename = (top->sup.flags & ABF_CID_FONT) ? top->cid.CIDFontName.ptr : top->FDArray.array[0].FontName.ptr;
     if (h->file.dd != NULL)
         sprintf(h->file.dst, "%s/%s.%s", h->file.dd, filename, h->modename);
     else
@@ -954,6 +990,7 @@ static void path_EndFont(txCtx h) {
 static void path_EndSet(txCtx h) {
     if (abfFree(h->abf.ctx))
         fatal(h, NULL);
+    h->abf.ctx = NULL;
 }
 
 /* Set control functions. */
@@ -1108,6 +1145,7 @@ static void cff_EndSet(txCtx h) {
     if (h->app == APP_TX) {
         if (abfFree(h->abf.ctx))
             fatal(h, NULL);
+        h->abf.ctx = NULL;
     }
 }
 
@@ -1664,33 +1702,20 @@ static void cefGlyphMap(cefMapCallback *cb,
         printf("[%hu]=<%s> ", gid, info->gname.ptr);
 }
 
-/* End font. */
-static void cef_EndFont(txCtx h) {
-    cefMapCallback map;
-    cefEmbedSpec spec;
-    int result;
+/* Initialize embedding spec for the count glyphs of the subset starting at
+   first. The subset ids are converted in place, so this is done once for each
+   part of the subset. The glyph name list is the same for every part and is
+   shared by their specs. */
+static void cef_MakeSpec(txCtx h, long first, long count, cefEmbedSpec *spec) {
     long i;
     unsigned short unrec;
 
-    getGlyphList(h);
-
-    if (h->arg.g.cnt == 0) {
-        /* Whole font subset */
-        dnaSET_CNT(h->cef.subset, h->src.glyphs.cnt);
-        for (i = 0; i < h->cef.subset.cnt; i++)
-            h->cef.subset.array[i].id = (unsigned short)i;
-    } else {
-        h->cef.subset.cnt = 0;
-        h->cef.lookup.cnt = 0;
-        parseSubset(h, selectGlyph);
-    }
-
     h->cef.gnames.cnt = 0;
     unrec = 0xE000; /* Start of Private Use Area */
 
     if (h->top->sup.flags & ABF_CID_FONT) {
         /* Make CID subset, encoding all glyphs in PUA */
-        for (i = 0; i < h->cef.subset.cnt; i++) {
+        for (i = first; i < first + count; i++) {
             cefSubsetGlyph *dst = &h->cef.subset.array[i];
             abfGlyphInfo *src = h->src.glyphs.array[dst->id];
             dst->id = src->cid;
@@ -1698,7 +1723,7 @@ static void cef_EndFont(txCtx h) {
         }
     } else {
         /* Make tag list and assign Unicode encoding */
-        for (i = 0; i < h->cef.subset.cnt; i++) {
+        for (i = first; i < first + count; i++) {
             cefSubsetGlyph *dst = &h->cef.subset.array[i];
             abfGlyphInfo *src = h->src.glyphs.array[dst->id];
             if (src->gname.ptr != NULL) {
@@ -1741,35 +1766,146 @@ static void cef_EndFont(txCtx h) {
 
     /* Initialize embedding spec. */
 initspec:
-    spec.flags = h->arg.cef.flags;
-    spec.newFontName = h->arg.cef.F;
-    spec.UDV = getUDV(h);
-    spec.URL = NULL;
-    spec.subset.cnt = h->cef.subset.cnt;
-    spec.subset.array = h->cef.subset.array;
-    spec.subset.names = (h->cef.gnames.cnt > 0) ? h->cef.gnames.array : NULL;
-    spec.kern.cnt = 0;
+    spec->flags = h->arg.cef.flags;
+    spec->newFontName = h->arg.cef.F;
+    spec->UDV = getUDV(h);
+    spec->URL = NULL;
+    spec->subset.cnt = count;
+    spec->subset.array = &h->cef.subset.array[first];
+    spec->subset.names = (h->cef.gnames.cnt > 0) ? h->cef.gnames.array : NULL;
+    spec->kern.cnt = 0;
+}
+
+/* Make embedding font from spec. */
+static void cef_MakeFont(txCtx h, cefEmbedSpec *spec) {
+    cefMapCallback map;
+    int result;
 
-    printSpec(h, &spec);
-
-    /* Turn off segmentation on source stream */
-    h->seg.refill = NULL;
+    printSpec(h, spec);
 
     /* Initialize glyph mapping callback */
     map.ctx = NULL;
     map.glyphmap = cefGlyphMap;
 
-    if (h->arg.cef.flags & CEF_WRITE_SVG)
-        cefSetSvwFlags(h->cef.ctx, h->svw.flags);
-
     /* Make embedding font */
-    result = cefMakeEmbeddingFont(h->cef.ctx, &spec, &map);
+    result = cefMakeEmbeddingFont(h->cef.ctx, spec, &map);
     if (result)
         fatal(h, "(cef) %s", cefErrStr(result));
     else
         printf("\n");
 }
 
+/* Make the split parts of the subset h->cef.bench times, first by parsing the
+   source font for each part and then from the font held by cefBegFont(), and
+   report both rates. Each part is written to its destination file, which is
+   overwritten when the parts are made for real. */
+static void cefBenchSubsets(txCtx h, cefEmbedSpec *specs, long split,
+                            char *dst) {
+    double start;
+    double parseSecs;
+    double heldSecs;
+    long subsets = h->cef.bench * split;
+    long i;
+    long j;
+    int result;
+
+    /* Parse font for each part */
+    start = ctuWallTime();
+    for (i = 0; i < h->cef.bench; i++)
+        for (j = 0; j < split; j++) {
+            sprintf(h->file.dst, "%s.%ld", dst, j + 1);
+            result = cefMakeEmbeddingFont(h->cef.ctx, &specs[j], NULL);
+            if (result)
+                fatal(h, "(cef) %s", cefErrStr(result));
+        }
+    parseSecs = ctuWallTime() - start;
+
+    /* Parse font once and hold it */
+    start = ctuWallTime();
+    result = cefBegFont(h->cef.ctx, getUDV(h));
+    for (i = 0; !result && i < h->cef.bench; i++)
+        for (j = 0; !result && j < split; j++) {
+            sprintf(h->file.dst, "%s.%ld", dst, j + 1);
+            result = cefMakeEmbeddingFont(h->cef.ctx, &specs[j], NULL);
+        }
+    if (!result)
+        result = cefEndFont(h->cef.ctx);
+    if (result)
+        fatal(h, "(cef) %s", cefErrStr(result));
+    heldSecs = ctuWallTime() - start;
+
+    fprintf(stderr, "%s: made %ld subsets (%ld parts %ld times) by parsing "
+            "in %.3f sec (%.1f subsets/sec)\n",
+            h->progname, subsets, split, h->cef.bench, parseSecs,
+            (parseSecs > 0) ? subsets / parseSecs : 0.0);
+    fprintf(stderr, "%s: made %ld subsets (%ld parts %ld times) from the held "
+            "font in %.3f sec (%.1f subsets/sec)\n",
+            h->progname, subsets, split, h->cef.bench, heldSecs,
+            (heldSecs > 0) ? subsets / heldSecs : 0.0);
+}
+
+/* End font. */
+static void cef_EndFont(txCtx h) {
+    char dst[FILENAME_MAX];
+    cefEmbedSpec spec;
+    cefEmbedSpec *specs;
+    long split;
+    long i;
+    int result;
+
+    getGlyphList(h);
+
+    if (h->arg.g.cnt == 0) {
+        /* Whole font subset */
+        dnaSET_CNT(h->cef.subset, h->src.glyphs.cnt);
+        for (i = 0; i < h->cef.subset.cnt; i++)
+            h->cef.subset.array[i].id = (unsigned short)i;
+    } else {
+        h->cef.subset.cnt = 0;
+        h->cef.lookup.cnt = 0;
+        parseSubset(h, selectGlyph);
+    }
+
+    /* Turn off segmentation on source stream */
+    h->seg.refill = NULL;
+
+    if (h->arg.cef.flags & CEF_WRITE_SVG)
+        cefSetSvwFlags(h->cef.ctx, h->svw.flags);
+
+    split = h->arg.cef.split;
+    if (split > h->cef.subset.cnt)
+        split = h->cef.subset.cnt;
+    if (split <= 1) {
+        cef_MakeSpec(h, 0, h->cef.subset.cnt, &spec);
+        cef_MakeFont(h, &spec);
+        return;
+    }
+
+    /* Make a font from each part of the subset, parsing the source font only
+       once. Part n is written to <dst>.<n>. */
+    specs = memNew(h, split * sizeof(cefEmbedSpec));
+    for (i = 0; i < split; i++) {
+        long first = i * h->cef.subset.cnt / split;
+        long next = (i + 1) * h->cef.subset.cnt / split;
+        cef_MakeSpec(h, first, next - first, &specs[i]);
+    }
+    strcpy(dst, h->file.dst);
+    if (h->cef.bench > 0)
+        cefBenchSubsets(h, specs, split, dst);
+    result = cefBegFont(h->cef.ctx, getUDV(h));
+    if (result)
+        fatal(h, "(cef) %s", cefErrStr(result));
+    for (i = 0; i < split; i++) {
+        sprintf(h->file.dst, "%s.%ld", dst, i + 1);
+        cef_MakeFont(h, &specs[i]);
+    }
+    strcpy(h->file.dst, dst);
+    result = cefEndFont(h->cef.ctx);
+    if (result)
+        fatal(h, "(cef) %s", cefErrStr(result));
+    memFree(h, specs);
+}
+
 /* End font set. */
 static void cef_EndSet(txCtx h) {
 }
@@ -1779,6 +1915,7 @@ static void cef_SetMode(txCtx h) {
     /* Initialize args */
     h->arg.cef.F = NULL;
     h->arg.cef.flags = 0;
+    h->arg.cef.split = 1;
     h->svw.flags = SVW_NEWLINE_UNIX; /* In case cfembed library used in svgwrite mode */
 
     /* Set mode name */
@@ -2543,6 +2680,32 @@ findEOF:
         fileError(h, fontfile);
 }
 
+/* Write the font h->t1w.bench times, discarding the output, and report the
+   writing rate. The glyphs accumulated by t1write are kept between passes so
+   each pass encrypts and encodes the whole font again. */
+static void t1wBenchFont(txCtx h) {
+    Stream *s = &h->dst.stm;
+    short dstFlags = s->flags;
+    double start;
+    double secs;
+    double MB;
+    long i;
+
+    s->flags |= STM_DISCARD;
+    start = ctuWallTime();
+    for (i = 0; i < h->t1w.bench; i++)
+        if (t1wEndFont(h->t1w.ctx, h->top))
+            fatal(h, NULL);
+    secs = ctuWallTime() - start;
+    MB = s->pos / (1024.0 * 1024.0);
+    s->flags = dstFlags;
+
+    fprintf(stderr, "%s: wrote %.2f MB font %ld times in %.3f sec "
+            "(%.1f MB/sec)\n",
+            h->progname, MB, h->t1w.bench, secs,
+            (secs > 0) ? MB * h->t1w.bench / secs : 0.0);
+}
+
 /* End font. */
 static void t1_EndFont(txCtx h) {
     if (h->t1w.options & T1W_DECID) {
@@ -2587,6 +2750,8 @@ static void t1_EndFont(txCtx h) {
 
     if (h->app == APP_TX) {
         if (!(h->flags & PATH_REMOVE_OVERLAP)) {
+            if (h->t1w.bench > 0)
+                t1wBenchFont(h);
             if (t1wEndFont(h->t1w.ctx, h->top))
                 fatal(h, NULL);
         } else {
@@ -2606,6 +2771,8 @@ static void t1_EndFont(txCtx h) {
             if (abfEndFont(h->abf.ctx, ABF_PATH_REMOVE_OVERLAP, &h->cb.glyph))
                 fatal(h, NULL);
 
+            if (h->t1w.bench > 0)
+                t1wBenchFont(h);
             if (t1wEndFont(h->t1w.ctx, h->top))
                 fatal(h, NULL);
         }
@@ -4942,13 +5109,18 @@ void prepOTF(txCtx h) {
 
 /* Read font with ttread library. */
 void ttrReadFont(txCtx h, long origin, int iTTC) {
+    long flags = h->ttr.flags;
+
     if (h->ttr.ctx == NULL) {
         h->ttr.ctx = ttrNew(&h->cb.mem, &h->cb.stm, TTR_CHECK_ARGS);
         if (h->ttr.ctx == NULL)
             fatal(h, "(ttr) can't init lib");
     }
 
-    if (ttrBegFont(h->ttr.ctx, h->ttr.flags, origin, iTTC, &h->top, getUDV(h)))
+    if (h->arg.g.cnt != 0 && !(h->flags & SUBSET__EXCLUDE_OPT))
+        flags |= TTR_LAZY_LOAD; /* Only read the selected glyphs' data */
+
+    if (ttrBegFont(h->ttr.ctx, flags, origin, iTTC, &h->top, getUDV(h)))
         fatal(h, NULL);
 
     prepSubset(h);
@@ -652,20 +652,19 @@ static void drawTic(IntX marks, Pelt A) {
         v.x = u.y * PTS(h, 5.5);
         v.y = -u.x * PTS(v, 5.5);
 
-        workstr[0] = '\0';
-        snprintf(workstr, WORKSTR_BUF_SIZE,
-                "gsave %% tic\n"
-                "newpath\n"
-                "%g %g moveto\n"
-                "%g %g rlineto\n",
-                Bx, By, v.x, v.y);
-        proofPSOUT(cffproofctx, workstr);
+        proofPSOUT(cffproofctx, "gsave % tic\nnewpath\n");
+        proofPSNUM(cffproofctx, Bx);
+        proofPSNUM(cffproofctx, By);
+        proofPSOUT(cffproofctx, "moveto\n");
+        proofPSNUM(cffproofctx, v.x);
+        proofPSNUM(cffproofctx, v.y);
+        proofPSOUT(cffproofctx, "rlineto\n");
 
         y = (v.y > 0.0) ? 0.0 : -(PTS(v, NUMERIC_LABEL_SIZE) * 2.0) / 3.0;
         if (v.x >= 0.0) {
-            workstr[0] = '\0';
-            snprintf(workstr, WORKSTR_BUF_SIZE, "0 %g rmoveto\n", y);
-            proofPSOUT(cffproofctx, workstr);
+            proofPSOUT(cffproofctx, "0 ");
+            proofPSNUM(cffproofctx, y);
+            proofPSOUT(cffproofctx, "rmoveto\n");
         } else {
             workstr[0] = '\0';
             snprintf(workstr, WORKSTR_BUF_SIZE, "(%.0f %.0f) stringwidth pop neg %g rmoveto\n",
@@ -689,10 +688,13 @@ static void setMatrix(Pelt last, double x, double y) {
     double dy = y - last->coord[YP0];
     double hyp = sqrt(dx * dx + dy * dy);
 
-    workstr[0] = '\0';
-    snprintf(workstr, WORKSTR_BUF_SIZE, "[%g %g %g %g %g %g] concat\n",
-            STD2FNT(h, dx / hyp), STD2FNT(v, dy / hyp),
-            -STD2FNT(v, dy / hyp), STD2FNT(h, dx / hyp), x, y);
+    proofPSOUT(cffproofctx, "[");
+    proofPSNUM(cffproofctx, STD2FNT(h, dx / hyp));
+    proofPSNUM(cffproofctx, STD2FNT(v, dy / hyp));
+    proofPSNUM(cffproofctx, -STD2FNT(v, dy / hyp));
+    proofPSNUM(cffproofctx, STD2FNT(h, dx / hyp));
+    proofPSNUM(cffproofctx, x);
+    strcpy(proofFmtNum(workstr, y), "] concat\n");
     proofPSOUT(cffproofctx, workstr);
 }
 
@@ -717,9 +719,9 @@ static void drawCurveClosePath(IntX marks, Pelt last, Pelt p) {
 /* Draw control point */
 static void drawCntlPoint(IntX marks, IntX x, IntX y) {
     if (marks) {
-        workstr[0] = '\0';
-        snprintf(workstr, WORKSTR_BUF_SIZE, "%d %d cntlpt\n", x, y);
-        proofPSOUT(cffproofctx, workstr);
+        proofPSNUM(cffproofctx, x);
+        proofPSNUM(cffproofctx, y);
+        proofPSOUT(cffproofctx, "cntlpt\n");
     }
 }
 
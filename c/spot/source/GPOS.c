@@ -147,6 +147,7 @@ static void freeProofRecs() {
         da_FREE(proofrecords);
         proofrecords.size = proofrecords.cnt = 0;
     }
+    curproofrec = -1;
 }
 
 static void clearValueRecord(ValueRecord *vr) {
@@ -882,7 +883,7 @@ static void readLigatureAttach(Card32 offset, LigatureAttach *ligatureAttach, In
         ComponentRecord *record;
         record = &(ligatureAttach->ComponentRecord[i]);
         record->LigatureAnchor = memNew(sizeof(Offset) * classcount);
-        record->_LigatureAnchor = memNew(sizeof(record->LigatureAnchor[0]) * classcount); /* this makes an array of void* */
+        record->_LigatureAnchor = memNew(sizeof(record->_LigatureAnchor[0]) * classcount); /* this makes an array of void* */
         for (c = 0; c < classcount; c++) {
             IN1(record->LigatureAnchor[c]);
             if (record->LigatureAnchor[c] != 0)
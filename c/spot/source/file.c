@@ -26,10 +26,24 @@ static struct
     IntX id;           /* File identifier */
     Byte8 *name;       /* File name */
     Card8 buf[BUFSIZ]; /* Input buffer */
-    Card8 *next;       /* Next character to read */
-    Card8 *end;        /* One past end of filled buffer */
+    Card8 *map;        /* Mapped file data; NULL if buffered */
+    Card32 length;     /* Mapped file length */
 } file = {(-1), NULL};
 
+/* Input window; the whole file when mapped, else the filled buffer. The
+   IN1() macro reads directly from it */
+FileInput fileIn = {NULL, NULL};
+
+/* Map file, if possible, else prepare for buffered reads */
+static void openInput(void) {
+    file.map = (file.id > 0) ? sysMap(file.id, &file.length) : NULL;
+    if (file.map != NULL) {
+        fileIn.next = file.map;
+        fileIn.end = file.map + file.length;
+    } else
+        fileIn.end = fileIn.next = file.buf;
+}
+
 #if MACINTOSH
 static Byte8 gMacfilename[256] = {0};
 #endif
@@ -50,7 +64,7 @@ void fileOpen(Byte8 *filename) {
             if (!errcode) {
                 file.id = sysOpenSearchpath(gMacfilename);
                 file.name = gMacfilename;
-                file.end = file.next = file.buf;
+                openInput();
             } else
                 file.id = (-1);
         } else
@@ -61,7 +75,7 @@ void fileOpen(Byte8 *filename) {
         /* WAS: file.id = sysOpen(filename); */
         file.id = sysOpenSearchpath(filename);
         file.name = filename;
-        file.end = file.next = file.buf;
+        openInput();
     }
 }
 
@@ -70,7 +84,8 @@ void fileOpen(Byte8 *filename) {
 void fileOpenMacRes(Byte8 *filename) {
     file.id = sysMacOpenRes(filename);
     file.name = filename;
-    file.end = file.next = file.buf;
+    file.map = NULL;
+    fileIn.end = fileIn.next = file.buf;
 }
 #endif
 
@@ -80,44 +95,72 @@ IntX fileIsOpened(void) {
 
 /* Close file */
 void fileClose(void) {
+    if (file.map != NULL) {
+        sysUnmap(file.map, file.length);
+        file.map = NULL;
+    }
     if (file.id > 0)
         sysClose(file.id, file.name);
     file.id = (-1);
     /* don't mess with the name field */
-    file.next = NULL;
-    file.end = NULL;
+    fileIn.next = NULL;
+    fileIn.end = NULL;
+}
+
+/* Return file length */
+Card32 fileLength(void) {
+    Int32 at, length;
+
+    if (file.map != NULL)
+        return file.length;
+    at = sysTell(file.id, file.name);
+    length = sysFileLen(file.id);
+    sysSeek(file.id, at, 0, file.name);
+    return (length < 0) ? 0 : length;
 }
 
 /* Return file position */
 Card32 fileTell(void) {
-    return sysTell(file.id, file.name) - (file.end - file.next);
+    if (file.map != NULL)
+        return fileIn.next - file.map;
+    return sysTell(file.id, file.name) - (fileIn.end - fileIn.next);
 }
 
 /* Seek to absolute or relative offset */
 void fileSeek(Card32 offset, int relative) {
-    Card32 at = sysTell(file.id, file.name);
-    Card32 to = relative ? at + offset : offset;
+    Card32 at;
+    Card32 to;
+
+    if (file.map != NULL) {
+        /* Reposition within mapped data; reads past the end fail */
+        to = relative ? (Card32)(fileIn.next - file.map) + offset : offset;
+        fileIn.next = (to < file.length) ? file.map + to : fileIn.end;
+        return;
+    }
+
+    at = sysTell(file.id, file.name);
+    to = relative ? at + offset : offset;
 
 #if OLD
-    if (to >= at - (file.end - file.buf) && to < at)
+    if (to >= at - (fileIn.end - file.buf) && to < at)
         /* Offset already within current buffer */
-        file.next = file.end - (at - to);
+        fileIn.next = fileIn.end - (at - to);
     else {
         /* Offset outside current buffer */
         sysSeek(file.id, to, 0, file.name);
-        file.next = file.end;
+        fileIn.next = fileIn.end;
     }
 #else
     /* require that any SEEK invalidates buffer */
     sysSeek(file.id, to, 0, file.name);
-    file.next = file.end = file.buf;
+    fileIn.next = fileIn.end = file.buf;
 #endif
 }
 
 void fileSeekAbsNotBuffered(Card32 offset) {
 #if OLD
     sysSeek(file.id, offset, 0, file.name);
-    file.next = file.end;
+    fileIn.next = fileIn.end;
 #else
     fileSeek(offset, 0);
 #endif
@@ -125,28 +168,32 @@ void fileSeekAbsNotBuffered(Card32 offset) {
 
 /* Fill buffer */
 static void fillBuf(void) {
-    IntX count = sysRead(file.id, file.buf, BUFSIZ, file.name);
+    IntX count;
+    if (file.map != NULL)
+        /* Whole file already available */
+        fatal(SPOT_MSG_EARLYEOF, file.name);
+    count = sysRead(file.id, file.buf, BUFSIZ, file.name);
     if (count == 0)
         fatal(SPOT_MSG_EARLYEOF, file.name);
-    file.end = file.buf + count;
-    file.next = file.buf;
+    fileIn.end = file.buf + count;
+    fileIn.next = file.buf;
 }
 
 /* Supply specified number of bytes */
 void fileReadBytes(Int32 count, Card8 *buf) {
     while (count > 0) {
         IntX size;
-        IntX left = file.end - file.next;
+        IntX left = fileIn.end - fileIn.next;
 
         if (left == 0) {
             fillBuf();
-            left = file.end - file.next;
+            left = fileIn.end - fileIn.next;
         }
 
         size = (left < count) ? left : count;
 
-        memcpy(buf, file.next, size);
-        file.next += size;
+        memcpy(buf, fileIn.next, size);
+        fileIn.next += size;
         buf += size;
         count -= size;
     }
@@ -159,21 +206,21 @@ void fileReadObject(IntX size, ...) {
     va_list ap;
 
     va_start(ap, size);
-    if (file.end - file.next >= size) {
+    if (fileIn.end - fileIn.next >= size) {
         /* Request doesn't cross block boundary */
         switch (size) {
             case 1:
-                *va_arg(ap, Int8 *) = *file.next++;
+                *va_arg(ap, Int8 *) = *fileIn.next++;
                 break;
             case 2:
-                value = *file.next++;
-                *va_arg(ap, Int16 *) = value << 8 | *file.next++;
+                value = *fileIn.next++;
+                *va_arg(ap, Int16 *) = value << 8 | *fileIn.next++;
                 break;
             case 4:
-                value = *file.next++;
-                value = value << 8 | *file.next++;
-                value = value << 8 | *file.next++;
-                *va_arg(ap, Int32 *) = value << 8 | *file.next++;
+                value = *fileIn.next++;
+                value = value << 8 | *fileIn.next++;
+                value = value << 8 | *fileIn.next++;
+                *va_arg(ap, Int32 *) = value << 8 | *fileIn.next++;
                 break;
             default:
                 fatal(SPOT_MSG_BADREADSIZE, size);
@@ -181,24 +228,24 @@ void fileReadObject(IntX size, ...) {
         }
     } else {
         /* Read across block boundary */
-        if (file.next == file.end) fillBuf();
+        if (fileIn.next == fileIn.end) fillBuf();
         switch (size) {
             case 1:
-                *va_arg(ap, Int8 *) = *file.next++;
+                *va_arg(ap, Int8 *) = *fileIn.next++;
                 break;
             case 2:
-                value = *file.next++;
-                if (file.next == file.end) fillBuf();
-                *va_arg(ap, Int16 *) = value << 8 | *file.next++;
+                value = *fileIn.next++;
+                if (fileIn.next == fileIn.end) fillBuf();
+                *va_arg(ap, Int16 *) = value << 8 | *fileIn.next++;
                 break;
             case 4:
-                value = *file.next++;
-                if (file.next == file.end) fillBuf();
-                value = value << 8 | *file.next++;
-                if (file.next == file.end) fillBuf();
-                value = value << 8 | *file.next++;
-                if (file.next == file.end) fillBuf();
-                *va_arg(ap, Int32 *) = value << 8 | *file.next++;
+                value = *fileIn.next++;
+                if (fileIn.next == fileIn.end) fillBuf();
+                value = value << 8 | *fileIn.next++;
+                if (fileIn.next == fileIn.end) fillBuf();
+                value = value << 8 | *fileIn.next++;
+                if (fileIn.next == fileIn.end) fillBuf();
+                *va_arg(ap, Int32 *) = value << 8 | *fileIn.next++;
                 break;
             default:
                 fatal(SPOT_MSG_BADREADSIZE, size);
@@ -212,23 +259,23 @@ void fileReadObject(IntX size, ...) {
 void fileReadObject(IntX size, void *ap) {
     Int32 value, final;
 
-    if (file.end - file.next >= size) {
+    if (fileIn.end - fileIn.next >= size) {
         /* Request doesn't cross block boundary */
         switch (size) {
             case 1:
-                final = *file.next++;
+                final = *fileIn.next++;
                 *((Int8 *)ap) = (Int8)final;
                 break;
             case 2:
-                value = *file.next++;
-                final = value << 8 | *file.next++;
+                value = *fileIn.next++;
+                final = value << 8 | *fileIn.next++;
                 *((Int16 *)ap) = (Int16)final;
                 break;
             case 4:
-                value = *file.next++;
-                value = value << 8 | *file.next++;
-                value = value << 8 | *file.next++;
-                final = value << 8 | *file.next++;
+                value = *fileIn.next++;
+                value = value << 8 | *fileIn.next++;
+                value = value << 8 | *fileIn.next++;
+                final = value << 8 | *fileIn.next++;
                 *((Int32 *)ap) = (Int32)final;
                 break;
             default:
@@ -237,26 +284,26 @@ void fileReadObject(IntX size, void *ap) {
         }
     } else {
         /* Read across block boundary */
-        if (file.next == file.end) fillBuf();
+        if (fileIn.next == fileIn.end) fillBuf();
         switch (size) {
             case 1:
-                final = *file.next++;
+                final = *fileIn.next++;
                 *((Int8 *)ap) = (Int8)final;
                 break;
             case 2:
-                value = *file.next++;
-                if (file.next == file.end) fillBuf();
-                final = value << 8 | *file.next++;
+                value = *fileIn.next++;
+                if (fileIn.next == fileIn.end) fillBuf();
+                final = value << 8 | *fileIn.next++;
                 *((Int16 *)ap) = (Int16)final;
                 break;
             case 4:
-                value = *file.next++;
-                if (file.next == file.end) fillBuf();
-                value = value << 8 | *file.next++;
-                if (file.next == file.end) fillBuf();
-                value = value << 8 | *file.next++;
-                if (file.next == file.end) fillBuf();
-                final = value << 8 | *file.next++;
+                value = *fileIn.next++;
+                if (fileIn.next == fileIn.end) fillBuf();
+                value = value << 8 | *fileIn.next++;
+                if (fileIn.next == fileIn.end) fillBuf();
+                value = value << 8 | *fileIn.next++;
+                if (fileIn.next == fileIn.end) fillBuf();
+                final = value << 8 | *fileIn.next++;
                 *((Int32 *)ap) = (Int32)final;
                 break;
             default:
@@ -274,16 +321,25 @@ Byte8 *fileName(void) {
 Card32 fileSniff(void) {
     IntX count = 0;
     Card32 value;
+    if (file.map != NULL) {
+        if (fileIn.end - fileIn.next < 4)
+            return 0xBADBAD;
+        value = *fileIn.next++;
+        value = value << 8 | *fileIn.next++;
+        value = value << 8 | *fileIn.next++;
+        value = value << 8 | *fileIn.next++;
+        return value;
+    }
     count = sysRead(file.id, file.buf, 4, file.name);
-    file.end = file.buf + 4;
+    fileIn.end = file.buf + 4;
     if (count == 0)
         value = 0xBADBAD;
     else {
-        file.next = file.buf;
-        value = *file.next++;
-        value = value << 8 | *file.next++;
-        value = value << 8 | *file.next++;
-        value = value << 8 | *file.next++;
+        fileIn.next = file.buf;
+        value = *fileIn.next++;
+        value = value << 8 | *fileIn.next++;
+        value = value << 8 | *fileIn.next++;
+        value = value << 8 | *fileIn.next++;
     }
     return value;
 }
@@ -9,10 +9,18 @@
 #ifndef FILE_H
 #define FILE_H
 
+typedef struct
+{
+    Card8 *next; /* Next byte to read */
+    Card8 *end;  /* One past end of available bytes */
+} FileInput;
+extern FileInput fileIn;
+
 extern void fileOpen(Byte8 *filename);
 extern IntX fileIsOpened(void);
 extern IntX fileExists(Byte8 *filename);
 extern void fileClose(void);
+extern Card32 fileLength(void);
 extern Card32 fileTell(void);
 extern void fileSeek(Card32 offset, int relative);
 extern void fileSeekAbsNotBuffered(Card32 offset);
@@ -35,7 +43,23 @@ extern void fileOpenMacRes(Byte8 *filename);
 #define SEEK_REL(o) fileSeek((o), 1) /* From current position */
 #define SEEK_SURE(o) fileSeekAbsNotBuffered((o))
 #define IN_BYTES(c, b) fileReadBytes((c), (b))
-#define IN1(o) fileReadObject(sizeof(o), &(o))
+#define IN1(o)                                                     \
+    do {                                                           \
+        if (fileIn.end - fileIn.next < (long)sizeof(o))            \
+            fileReadObject(sizeof(o), &(o));                       \
+        else if (sizeof(o) == 1)                                   \
+            (o) = *fileIn.next++;                                  \
+        else if (sizeof(o) == 2) {                                 \
+            (o) = fileIn.next[0] << 8 | fileIn.next[1];            \
+            fileIn.next += 2;                                      \
+        } else if (sizeof(o) == 4) {                               \
+            (o) = (Card32)fileIn.next[0] << 24 |                   \
+                  (Card32)fileIn.next[1] << 16 |                   \
+                  fileIn.next[2] << 8 | fileIn.next[3];            \
+            fileIn.next += 4;                                      \
+        } else                                                     \
+            fileReadObject(sizeof(o), &(o));                       \
+    } while (0)
 #define IN3(o)             \
     {                      \
         unsigned char ui8; \
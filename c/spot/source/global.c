@@ -276,6 +276,11 @@ void initGlyphNames(void) {
         nameLookupType = 6;
 }
 
+/* Forget name source of previous font */
+void resetGlyphNames(void) {
+    nameLookupType = 0;
+}
+
 /* Get glyph name. If unable to get a name return "@<gid>" string. Returns
    pointer to SINGLE static buffer so subsequent calls will overwrite. */
 Byte8 *getGlyphName(GlyphId glyphId, IntX forProofing) {
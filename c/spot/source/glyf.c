@@ -558,20 +558,19 @@ static void drawTic(IntX marks, Point *A, double Bx, double By, Point *C) {
         v.x = -u.y * PTS(h, 5.5);
         v.y = u.x * PTS(v, 5.5);
 
-        workstr[0] = '\0';
-        snprintf(workstr, WORKSTR_BUF_SIZE,
-                "gsave\n"
-                "newpath\n"
-                "%g %g moveto\n"
-                "%g %g rlineto\n",
-                Bx, By, v.x, v.y);
-        proofPSOUT(proofctx, workstr);
+        proofPSOUT(proofctx, "gsave\nnewpath\n");
+        proofPSNUM(proofctx, Bx);
+        proofPSNUM(proofctx, By);
+        proofPSOUT(proofctx, "moveto\n");
+        proofPSNUM(proofctx, v.x);
+        proofPSNUM(proofctx, v.y);
+        proofPSOUT(proofctx, "rlineto\n");
 
         y = (v.y > 0.0) ? 0.0 : -(PTS(v, NUMERIC_LABEL_SIZE) * 2.0) / 3.0;
         if (v.x >= 0.0) {
-            workstr[0] = '\0';
-            snprintf(workstr, WORKSTR_BUF_SIZE, "0 %g rmoveto\n", y);
-            proofPSOUT(proofctx, workstr);
+            proofPSOUT(proofctx, "0 ");
+            proofPSNUM(proofctx, y);
+            proofPSOUT(proofctx, "rmoveto\n");
         } else {
             workstr[0] = '\0';
             snprintf(workstr, WORKSTR_BUF_SIZE, "(%.0f %.0f) stringwidth pop neg %g rmoveto\n",
@@ -595,10 +594,13 @@ static void setMatrix(Point *last, double x, double y) {
     double dy = y - last->y;
     double hyp = sqrt(dx * dx + dy * dy);
 
-    workstr[0] = '\0';
-    snprintf(workstr, WORKSTR_BUF_SIZE, "[%g %g %g %g %g %g] concat\n",
-            STD2FNT(h, dx / hyp), STD2FNT(v, dy / hyp),
-            -STD2FNT(v, dy / hyp), STD2FNT(h, dx / hyp), x, y);
+    proofPSOUT(proofctx, "[");
+    proofPSNUM(proofctx, STD2FNT(h, dx / hyp));
+    proofPSNUM(proofctx, STD2FNT(v, dy / hyp));
+    proofPSNUM(proofctx, -STD2FNT(v, dy / hyp));
+    proofPSNUM(proofctx, STD2FNT(h, dx / hyp));
+    proofPSNUM(proofctx, x);
+    strcpy(proofFmtNum(workstr, y), "] concat\n");
     proofPSOUT(proofctx, workstr);
 }
 
@@ -635,9 +637,9 @@ static void drawCurveClosePath(IntX marks, Point *last, double x, double y) {
 /* Draw control point */
 static void drawCntlPoint(IntX marks, Point *p) {
     if (marks) {
-        workstr[0] = '\0';
-        snprintf(workstr, WORKSTR_BUF_SIZE, "%d %d cntlpt\n", p->x, p->y);
-        proofPSOUT(proofctx, workstr);
+        proofPSNUM(proofctx, p->x);
+        proofPSNUM(proofctx, p->y);
+        proofPSOUT(proofctx, "cntlpt\n");
     }
 }
 
@@ -699,9 +701,9 @@ static void drawPath(GlyphId glyphId, IntX marks, IntX fill) {
 
                 /* Start contour and draw closepath */
                 if (p1.on) {
-                    workstr[0] = '\0';
-                    snprintf(workstr, WORKSTR_BUF_SIZE, "%d %d moveto\n", p1.x, p1.y);
-                    proofPSOUT(proofctx, workstr);
+                    proofPSNUM(proofctx, p1.x);
+                    proofPSNUM(proofctx, p1.y);
+                    proofPSOUT(proofctx, "moveto\n");
 
                     if (p0.on)
                         drawLineClosePath(marks, &p0, &p1);
@@ -716,17 +718,15 @@ static void drawPath(GlyphId glyphId, IntX marks, IntX fill) {
 
                         i2 = iStart;
 
-                        workstr[0] = '\0';
-                        snprintf(workstr, WORKSTR_BUF_SIZE, "%d %d moveto\n", p1.x, p1.y);
-                        proofPSOUT(proofctx, workstr);
+                        proofPSNUM(proofctx, p1.x);
+                        proofPSNUM(proofctx, p1.y);
+                        proofPSOUT(proofctx, "moveto\n");
                     } else {
-                        workstr[0] = '\0';
-                        snprintf(workstr, WORKSTR_BUF_SIZE,
-                                "%g %g moveto\n"
-                                "%g %g ",
-                                (p0.x + p1.x) / 2.0, (p0.y + p1.y) / 2.0,
-                                (p0.x + 5 * p1.x) / 6.0, (p0.y + 5 * p1.y) / 6.0);
-                        proofPSOUT(proofctx, workstr);
+                        proofPSNUM(proofctx, (p0.x + p1.x) / 2.0);
+                        proofPSNUM(proofctx, (p0.y + p1.y) / 2.0);
+                        proofPSOUT(proofctx, "moveto\n");
+                        proofPSNUM(proofctx, (p0.x + 5 * p1.x) / 6.0);
+                        proofPSNUM(proofctx, (p0.y + 5 * p1.y) / 6.0);
                     }
                 }
 
@@ -751,42 +751,36 @@ static void drawPath(GlyphId glyphId, IntX marks, IntX fill) {
                     if (p0.on) {
                         if (p1.on) {
                             /* on on */
-                            workstr[0] = '\0';
-                            snprintf(workstr, WORKSTR_BUF_SIZE, "%d %d lineto\n", p1.x, p1.y);
-                            proofPSOUT(proofctx, workstr);
+                            proofPSNUM(proofctx, p1.x);
+                            proofPSNUM(proofctx, p1.y);
+                            proofPSOUT(proofctx, "lineto\n");
                         } else {
                             /* on off */
-                            workstr[0] = '\0';
-                            snprintf(workstr, WORKSTR_BUF_SIZE, "%g %g ",
-                                    (p0.x + 2 * p1.x) / 3.0,
-                                    (p0.y + 2 * p1.y) / 3.0);
-                            proofPSOUT(proofctx, workstr);
+                            proofPSNUM(proofctx, (p0.x + 2 * p1.x) / 3.0);
+                            proofPSNUM(proofctx, (p0.y + 2 * p1.y) / 3.0);
                         }
                     } else {
                         if (p1.on) {
                             /* off on */
-                            workstr[0] = '\0';
-                            snprintf(workstr, WORKSTR_BUF_SIZE, "%g %g %d %d curveto\n",
-                                    (2 * p0.x + p1.x) / 3.0,
-                                    (2 * p0.y + p1.y) / 3.0, p1.x, p1.y);
-                            proofPSOUT(proofctx, workstr);
+                            proofPSNUM(proofctx, (2 * p0.x + p1.x) / 3.0);
+                            proofPSNUM(proofctx, (2 * p0.y + p1.y) / 3.0);
+                            proofPSNUM(proofctx, p1.x);
+                            proofPSNUM(proofctx, p1.y);
+                            proofPSOUT(proofctx, "curveto\n");
                         } else {
                             /* off off */
                             double x = (p0.x + p1.x) / 2.0;
                             double y = (p0.y + p1.y) / 2.0;
 
-                            workstr[0] = '\0';
-                            snprintf(workstr, WORKSTR_BUF_SIZE, "%g %g %g %g curveto\n",
-                                    (5 * p0.x + p1.x) / 6.0,
-                                    (5 * p0.y + p1.y) / 6.0, x, y);
-                            proofPSOUT(proofctx, workstr);
+                            proofPSNUM(proofctx, (5 * p0.x + p1.x) / 6.0);
+                            proofPSNUM(proofctx, (5 * p0.y + p1.y) / 6.0);
+                            proofPSNUM(proofctx, x);
+                            proofPSNUM(proofctx, y);
+                            proofPSOUT(proofctx, "curveto\n");
                             drawTic(marks, &p0, x, y, &p1);
                             if (nSegs != 0) {
-                                workstr[0] = '\0';
-                                snprintf(workstr, WORKSTR_BUF_SIZE, "%g %g ",
-                                        (p0.x + 5 * p1.x) / 6.0,
-                                        (p0.y + 5 * p1.y) / 6.0);
-                                proofPSOUT(proofctx, workstr);
+                                proofPSNUM(proofctx, (p0.x + 5 * p1.x) / 6.0);
+                                proofPSNUM(proofctx, (p0.y + 5 * p1.y) / 6.0);
                             }
                         }
                     }
@@ -570,10 +570,13 @@ void kernDump(IntX level, LongN start) {
 /* Free format 0 subtable */
 static void free0(Format0 *fmt, Card32 length) {
     IntX i;
-    IntX nPairs = (length - FORMAT0_HDR_SIZE) / PAIR_SIZE(nMasters);
+    IntX nPairs;
 
-    if (nPairs > fmt->nPairs + 1)
+    /* Match the pair count read by read0() */
+    if (length >= SUBTABLE_HDR_SIZE + FORMAT0_HDR_SIZE + (fmt->nPairs + 1) * PAIR_SIZE(1))
         nPairs = fmt->nPairs + 1;
+    else
+        nPairs = fmt->nPairs;
 
     for (i = 0; i < nPairs; i++)
         memFree(fmt->pair[i].value);
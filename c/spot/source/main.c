@@ -5,6 +5,12 @@
 #include <string.h>
 #include <stdlib.h>
 
+#include <errno.h>
+
+#ifndef _WIN32
+#define HAVE_FORK 1
+#endif
+
 #include "global.h"
 #include "sfnt.h"
 #include "sfnt_sfnt.h"
@@ -18,6 +24,7 @@
 #include <ctype.h>
 #include "setjmp.h"
 #include "map.h"
+#include "ctutil.h"
 
 jmp_buf mark;
 #define MAX_ARGS 200
@@ -62,11 +69,7 @@ static char *MakeFullPath(char *source) {
     return dest;
 }
 
-/* File signatures */
-
-typedef Card32 ctlTag;
-#define CTL_TAG(a, b, c, d) \
-    ((ctlTag)(a) << 24 | (ctlTag)(b) << 16 | (ctlTag)(c) << 8 | (ctlTag)(d))
+/* File signatures (ctlTag and CTL_TAG are from ctlshare.h) */
 
 #define sig_PostScript0 CTL_TAG('%', '!', 0x00, 0x00)
 #define sig_PostScript1 CTL_TAG('%', 'A', 0x00, 0x00) /* %ADO... */
@@ -177,7 +180,7 @@ static void printUsage(void) {
             "[-l|-O] "
 #endif
             "[-i<ids>] [-o<offs>] [-t<tags>|-P<featuretags>] [-p<policy>] [-@ <ptsize>]  "
-            "<fontfile>+\n\n"
+            "[-L <listfile>] [-j <n>] <fontfile>*\n\n"
 #if AUTOSCRIPT
             "OR: %s  -X <scriptfile>\n\n"
 #endif
@@ -213,7 +216,10 @@ static void printUsage(void) {
             "        5=Show GlyphBBox on glyph\n"
             "        6=Show Kanji in Vertical writing mode\n"
             "        7=Don't show Kanji 'kern','vkrn' with 'palt','vpal' values applied\n"
+            "        8=Define glyph outlines drawn more than once as PostScript procedures\n"
             "    -@  set proofing glyph point-size (does not apply to certain synopses)\n"
+            "    -L  also process the fonts listed in <listfile>, one per line\n"
+            "    -j  process fonts with <n> parallel worker processes\n"
 #if AUTOSCRIPT
             "    -X  execute a series of complete command-lines from <scriptfile> [default: OTFproof.scr ]\n"
 #endif
@@ -287,7 +293,16 @@ static void showHelp(void) {
         "dumping of selected tables by setting their dump level to 0, e.g.\n"
         "-tuset,glyf=0,hdmx.\n"
         "\n"
-        "The -ht option provides additional table-specific help.\n");
+        "The -ht option provides additional table-specific help.\n"
+        "\n"
+        "The -L option reads further font filenames from a file, one per line;\n"
+        "blank lines and lines beginning with '#' are ignored. The same options\n"
+        "are applied to every font. The -j option shares the fonts out among\n"
+        "<n> parallel worker processes; the output is printed in the same order\n"
+        "as without -j. With either option the time taken by each font and a\n"
+        "throughput summary are reported. -j is ignored on Windows. Proof files\n"
+        "are named after each font, or after the -of base followed by _1, _2,\n"
+        "etc. in list order when there are several fonts.\n");
 
     quit(0);
 }
@@ -1034,6 +1049,156 @@ void initotfprooflib(void)
 
 #endif /* EXECUTABLE*/
 
+/* ------------------------------- Batch Mode ------------------------------- */
+
+static int workers = 1;            /* Max concurrent worker processes (-j) */
+static char *fontlistname = NULL;  /* Font list file (-L) */
+static da_DCL(Byte8 *, fontnames); /* Fonts to process */
+static Byte8 **proofbases;         /* Proof file base name for each font */
+
+static struct /* Batch throughput */
+{
+    IntX report;  /* Report per-font timing and throughput (-L or -j) */
+    IntX fonts;   /* Fonts processed */
+    double bytes; /* Total font bytes */
+    double start; /* Start time */
+} batch;
+
+/* Add the fonts named in list file to the font list. Blank lines and lines
+   beginning with '#' are skipped */
+static void readFontList(Byte8 *listname) {
+    char line[512];
+    FILE *fp = fopen(listname, "r");
+
+    if (fp == NULL)
+        fatal(SPOT_MSG_BADFONTLIST, listname);
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        char *p = line;
+        char *end;
+
+        while (isspace((unsigned char)*p))
+            p++;
+        end = p + strlen(p);
+        while (end > p && isspace((unsigned char)end[-1]))
+            end--;
+        *end = '\0';
+        if (*p == '\0' || *p == '#')
+            continue;
+        *da_NEXT(fontnames) = strcpy(memNew(end - p + 1), p);
+    }
+    fclose(fp);
+}
+
+/* Choose the base name of each font's proof files: the font's filename, or
+   the -of base, numbered by list position when there are several fonts. This
+   is done before any font is dumped so that the names don't depend on which
+   worker dumps which font, or in what order. */
+static void makeProofBases(IntX files) {
+    IntX i;
+
+    proofbases = (Byte8 **)memNew(files * sizeof(Byte8 *));
+    for (i = 0; i < files; i++) {
+        if (outputfilebase == NULL) {
+            proofbases[i] = fontnames.array[i];
+        } else if (files == 1) {
+            proofbases[i] = outputfilebase;
+        } else {
+            proofbases[i] = (Byte8 *)memNew(strlen(outputfilebase) + 12);
+            sprintf(proofbases[i], "%s_%d", outputfilebase, (int)(i + 1));
+        }
+    }
+}
+
+/* Dump font "i" of the font list. Return 1 if the file was recognized,
+   else 0 */
+static IntX dumpFont(IntX i, IntX files) {
+    Byte8 *filename = fontnames.array[i];
+    double start = ctuWallTime();
+    Card32 length;
+
+    outputfilebase = proofbases[i];
+
+    if (files > 1) {
+        fprintf(stderr, "Proofing %s.\n", filename);
+        fflush(stderr);
+    }
+
+    fileOpen(filename);
+    if (!fileIsOpened()) {
+        warning(SPOT_MSG_BADFILE, filename);
+        fileClose();
+        return 0;
+    }
+    length = fileLength();
+    if (readFile(filename)) {
+        fileClose();
+        return 0;
+    }
+    fileClose();
+
+    if (batch.report) {
+        fflush(OUTPUTBUFF);
+        message(SPOT_MSG_FONTTIME, filename, length / 1024.0,
+                ctuWallTime() - start);
+    }
+    batch.fonts++;
+    batch.bytes += length;
+    return 1;
+}
+
+/* Report batch throughput */
+static void reportThroughput(IntX nWorkers) {
+    double secs = ctuWallTime() - batch.start;
+    double mb = batch.bytes / (1024.0 * 1024.0);
+
+    message(SPOT_MSG_THROUGHPUT, batch.fonts, mb, secs,
+            secs > 0 ? mb / secs : 0.0, nWorkers);
+}
+
+#if HAVE_FORK
+/* The fonts are shared out among forked worker processes (see ctuRunJobs()),
+   each of which therefore has its own copy of the table state. As in a serial
+   run, a fatal error stops the output after the failed font. */
+
+typedef struct { /* Result of font dumped by a worker */
+    IntX good;    /* Font was recognized */
+    double bytes; /* Font length */
+} FontResult;
+
+/* Dump font "index" in a worker process */
+static void CTL_CDECL dumpFontJob(long index, void *result, void *ctx) {
+    FontResult *res = (FontResult *)result;
+    double bytes = batch.bytes;
+
+    res->good = dumpFont((IntX)index, *(IntX *)ctx);
+    res->bytes = batch.bytes - bytes;
+}
+
+/* Dump the fonts in "nWorkers" parallel worker processes and print the output
+   in list order. Return the number of fonts recognized */
+static IntX dumpFonts(IntX cnt, IntX nWorkers) {
+    FontResult *results = (FontResult *)memNew(cnt * sizeof(FontResult));
+    IntX good = 0;
+    long done;
+    long i;
+
+    fflush(OUTPUTBUFF);
+    done = ctuRunJobs(cnt, nWorkers, 0, dumpFontJob, sizeof(FontResult),
+                      results, &cnt);
+    if (done < 0)
+        fatal(SPOT_MSG_WORKERFAIL, strerror(errno));
+    for (i = 0; i < done; i++) {
+        good += results[i].good;
+        batch.fonts += results[i].good;
+        batch.bytes += results[i].bytes;
+    }
+    memFree(results);
+    if (done < cnt)
+        exit(1);
+    return good;
+}
+#endif /* HAVE_FORK */
+
 /* Main program */
 IntN main(IntN argc, Byte8 *argv[]) {
     IntX value = 0;
@@ -1078,9 +1243,11 @@ IntN main(IntN argc, Byte8 *argv[]) {
 #endif
         {"-ag", opt_String, &glyphaliasfilename},
         {"-of", opt_String, &outputfilebase},
+        {"-L", opt_String, &fontlistname},
+        {"-j", opt_Int, &workers, "1", 1, 256},
     };
 
-    IntX files, goodFileCount = 0;
+    IntX files, nWorkers, goodFileCount = 0;
     IntN argi;
     Byte8 *filename = NULL;
     volatile IntX i = 0;
@@ -1154,33 +1321,29 @@ IntN main(IntN argc, Byte8 *argv[]) {
         if (opt_Present("-ngid"))
             global.flags |= SUPPRESS_GID_IN_NAME;
 
-        files = argc - argi;
-
-        for (; argi < argc; argi++) {
-            filename = argv[argi];
-
-            if (files > 1) {
-                fprintf(stderr, "Proofing %s.\n", filename);
-                fflush(stderr);
-            }
-
-            if (outputfilebase == NULL)
-                outputfilebase = filename;
-            fileOpen(filename);
-
-            if (!fileIsOpened()) {
-                warning(SPOT_MSG_BADFILE, filename);
-                fileClose();
-                continue;
-            }
-            if (readFile(filename)) {
-                fileClose();
-                continue;
-            }
+        da_INIT(fontnames, 100, 100);
+        for (; argi < argc; argi++)
+            *da_NEXT(fontnames) = argv[argi];
+        if (opt_Present("-L"))
+            readFontList(fontlistname);
+        files = fontnames.cnt;
+
+        batch.report = opt_Present("-L") || opt_Present("-j");
+        batch.start = ctuWallTime();
+        makeProofBases(files);
+
+        nWorkers = 1;
+#if HAVE_FORK
+        if (workers > 1 && files > 1) {
+            nWorkers = (workers < files) ? workers : files;
+            goodFileCount = dumpFonts(files, nWorkers);
+        } else
+#endif
+            for (i = 0; i < files; i++)
+                goodFileCount += dumpFont(i, files);
 
-            goodFileCount++;
-            fileClose();
-        }
+        if (batch.report)
+            reportThroughput(nWorkers);
     }
 #if AUTOSCRIPT
     else /* executing cmdlines from a script file */
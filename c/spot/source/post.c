@@ -19,6 +19,7 @@ static Byte8 *applestd[] =
 #define STD_LENGTH TABLE_LEN(applestd)
 #define MAX_STD_INDEX (STD_LENGTH - 1)
 static IntX nNames;
+static Card8 **nameIndex; /* Format 2.0 name pointers [nNames] */
 static Card16 nGlyphs;
 
 static Format2_0 *read2_0(Card32 left) {
@@ -52,6 +53,14 @@ static Format2_0 *read2_0(Card32 left) {
         else
             nNames++;
 
+    /* Index names so lookups needn't walk the table */
+    nameIndex = memNew(sizeof(nameIndex[0]) * (nNames + 1));
+    name = format->names;
+    for (i = 0; i < nNames; i++) {
+        nameIndex[i] = name;
+        name += *name + 1;
+    }
+
     return format;
 }
 
@@ -158,10 +167,15 @@ static Byte8 *getName2_0(Format2_0 *format, GlyphId glyphId, IntX *length) {
             name = applestd[0];
             *length = strlen(name);
         } else if (index > (long)MAX_STD_INDEX) {
-            IntX i;
-            name = (Byte8 *)format->names;
-            for (i = 0; i < index - (IntX)STD_LENGTH; i++)
-                name += *name + 1;
+            IntX i = index - (IntX)STD_LENGTH;
+            if (i < nNames)
+                name = (Byte8 *)nameIndex[i];
+            else {
+                /* Past last name; walk table as before */
+                name = (Byte8 *)format->names;
+                for (i = 0; i < index - (IntX)STD_LENGTH; i++)
+                    name += *name + 1;
+            }
             *length = *name++;
         } else {
             name = applestd[index];
@@ -318,6 +332,8 @@ void postDump(IntX level, LongN start) {
 }
 
 static void free2_0(Format2_0 *format) {
+    memFree(nameIndex);
+    nameIndex = NULL;
     memFree(format->glyphNameIndex);
     memFree(format->names);
     memFree(format);
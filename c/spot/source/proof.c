@@ -9,6 +9,17 @@
 #include <time.h>
 #endif
 #include <string.h>
+#include <math.h>
+#if AUTOSPOOL
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#endif
 #if MACINTOSH
 #include <Carbon.h>
 #include <Memory.h>
@@ -29,13 +40,14 @@
 #include "name.h"
 #include "OS_2.h"
 #include "sfnt.h"
+#include "da.h"
 
 #if SUNOS
 extern int fputs(const char *s, FILE *stream);
 #if AUTOSPOOL
 extern int system(const char *command);
 extern char *getenv(const char *name);
-extern char *mktemp(char *template);
+extern int mkstemp(char *template);
 
 #endif
 #endif
@@ -45,6 +57,21 @@ extern char *outputfilebase;
 #include "proof.h"
 #include "sys.h" /* sysOurtime() */
 
+typedef struct { /* Cached glyph path */
+    Card32 offset; /* Offset of path text in pathtext */
+    Card32 length; /* Length of path text */
+    Card16 page;   /* Page on which path was defined as a procedure */
+    Card8 state;   /* PATH_UNSEEN, PATH_CACHED, or PATH_DEFINED */
+} ProofPath;
+#define PATH_UNSEEN 0
+#define PATH_CACHED 1  /* Text cached */
+#define PATH_DEFINED 2 /* Text also defined as PostScript procedure */
+
+/* Limit on total cached path text, and on the text of a path that is defined
+   as a procedure (keeps the procedure within the 65535-element array limit) */
+#define MAX_PATHTEXT (16 * 1024 * 1024L)
+#define MAX_PATHPROC (64 * 1024L)
+
 typedef struct _ProofContext {
     proofOutputType kind;
     double left, right, top, bottom; /* of imageable area */
@@ -59,6 +86,9 @@ typedef struct _ProofContext {
     Byte8 onNewLine; /*To avoid unnecessary line feeds */
     FILE *psfileptr;
     Int16 bbLeft, bbBottom, bbRight, bbTop;
+    da_DCL(ProofPath, paths); /* Glyph paths; indexed by glyph id */
+    da_DCL(Byte8, pathtext);  /* Cached glyph path text */
+    Byte8 recording;          /* Copy output to pathtext */
 
 #if MACINTOSH
     PMPrintSession printSession;
@@ -112,6 +142,7 @@ static IntX PolicyKanjiGlyphBBox = 0;
 static IntX PolicyKanjiVertical = 0;
 static IntX tempPolicyKanjiVertical = 0;
 static IntX PolicyKanjiKernAltMetrics = 1;
+static IntX PolicyGlyphProcs = 0;
 
 static Byte8 PSProlog[] = "\n%%BeginPageSetup\n/_MT{moveto}bind def /_LT{lineto}bind def\n/_CT{curveto}bind def /_CP{closepath}bind def\n/_SP{save /Courier-Bold findfont 8 scalefont setfont 20 20 moveto restore showpage}bind def\n%%EndPageSetup\n";
 
@@ -149,6 +180,10 @@ void proofSetGlyphSize(double siz) {
 
 void proofPSOUT(ProofContextPtr ctx, const Byte8 *cmd) {
     if (ctx->kind == proofPS) {
+        if (ctx->recording) {
+            size_t length = strlen(cmd);
+            memcpy(da_EXTEND(ctx->pathtext, length), cmd, length);
+        }
         if (ctx->psfileptr != NULL)
             fputs(cmd, ctx->psfileptr);
 #if AUTOSPOOL
@@ -189,6 +224,93 @@ void proofPSOUT(ProofContextPtr ctx, const Byte8 *cmd) {
     }
 }
 
+/* Format value into buf exactly as sprintf "%g" would and return a pointer to
+   the terminating null. Integers and values with up to 6 significant digits in
+   the fixed-point range of "%g" are formatted directly, avoiding the cost of
+   the general conversion for the bulk of proof coordinates. */
+Byte8 *proofFmtNum(Byte8 *buf, double value) {
+    static const double pow10[] = {
+        1e-4, 1e-3, 1e-2, 1e-1, 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+    Byte8 digits[12];
+    Byte8 *p = buf;
+    double a = fabs(value);
+    unsigned long n;
+    IntX nDigits;
+    IntX e;
+
+    if (a < 1e6 && a == (unsigned long)a && !(a == 0 && signbit(value))) {
+        /* Integer */
+        n = (unsigned long)a;
+        if (value < 0)
+            *p++ = '-';
+        nDigits = 0;
+        do {
+            digits[nDigits++] = (Byte8)('0' + n % 10);
+            n /= 10;
+        } while (n != 0);
+        while (nDigits > 0)
+            *p++ = digits[--nDigits];
+        *p = '\0';
+        return p;
+    }
+
+    if (a >= 1e-4 && a < 1e6) {
+        /* Round to 6 significant digits */
+        double scaled;
+        double frac;
+
+        for (e = 5; a < pow10[e + 4]; e--)
+            ;
+        scaled = a * pow10[(5 - e) + 4];
+        n = (unsigned long)scaled;
+        frac = scaled - n;
+        if (fabs(frac - 0.5) > 1e-6) {
+            if (frac > 0.5)
+                n++;
+            if (n >= 100000 && n < 1000000) {
+                IntX i;
+                IntX point = e + 1; /* Digits before the decimal point */
+
+                for (i = 5; i >= 0; i--) {
+                    digits[i] = (Byte8)('0' + n % 10);
+                    n /= 10;
+                }
+                for (nDigits = 6; nDigits > 1 && nDigits > point && digits[nDigits - 1] == '0'; nDigits--)
+                    ;
+                if (value < 0)
+                    *p++ = '-';
+                if (point <= 0) {
+                    *p++ = '0';
+                    *p++ = '.';
+                    for (i = point; i < 0; i++)
+                        *p++ = '0';
+                    point = -1; /* Point already written */
+                }
+                for (i = 0; i < nDigits; i++) {
+                    if (i == point)
+                        *p++ = '.';
+                    *p++ = digits[i];
+                }
+                *p = '\0';
+                return p;
+            }
+        }
+    }
+
+    /* Exponent form, or too close to a rounding tie to decide here */
+    return p + sprintf(p, "%g", value);
+}
+
+/* Write value, formatted as "%g", followed by a space */
+void proofPSNUM(ProofContextPtr ctx, double value) {
+    Byte8 str[32];
+    Byte8 *end = proofFmtNum(str, value);
+
+    end[0] = ' ';
+    end[1] = '\0';
+    proofPSOUT(ctx, str);
+}
+
 static void proofPageProlog(ProofContextPtr ctx) {
     char *platformProlog;
 
@@ -375,8 +497,9 @@ static void advance(ProofContextPtr ctx, Int16 wx) { /* in absolute Page-space c
         ctx->currx += FNT2ABS(wx);
     }
     checkNewline(ctx);
-    sprintf(g_str, "%g %g _MT\n", ctx->currx, ctx->curry);
-    proofPSOUT(ctx, g_str);
+    proofPSNUM(ctx, ctx->currx);
+    proofPSNUM(ctx, ctx->curry);
+    proofPSOUT(ctx, "_MT\n");
 }
 
 void proofCheckAdvance(ProofContextPtr ctx, Int16 wx) {
@@ -400,8 +523,9 @@ static void advanceSYM(ProofContextPtr ctx, Int16 wx) { /* in absolute Page-spac
         ctx->currx += (wx / 1000.0) * ctx->glyphSize;
 
     checkNewline(ctx);
-    sprintf(g_str, "%g %g _MT\n", ctx->currx, ctx->curry);
-    proofPSOUT(ctx, g_str);
+    proofPSNUM(ctx, ctx->currx);
+    proofPSNUM(ctx, ctx->curry);
+    proofPSOUT(ctx, "_MT\n");
 }
 
 void proofThinspace(ProofContextPtr ctx, IntX count) {
@@ -475,7 +599,7 @@ void proofMessage(ProofContextPtr ctx, Byte8 *str) {
                 if (tLen > kMaxMessageLength) {
                     strncpy(temp, &str[nPos], kMaxMessageLength);
                     nPos += kMaxMessageLength;
-                    temp[nPos] = 0;
+                    temp[kMaxMessageLength] = 0;
                 } else {
                     strcpy(temp, &str[nPos]);
                     nPos = nLen;
@@ -586,18 +710,25 @@ static void proofGlyphStart(ProofContextPtr ctx, GlyphId glyphid, Byte8 *glyphna
 }
 
 void proofGlyphMT(ProofContextPtr ctx, double x, double y) {
-    sprintf(g_str, "%g %g _MT\n", x, y);
-    proofPSOUT(ctx, g_str);
+    proofPSNUM(ctx, x);
+    proofPSNUM(ctx, y);
+    proofPSOUT(ctx, "_MT\n");
 }
 
 void proofGlyphLT(ProofContextPtr ctx, double x, double y) {
-    sprintf(g_str, "%g %g _LT\n", x, y);
-    proofPSOUT(ctx, g_str);
+    proofPSNUM(ctx, x);
+    proofPSNUM(ctx, y);
+    proofPSOUT(ctx, "_LT\n");
 }
 
 void proofGlyphCT(ProofContextPtr ctx, double x1, double y1, double x2, double y2, double x3, double y3) {
-    sprintf(g_str, "%g %g %g %g %g %g _CT\n", x1, y1, x2, y2, x3, y3);
-    proofPSOUT(ctx, g_str);
+    proofPSNUM(ctx, x1);
+    proofPSNUM(ctx, y1);
+    proofPSNUM(ctx, x2);
+    proofPSNUM(ctx, y2);
+    proofPSNUM(ctx, x3);
+    proofPSNUM(ctx, y3);
+    proofPSOUT(ctx, "_CT\n");
 }
 
 void proofGlyphClosePath(ProofContextPtr ctx) {
@@ -675,6 +806,8 @@ void proofDestroyContext(ProofContextPtr *ctxptr) {
 
     if ((*ctxptr)->title2)
         memFree((*ctxptr)->title2);
+    da_FREE((*ctxptr)->paths);
+    da_FREE((*ctxptr)->pathtext);
     memFree(*ctxptr);
     *ctxptr = NULL;
 }
@@ -805,6 +938,25 @@ int getIdeoEmbox(Int16 *Left, Int16 *Bottom, Int16 *Right, Int16 *Top) {
 
 extern Byte8 *getthedate(void);
 
+#if AUTOSPOOL && (WIN32 || OSX)
+/* Create proof file "name" and open it for writing. The file is created
+   exclusively, so concurrent spot processes (e.g. -j workers) never write the
+   same proof. Return NULL if the file already exists. */
+static FILE *proofCreate(char *name) {
+    FILE *fp;
+    int fd = open(name, O_WRONLY | O_CREAT | O_EXCL, 0666);
+
+    if (fd == -1) {
+        if (errno != EEXIST)
+            fatal(SPOT_MSG_prufNOOPENF);
+        return NULL;
+    }
+    if ((fp = fdopen(fd, "w")) == NULL)
+        fatal(SPOT_MSG_prufNOOPENF);
+    return fp;
+}
+#endif
+
 ProofContextPtr proofInitContext(proofOutputType where,
                                  Card32 leftposit, Card32 rightposit,
                                  Card32 topposit, Card32 botposit,
@@ -841,6 +993,8 @@ ProofContextPtr proofInitContext(proofOutputType where,
     ctx->page = 0;
     ctx->title = NULL;
     ctx->title2 = NULL;
+    da_INIT(ctx->paths, 0, 1000);
+    da_INIT(ctx->pathtext, 0, 64 * 1024);
 
     if (!opt_Present("-d")) {
         /* Set up first line of title = font names + head fontRevision version number. */
@@ -953,7 +1107,7 @@ ProofContextPtr proofInitContext(proofOutputType where,
                         sprintf(tempname, "%s_%s.ps", outputfilebase, PSFilenameorPATTorNULL);
                     else
                         sprintf(tempname, "OTFproof_%s.ps", PSFilenameorPATTorNULL);
-                    while (sysFileExists(tempname)) {
+                    while ((ctx->psfileptr = proofCreate(tempname)) == NULL) {
                         if (outputfilebase)
                             sprintf(tempname, "%s_%s%d.ps", outputfilebase, PSFilenameorPATTorNULL, retries);
                         else
@@ -963,26 +1117,22 @@ ProofContextPtr proofInitContext(proofOutputType where,
                     len = strlen(tempname);
                     ctx->psfilename = memNew(sizeof(Byte8) * (len + 1));
                     strcpy(ctx->psfilename, tempname);
-                    if ((ctx->psfileptr = fopen(tempname, "w")) == (FILE *)NULL)
-                        fatal(SPOT_MSG_prufNOOPENF);
                 } else { /* whole thing is specified */
                     strcpy(tempname, PSFilenameorPATTorNULL);
-                    while (sysFileExists(tempname)) {
+                    while ((ctx->psfileptr = proofCreate(tempname)) == NULL) {
                         sprintf(tempname, "%s%d", PSFilenameorPATTorNULL, retries);
                         retries++;
                     }
                     len = strlen(tempname);
                     ctx->psfilename = memNew(sizeof(Byte8) * (len + 1));
                     strcpy(ctx->psfilename, tempname);
-                    if ((ctx->psfileptr = fopen(tempname, "w")) == (FILE *)NULL)
-                        fatal(SPOT_MSG_prufNOOPENF);
                 }
             } else {
                 if (outputfilebase)
                     sprintf(tempname, "%s.ps", outputfilebase);
                 else
                     strcpy(tempname, "OTFproof.ps");
-                while (sysFileExists(tempname)) {
+                while ((ctx->psfileptr = proofCreate(tempname)) == NULL) {
                     if (outputfilebase)
                         sprintf(tempname, "%s.ps%d", outputfilebase, retries);
                     else
@@ -992,8 +1142,6 @@ ProofContextPtr proofInitContext(proofOutputType where,
                 len = strlen(tempname);
                 ctx->psfilename = memNew(sizeof(Byte8) * (len + 1));
                 strcpy(ctx->psfilename, tempname);
-                if ((ctx->psfileptr = fopen(tempname, "w")) == (FILE *)NULL)
-                    fatal(SPOT_MSG_prufNOOPENF);
             }
             ctx->winPrinterDC = NULL; /* very important */
             inform(SPOT_MSG_prufPREPPS);
@@ -1035,7 +1183,7 @@ ProofContextPtr proofInitContext(proofOutputType where,
                     else
                         sprintf(tempname, "OTFproof_%s.ps", PSFilenameorPATTorNULL);
 
-                    while (sysFileExists(tempname)) {
+                    while ((ctx->psfileptr = proofCreate(tempname)) == NULL) {
                         if (outputfilebase)
                             sprintf(tempname, "%s_%s%d.ps", outputfilebase, PSFilenameorPATTorNULL, retries);
                         else
@@ -1045,8 +1193,6 @@ ProofContextPtr proofInitContext(proofOutputType where,
                     len = strlen(tempname);
                     ctx->psfilename = memNew(sizeof(Byte8) * (len + 1));
                     strcpy(ctx->psfilename, tempname);
-                    if ((ctx->psfileptr = fopen(tempname, "w")) == (FILE *)NULL)
-                        fatal(SPOT_MSG_prufNOOPENF);
                 } else { /* whole thing is specified */
                     len = strlen(PSFilenameorPATTorNULL);
                     ctx->psfilename = memNew(sizeof(Byte8) * (len + 1));
@@ -1061,7 +1207,7 @@ ProofContextPtr proofInitContext(proofOutputType where,
                     sprintf(tempname, "%s.ps", outputfilebase);
                 else
                     strcpy(tempname, "OTFproof.ps");
-                while (sysFileExists(tempname)) {
+                while ((ctx->psfileptr = proofCreate(tempname)) == NULL) {
                     if (outputfilebase)
                         sprintf(tempname, "%s%d.ps", outputfilebase, retries);
                     else
@@ -1071,8 +1217,6 @@ ProofContextPtr proofInitContext(proofOutputType where,
                 len = strlen(tempname);
                 ctx->psfilename = memNew(sizeof(Byte8) * (len + 1));
                 strcpy(ctx->psfilename, tempname);
-                if ((ctx->psfileptr = fopen(tempname, "w")) == (FILE *)NULL)
-                    fatal(SPOT_MSG_prufNOOPENF);
                 /*fprintf(stderr, "Proof file is %n", ctx->psfilename);*/
             }
         }
@@ -1086,13 +1230,14 @@ ProofContextPtr proofInitContext(proofOutputType where,
             if (PSFilenameorPATTorNULL && PSFilenameorPATTorNULL[0] != '\0') {
                 if (isPatt) {
                     char tempname[MAX_NAME_LEN];
+                    int fd;
                     sprintf(tempname, "/tmp/%s_%s_XXXXXX", global.progname, PSFilenameorPATTorNULL);
-                    mktemp(tempname);
+                    if ((fd = mkstemp(tempname)) == -1 ||
+                        (ctx->psfileptr = fdopen(fd, "w")) == (FILE *)NULL)
+                        fatal(SPOT_MSG_prufNOOPENF);
                     len = strlen(tempname);
                     ctx->psfilename = memNew(sizeof(Byte8) * (len + 1));
                     strcpy(ctx->psfilename, tempname);
-                    if ((ctx->psfileptr = fopen(tempname, "w")) == (FILE *)NULL)
-                        fatal(SPOT_MSG_prufNOOPENF);
                     /*fprintf(stderr, "Proof file is %n", tempname);*/
                 } else { /* whole thing is specified */
                     len = strlen(PSFilenameorPATTorNULL);
@@ -1104,13 +1249,14 @@ ProofContextPtr proofInitContext(proofOutputType where,
                 }
             } else {
                 char tempname[MAX_NAME_LEN];
+                int fd;
                 sprintf(tempname, "/tmp/%s.ps_XXXXXX", global.progname);
-                mktemp(tempname);
+                if ((fd = mkstemp(tempname)) == -1 ||
+                    (ctx->psfileptr = fdopen(fd, "w")) == (FILE *)NULL)
+                    fatal(SPOT_MSG_prufNOOPENF);
                 len = strlen(tempname);
                 ctx->psfilename = memNew(sizeof(Byte8) * (len + 1));
                 strcpy(ctx->psfilename, tempname);
-                if ((ctx->psfileptr = fopen(tempname, "w")) == (FILE *)NULL)
-                    fatal(SPOT_MSG_prufNOOPENF);
                 /*fprintf(stderr, "Proof file is %n", ctx->psfilename);*/
             }
         }
@@ -1352,6 +1498,76 @@ static void drawHorzLine(ProofContextPtr ctx, FWord Ypos, FWord oldYpos, Card16
 #undef YCOORD
 }
 
+/* Draw glyph path. Glyphs are typically drawn many times in layout proofs, so
+   the text of each path is cached on first use and then copied to the output
+   instead of being interpreted and formatted again. With policy 8 a path that
+   is drawn again is defined as a PostScript procedure, which later uses just
+   call. */
+static void proofGlyphPath(ProofContextPtr ctx, GlyphId glyphId) {
+    ProofPath *path;
+
+    if (ctx->kind != proofPS || ctx->psfileptr == NULL)
+        goto draw; /* Spooled output is not cached */
+
+    if (glyphId >= ctx->paths.cnt) {
+        long n = glyphId + 1 - ctx->paths.cnt;
+        memset(da_EXTEND(ctx->paths, n), 0, n * sizeof(ProofPath));
+    }
+    path = &ctx->paths.array[glyphId];
+
+    switch (path->state) {
+        case PATH_UNSEEN:
+            if (ctx->pathtext.cnt >= MAX_PATHTEXT)
+                break; /* Cache full; draw without caching */
+            path->offset = ctx->pathtext.cnt;
+            ctx->recording = 1;
+            if (glyfLoaded())
+                glyfProofGlyph(glyphId, (void *)ctx);
+            else if (CFF_Loaded())
+                CFF_ProofGlyph(glyphId, (void *)ctx);
+            ctx->recording = 0;
+
+            /* A CFF path with no moveto draws differently depending on the
+               glyph drawn before it, so keep only paths that have one */
+            *da_NEXT(ctx->pathtext) = '\0';
+            ctx->pathtext.cnt--;
+            if (strstr(&ctx->pathtext.array[path->offset], "_MT") == NULL) {
+                ctx->pathtext.cnt = path->offset;
+                return;
+            }
+            path->length = ctx->pathtext.cnt - path->offset;
+            path->state = PATH_CACHED;
+            return;
+        case PATH_DEFINED:
+            if (path->page == ctx->page) {
+                sprintf(g_str, "_G%hu\n", glyphId);
+                proofPSOUT(ctx, g_str);
+                return;
+            }
+            /* Procedures are defined again on each page using them so that
+               pages remain independent */
+            /* Fall through */
+        case PATH_CACHED:
+            if (PolicyGlyphProcs && path->length <= MAX_PATHPROC) {
+                sprintf(g_str, "/_G%hu{\n", glyphId);
+                proofPSOUT(ctx, g_str);
+                fwrite(&ctx->pathtext.array[path->offset], 1, path->length, ctx->psfileptr);
+                sprintf(g_str, "}bind def _G%hu\n", glyphId);
+                proofPSOUT(ctx, g_str);
+                path->page = ctx->page;
+                path->state = PATH_DEFINED;
+            } else
+                fwrite(&ctx->pathtext.array[path->offset], 1, path->length, ctx->psfileptr);
+            return;
+    }
+
+draw:
+    if (glyfLoaded())
+        glyfProofGlyph(glyphId, (void *)ctx);
+    else if (CFF_Loaded())
+        CFF_ProofGlyph(glyphId, (void *)ctx);
+}
+
 void proofDrawGlyph(ProofContextPtr ctx,
                     GlyphId glyphId, Card16 glyphflags,
                     Byte8 *glyphname, Card16 glyphnameflags,
@@ -1405,11 +1621,7 @@ void proofDrawGlyph(ProofContextPtr ctx,
         proofPSOUT(ctx, g_str);
     }
 
-    if (glyfLoaded()) {
-        glyfProofGlyph(glyphId, (void *)ctx);
-    } else if (CFF_Loaded()) {
-        CFF_ProofGlyph(glyphId, (void *)ctx);
-    }
+    proofGlyphPath(ctx, glyphId);
 
     if (originDx || originDy || DEFAULT_YORIG_KANJI != yOrigKanji) {
         proofPSOUT(ctx, "fill grestore %%originDelta\n");
@@ -1630,6 +1842,9 @@ void proofSetPolicy(IntX policyNum, IntX value) {
         case 7:
             PolicyKanjiKernAltMetrics = value;
             break;
+        case 8:
+            PolicyGlyphProcs = value;
+            break;
         default:
             break;
     }
@@ -1660,6 +1875,7 @@ void proofResetPolicies(void) {
     PolicyKanjiGlyphBBox = 0;
     PolicyKanjiVertical = 0;
     PolicyKanjiKernAltMetrics = 1;
+    PolicyGlyphProcs = 0;
 }
 
 IdList policies;
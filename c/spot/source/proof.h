@@ -124,6 +124,8 @@ extern void proofGlyphCT(ProofContextPtr c, double x1, double y1, double x2, dou
 extern void proofGlyphClosePath(ProofContextPtr c);
 
 extern void proofPSOUT(ProofContextPtr c, const Byte8 *cmd);
+extern void proofPSNUM(ProofContextPtr c, double value);
+extern Byte8 *proofFmtNum(Byte8 *buf, double value);
 
 #define STDPAGE_MARGIN  36
 #define STDPAGE_WIDTH   612
@@ -767,6 +767,7 @@ static void freeTables(void) {
     for (i = 0; i < TABLE_LEN(function); i++)
         if (function[i].free != NULL)
             function[i].free();
+    resetGlyphNames();
 }
 
 /* Process tables */
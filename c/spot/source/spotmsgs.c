@@ -111,6 +111,10 @@ const Byte8 *EnglishMessages[] =
         "proof and feature file format dumps do not support recursive calls to contextual lookups. context format %d.\n",  /* SPOT_MSG_CNTX_RECURSION */
         "Duplicate glyph in coverage Type1. gid: '%d'.\n",                                                                 /* SPOT_MSG_DUP_IN_COV */
         "Cannot proof multiple inputs with more than one group greater than 1. Not all substitutions may be displayed.\n", /* SPOT_MSG_GSUBMULTIPLEINPUTS */
+        "can't read font list [%s]\n",                                                                                     /* SPOT_MSG_BADFONTLIST */
+        "can't start worker processes <%s>\n",                                                                             /* SPOT_MSG_WORKERFAIL */
+        "%s (%.1f KB) in %.3f sec\n",                                                                                      /* SPOT_MSG_FONTTIME */
+        "processed %d fonts (%.1f MB) in %.3f sec (%.1f MB/sec, %d workers)\n",                                            /* SPOT_MSG_THROUGHPUT */
 };
 
 const Byte8 *spotMsg(IntX msgId) {
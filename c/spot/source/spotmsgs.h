@@ -112,6 +112,10 @@ extern const Byte8 *spotMsg(IntX msgId);
 #define SPOT_MSG_CNTX_RECURSION     102
 #define SPOT_MSG_DUP_IN_COV         103
 #define SPOT_MSG_GSUBMULTIPLEINPUTS 104
+#define SPOT_MSG_BADFONTLIST        105
+#define SPOT_MSG_WORKERFAIL         106
+#define SPOT_MSG_FONTTIME           107
+#define SPOT_MSG_THROUGHPUT         108
 
-#define SPOT_MSG_ENDSENTINEL SPOT_MSG_GSUBMULTIPLEINPUTS
+#define SPOT_MSG_ENDSENTINEL SPOT_MSG_THROUGHPUT
 #endif
@@ -25,6 +25,12 @@
 #define READ  read
 #endif
 
+#if !(MSDOS || WIN32 || MACINTOSH)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define HAVE_MMAP 1
+#endif
+
 #if OSX
 #include <sys/time.h>
 #else
@@ -126,6 +132,32 @@ IntX sysRead(IntX fd, Card8 *buf, IntX size, Byte8 *filename) {
     return count;
 }
 
+/* Map whole file read-only; return NULL if mapping isn't possible, in which
+   case the caller falls back to buffered reads */
+Card8 *sysMap(IntX fd, Card32 *length) {
+#if HAVE_MMAP
+    struct stat st;
+    void *base;
+
+    if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_size == 0 ||
+        (Card32)st.st_size != st.st_size)
+        return NULL;
+    base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (base == MAP_FAILED)
+        return NULL;
+    *length = (Card32)st.st_size;
+    return base;
+#else
+    return NULL;
+#endif
+}
+
+void sysUnmap(Card8 *base, Card32 length) {
+#if HAVE_MMAP
+    munmap(base, length);
+#endif
+}
+
 Byte8 ourtday[32];
 
 Byte8 *sysOurtime(void) {
@@ -19,6 +19,8 @@ Int32 sysTell(IntX fd, Byte8 *filename);
 void sysSeek(IntX fd, Int32 offset, IntX relative, Byte8 *filename);
 Int32 sysFileLen(IntX fd);
 IntX sysRead(IntX fd, Card8 *buf, IntX size, Byte8 *filename);
+Card8 *sysMap(IntX fd, Card32 *length);
+void sysUnmap(Card8 *base, Card32 length);
 Byte8 *sysOurtime(void);
 #if MACINTOSH
 IntX sysOpenMac(Byte8 *OUTfilename);
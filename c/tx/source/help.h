@@ -31,6 +31,11 @@
 "option, e.g -U 365,500. If the -U option is not specified the default instance\n"
 "recorded within the font is used.\n"
 "\n"
+"Repeating the -U option, e.g. -U 365,500 -U 600,0, makes one font for each\n"
+"instance, in option order, as if the source held one font per instance. The -U\n"
+"options given after a font file has been read start a new list. A multiple\n"
+"master font is parsed once and switched to each instance in turn.\n"
+"\n"
 "If the input font is an FFIL or a TTC containing multiple sfnts, a contents\n",
 "list is displayed from which a specific sfnt may be selected using the -i\n"
 "(index) option or every font may be selected using the -y (every) option in a\n"
@@ -144,6 +149,19 @@
 "is assembled from the FontName of the source font and a . (period) followed by\n"
 "the mode name.\n"
 "\n"
+"The -j option, which must precede -a, processes the files of an automatic set\n"
+"in the specified number of parallel worker processes. Each file is still\n"
+"written to its own destination and the console output of each file is printed\n"
+"in argument order, followed by a summary of the time spent on each file. Files\n"
+"with the same destination are processed one after the other in argument order,\n"
+"as without -j. For example:\n"
+"\n",
+"    tx -cff -j 8 -dd /tmp/cff -a *.pfb\n"
+"\n"
+"Since the -A destination names depend on the font data, -A files are always\n"
+"processed serially. Parallel processing is not available on Windows, where -a\n"
+"files are processed serially even with -j.\n"
+"\n"
 "Scripting\n"
 "---------\n"
 "The -s (script) option provides a way of specifying commonly used options and\n"
@@ -189,6 +207,19 @@
 "\n"
 "    tx -ps -f -s disks-testset-pfb\n"
 "\n"
+"Batch Mode\n"
+"----------\n"
+"The -batch option, which must be the only option, runs many tx commands in a\n"
+"single process. Each line of the specified control file (or stdin, if the\n"
+"filename is -) is parsed like a script file and run as though it were the\n"
+"argument list of a separate tx invocation, except that each command must name\n"
+"a source file. Library contexts are kept between commands, which avoids the\n",
+"cost of starting tx for many small operations. After each command tx prints\n"
+"its status and latency to stderr; a command that fails does not stop later\n"
+"ones. For example:\n"
+"\n"
+"    printf '%s\\n' '-dump -0 a.otf' '-mtx b.otf' | tx -batch -\n"
+"\n",
 "Miscellaneous\n"
 "-------------\n"
 "The -v (version) option shows the versions of all the library components\n"
@@ -202,4 +233,32 @@
 "the memory allocator in one of the first M calls, selected randomly. The\n"
 "failing call will be reported (call this N). If it is desired to repeat the\n",
 "same failure, tx should be run again but this time with -N (a hyphen followed\n"
-"by N) as the argument to the -m option.\n"
+"by N) as the argument to the -m option.\n",
+"\n"
+"The -cache option keeps up to the specified number of kilobytes of decoded\n"
+"CFF and CFF2 charstrings so that glyphs requested more than once from the\n"
+"same font, e.g. by a -g list that repeats glyphs in a proofing or dump mode,\n"
+"are replayed rather than decoded again. The cache is kept across the members\n"
+"of a collection read with -y, so a CFF table shared by several members is\n"
+"decoded once. The cache hits and misses for each font are reported to\n"
+"stderr.\n",
+"\n"
+"The -bench option decodes every glyph of each CFF, CFF2 or TrueType font the\n"
+"specified number of times before the font is processed and reports the\n"
+"decoding rate to stderr. Combined with -U it measures the cost of blending a\n"
+"CFF2 font or applying the gvar deltas of a TrueType font at a fixed instance,\n"
+"e.g.:\n"
+"\n"
+"    tx -mtx -bench 100 -U 500,0 font.otf\n",
+"\n"
+"For a Type 1 font -bench instead parses the whole font, including eexec and\n"
+"charstring decryption, the specified number of times and reports the rate in\n"
+"megabytes per second. For a multiple master font with -U it also makes the\n"
+"instance the specified number of times, once by parsing the font for each\n"
+"instance and once by changing the instance of a font parsed at its default\n"
+"instance, and reports both rates in instances per second. In -t1 mode -bench\n"
+"also writes the Type 1 font the specified number of times, discarding the\n"
+"output, before it is written to the destination and reports the eexec\n"
+"encryption and encoding rate, e.g.:\n"
+"\n"
+"    tx -t1 -bench 20 font.otf font.pfa\n"
@@ -39,9 +39,13 @@ DCL_OPT("-abs", opt_abs)
 DCL_OPT("-afm", opt_afm)
 DCL_OPT("-altLayer", opt_altLayer)
 DCL_OPT("-b", opt_b)
+DCL_OPT("-batch", opt_batch)
 DCL_OPT("-bc", opt_bc)
+DCL_OPT("-bench", opt_bench)
 DCL_OPT("-c", opt_c)
+DCL_OPT("-cache", opt_cache)
 DCL_OPT("-cef", opt_cef)
+DCL_OPT("-cefsplit", opt_cefsplit)
 DCL_OPT("-cefsvg", opt_cefsvg)
 DCL_OPT("-cff", opt_cff)
 DCL_OPT("-cff2", opt_cff2)
@@ -64,6 +68,7 @@ DCL_OPT("-gn2", opt_gn2)
 DCL_OPT("-gx", opt_gx)
 DCL_OPT("-h", opt_h)
 DCL_OPT("-i", opt_i)
+DCL_OPT("-j", opt_j)
 DCL_OPT("-l", opt_l)
 DCL_OPT("-lf", opt_lf)
 DCL_OPT("-m", opt_m)
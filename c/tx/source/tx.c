@@ -126,8 +126,51 @@ static void ufo_Help(txCtx h) {
 
 /* ---------------------------- cffread Library ---------------------------- */
 
+/* Decode all glyphs h->cfr.bench times, computing only their metrics, and
+   report the decoding rate. */
+static void cfrBenchGlyphs(txCtx h) {
+    struct abfMetricsCtx_ ctx;
+    abfGlyphCallbacks cb = abfGlyphMetricsCallbacks;
+    double start;
+    double secs;
+    long i;
+
+    ctx.flags = 0;
+    cb.direct_ctx = &ctx;
+
+    start = ctuWallTime();
+    for (i = 0; i < h->cfr.bench; i++)
+        if (cfrIterateGlyphs(h->cfr.ctx, &cb) || cfrResetGlyphs(h->cfr.ctx))
+            fatal(h, NULL);
+    secs = ctuWallTime() - start;
+
+    fprintf(stderr, "%s: decoded %ld glyphs %ld times in %.3f sec "
+            "(%.0f glyphs/sec)\n",
+            h->progname, h->top->sup.nGlyphs, h->cfr.bench, secs,
+            (secs > 0) ? h->top->sup.nGlyphs * h->cfr.bench / secs : 0.0);
+}
+
+/* Report decoded glyph cache counters for the font just read, given the
+   counters before it was read. */
+static void cfrReportCache(txCtx h, t2cCacheStats *start) {
+    t2cCacheStats stats;
+    unsigned long lookups;
+
+    cfrGetGlyphCacheStats(h->cfr.ctx, &stats);
+    stats.hits -= start->hits;
+    stats.misses -= start->misses;
+    stats.evictions -= start->evictions;
+    lookups = stats.hits + stats.misses;
+    fprintf(stderr, "%s: glyph cache: %lu hits, %lu misses (%.1f%% hit rate), "
+            "%lu evictions, %lu glyphs in %lu bytes\n",
+            h->progname, stats.hits, stats.misses,
+            (lookups > 0) ? 100.0 * stats.hits / lookups : 0.0,
+            stats.evictions, stats.entries, (unsigned long)stats.bytes);
+}
+
 /* Read font with cffread library. */
 static void cfrReadFont(txCtx h, long origin, int ttcIndex) {
+    t2cCacheStats start;
     float *uv;
     if (h->cfr.ctx == NULL) {
         h->cfr.ctx = cfrNew(&h->cb.mem, &h->cb.stm, CFR_CHECK_ARGS);
@@ -135,6 +178,13 @@ static void cfrReadFont(txCtx h, long origin, int ttcIndex) {
             fatal(h, "(cfr) can't init lib");
     }
 
+    /* (Re)create glyph cache for each file. Collection members read from the
+       same file keep it, so glyphs of a shared CFF table are decoded once. */
+    if (!(h->cfr.flags & CFR_SAME_SOURCE) &&
+        cfrSetGlyphCache(h->cfr.ctx, (size_t)h->cfr.cacheKB * 1024))
+        fatal(h, "(cfr) can't allocate glyph cache");
+    cfrGetGlyphCacheStats(h->cfr.ctx, &start);
+
     if (h->flags & SUBSET_OPT && h->mode != mode_dump)
         h->cfr.flags |= CFR_UPDATE_OPS; /* Convert seac for subsets */
 
@@ -144,6 +194,9 @@ static void cfrReadFont(txCtx h, long origin, int ttcIndex) {
     if (cfrBegFont(h->cfr.ctx, h->cfr.flags, origin, ttcIndex, &h->top, uv))
         fatal(h, NULL);
 
+    if (h->cfr.bench > 0)
+        cfrBenchGlyphs(h);
+
     prepSubset(h);
 
     h->dst.begfont(h, h->top);
@@ -167,8 +220,217 @@ static void cfrReadFont(txCtx h, long origin, int ttcIndex) {
 
     h->dst.endfont(h);
 
+    if (h->cfr.cacheKB > 0)
+        cfrReportCache(h, &start);
+
     if (cfrEndFont(h->cfr.ctx))
         fatal(h, NULL);
+    h->cfr.flags |= CFR_SAME_SOURCE;
+}
+
+/* ----------------------------- t1read Library ---------------------------- */
+
+/* Prepare Type 1 source filter for reading the font again. */
+static void t1rRewindSrc(txCtx h) {
+    if (h->seg.refill != NULL) {
+        h->seg.left = 0;
+        h->src.next = h->src.end;
+    }
+}
+
+/* Make h->t1r.bench instances of a multiple master font at the -U instance,
+   first by parsing the font for each instance and then by parsing it once at
+   its default instance and calling t1rSetInstance() for each instance, and
+   report both rates. All glyphs of each instance are decoded, computing only
+   their metrics. */
+static void t1rBenchInstances(txCtx h, long origin, float *UDV) {
+    struct abfMetricsCtx_ ctx;
+    abfGlyphCallbacks cb = abfGlyphMetricsCallbacks;
+    abfTopDict *top;
+    double start;
+    double parseSecs;
+    double instSecs;
+    long i;
+
+    ctx.flags = 0;
+    cb.direct_ctx = &ctx;
+
+    /* Parse font for each instance */
+    start = ctuWallTime();
+    for (i = 0; i < h->t1r.bench; i++) {
+        t1rRewindSrc(h);
+        if (t1rBegFont(h->t1r.ctx, h->t1r.flags, origin, &top, UDV) ||
+            t1rIterateGlyphs(h->t1r.ctx, &cb) ||
+            t1rEndFont(h->t1r.ctx))
+            fatal(h, NULL);
+    }
+    parseSecs = ctuWallTime() - start;
+
+    /* Parse font once at its default instance and change instance */
+    t1rRewindSrc(h);
+    start = ctuWallTime();
+    if (t1rBegFont(h->t1r.ctx, h->t1r.flags, origin, &top, NULL))
+        fatal(h, NULL);
+    for (i = 0; i < h->t1r.bench; i++)
+        if (t1rSetInstance(h->t1r.ctx, UDV, &top) ||
+            t1rIterateGlyphs(h->t1r.ctx, &cb) ||
+            t1rResetGlyphs(h->t1r.ctx))
+            fatal(h, NULL);
+    instSecs = ctuWallTime() - start;
+    if (t1rEndFont(h->t1r.ctx))
+        fatal(h, NULL);
+
+    fprintf(stderr, "%s: made %ld instances of %ld glyphs by parsing in "
+            "%.3f sec (%.1f instances/sec)\n",
+            h->progname, h->t1r.bench, top->sup.nGlyphs, parseSecs,
+            (parseSecs > 0) ? h->t1r.bench / parseSecs : 0.0);
+    fprintf(stderr, "%s: made %ld instances of %ld glyphs by t1rSetInstance "
+            "in %.3f sec (%.1f instances/sec)\n",
+            h->progname, h->t1r.bench, top->sup.nGlyphs, instSecs,
+            (instSecs > 0) ? h->t1r.bench / instSecs : 0.0);
+}
+
+/* Parse a Type 1 font h->t1r.bench times and report the parsing rate. Each
+   parse tokenizes the font and decrypts its eexec section and charstrings. */
+static void t1rBenchFont(txCtx h, long origin) {
+    abfTopDict *top;
+    short srcFlags = h->src.stm.flags;
+    float *UDV = getUDV(h);
+    double start;
+    double secs;
+    double MB;
+    long nMasters;
+    long i;
+
+    if (h->t1r.ctx == NULL) {
+        h->t1r.ctx = t1rNew(&h->cb.mem, &h->cb.stm, T1R_CHECK_ARGS);
+        if (h->t1r.ctx == NULL)
+            fatal(h, "(t1r) can't init lib");
+    }
+
+    /* Size font file */
+    if (fseek(h->src.stm.fp, 0, SEEK_END) == -1)
+        fileError(h, h->src.stm.filename);
+    MB = (ftell(h->src.stm.fp) - origin) / (1024.0 * 1024.0);
+
+    /* Keep source open for reading the font again */
+    h->src.stm.flags |= STM_DONT_CLOSE;
+
+    start = ctuWallTime();
+    for (i = 0; i < h->t1r.bench; i++) {
+        t1rRewindSrc(h);
+        if (t1rBegFont(h->t1r.ctx, h->t1r.flags, origin, &top, UDV) ||
+            t1rEndFont(h->t1r.ctx))
+            fatal(h, NULL);
+    }
+    secs = ctuWallTime() - start;
+
+    fprintf(stderr, "%s: parsed %.2f MB font (%ld glyphs) %ld times in "
+            "%.3f sec (%.1f MB/sec)\n",
+            h->progname, MB, top->sup.nGlyphs, h->t1r.bench, secs,
+            (secs > 0) ? MB * h->t1r.bench / secs : 0.0);
+
+    if (UDV != NULL && t1rGetWV(h->t1r.ctx, &nMasters) != NULL)
+        t1rBenchInstances(h, origin, UDV);
+
+    h->src.stm.flags = srcFlags;
+    t1rRewindSrc(h);
+}
+
+/* Read a Type 1 font once for each -U instance. A multiple master font is
+   parsed once, at the first instance, and switched to each of the others
+   with t1rSetInstance(). */
+static void t1rReadInstances(txCtx h, long origin) {
+    char *U = h->arg.U;
+    long nMasters;
+    long i;
+
+    if (h->t1r.ctx == NULL) {
+        h->t1r.ctx = t1rNew(&h->cb.mem, &h->cb.stm, T1R_CHECK_ARGS);
+        if (h->t1r.ctx == NULL)
+            fatal(h, "(t1r) can't init lib");
+    }
+
+    if (h->flags & SUBSET_OPT && h->mode != mode_dump)
+        h->t1r.flags |= T1R_UPDATE_OPS; /* Convert seac for subsets */
+
+    if (h->flags & NO_UDV_CLAMPING)
+        h->t1r.flags |= T1R_NO_UDV_CLAMPING;
+
+    h->arg.U = h->inst.udvs.array[0];
+    if (t1rBegFont(h->t1r.ctx, h->t1r.flags, origin, &h->top, getUDV(h)))
+        fatal(h, NULL);
+
+    for (i = 0; i < h->inst.udvs.cnt; i++) {
+        if (i > 0) {
+            /* A single master font is read again as it is */
+            h->arg.U = h->inst.udvs.array[i];
+            if ((t1rGetWV(h->t1r.ctx, &nMasters) != NULL &&
+                 t1rSetInstance(h->t1r.ctx, getUDV(h), &h->top)) ||
+                t1rResetGlyphs(h->t1r.ctx))
+                fatal(h, NULL);
+        }
+
+        prepSubset(h);
+
+        h->dst.begfont(h, h->top);
+
+        if (h->mode != mode_cef) {
+            if (h->arg.g.cnt != 0)
+                callbackSubset(h);
+            else if (t1rIterateGlyphs(h->t1r.ctx, &h->cb.glyph))
+                fatal(h, NULL);
+        }
+
+        h->dst.endfont(h);
+    }
+    h->arg.U = U;
+
+    if (t1rEndFont(h->t1r.ctx))
+        fatal(h, NULL);
+}
+
+/* ----------------------------- ttread Library ---------------------------- */
+
+/* Decode all glyphs of a TrueType font h->ttr.bench times, computing only
+   their metrics, and report the decoding rate. For a variable font this
+   includes applying the gvar deltas for the -U instance. */
+static void ttrBenchFont(txCtx h, long origin, int iTTC) {
+    struct abfMetricsCtx_ ctx;
+    abfGlyphCallbacks cb = abfGlyphMetricsCallbacks;
+    abfTopDict *top;
+    short srcFlags = h->src.stm.flags;
+    double start;
+    double secs;
+    long i;
+
+    if (h->ttr.ctx == NULL) {
+        h->ttr.ctx = ttrNew(&h->cb.mem, &h->cb.stm, TTR_CHECK_ARGS);
+        if (h->ttr.ctx == NULL)
+            fatal(h, "(ttr) can't init lib");
+    }
+    if (ttrBegFont(h->ttr.ctx, h->ttr.flags, origin, iTTC, &top, getUDV(h)))
+        fatal(h, NULL);
+
+    ctx.flags = 0;
+    cb.direct_ctx = &ctx;
+
+    start = ctuWallTime();
+    for (i = 0; i < h->ttr.bench; i++)
+        if (ttrIterateGlyphs(h->ttr.ctx, &cb) || ttrResetGlyphs(h->ttr.ctx))
+            fatal(h, NULL);
+    secs = ctuWallTime() - start;
+
+    fprintf(stderr, "%s: decoded %ld glyphs %ld times in %.3f sec "
+            "(%.0f glyphs/sec)\n",
+            h->progname, top->sup.nGlyphs, h->ttr.bench, secs,
+            (secs > 0) ? top->sup.nGlyphs * h->ttr.bench / secs : 0.0);
+
+    /* Keep source open for reading the font again */
+    h->src.stm.flags |= STM_DONT_CLOSE;
+    if (ttrEndFont(h->ttr.ctx))
+        fatal(h, NULL);
+    h->src.stm.flags = srcFlags;
 }
 
 /* ----------------------------- Usage and Help ---------------------------- */
@@ -240,32 +502,12 @@ static void help(txCtx h) {
     exit(0);
 }
 
-/* Add arguments from script file. */
-static void addArgs(txCtx h, char *filename) {
+/* Parse script buffer into args. */
+static void splitArgs(txCtx h, size_t length) {
     int state;
     long i;
-    size_t length;
-    FILE *fp;
     char *start = NULL; /* Suppress optimizer warning */
 
-    /* Open script file */
-    if ((fp = fopen(filename, "rb")) == NULL ||
-        fseek(fp, 0, SEEK_END) == -1)
-        fileError(h, filename);
-
-    /* Size file and allocate buffer */
-    length = ftell(fp) + 1;
-    h->script.buf = memNew(h, length);
-
-    /* Read whole file into buffer and close file */
-    if (fseek(fp, 0, SEEK_SET) == -1 ||
-        fread(h->script.buf, 1, length, fp) != length - 1 ||
-        fclose(fp) == EOF)
-        fileError(h, filename);
-
-    h->script.buf[length - 1] = '\n'; /* Ensure termination */
-
-    /* Parse buffer into args */
     state = 0;
     for (i = 0; i < (long)length; i++) {
         int c = h->script.buf[i] & 0xff;
@@ -313,6 +555,31 @@ static void addArgs(txCtx h, char *filename) {
     }
 }
 
+/* Add arguments from script file. */
+static void addArgs(txCtx h, char *filename) {
+    size_t length;
+    FILE *fp;
+
+    /* Open script file */
+    if ((fp = fopen(filename, "rb")) == NULL ||
+        fseek(fp, 0, SEEK_END) == -1)
+        fileError(h, filename);
+
+    /* Size file and allocate buffer */
+    length = ftell(fp) + 1;
+    h->script.buf = memNew(h, length);
+
+    /* Read whole file into buffer and close file */
+    if (fseek(fp, 0, SEEK_SET) == -1 ||
+        fread(h->script.buf, 1, length, fp) != length - 1 ||
+        fclose(fp) == EOF)
+        fileError(h, filename);
+
+    h->script.buf[length - 1] = '\n'; /* Ensure termination */
+
+    splitArgs(h, length);
+}
+
 /* Get version callback function. */
 static void getversion(ctlVersionCallbacks *cb, int version, char *libname) {
     char version_buf[MAX_VERSION_SIZE];
@@ -366,6 +633,60 @@ static int getOptionIndex(char *key) {
     return (int)((optstr == NULL) ? opt_None : optstr - options + 1);
 }
 
+/* Read font according to type. */
+static void readFont(txCtx h, FontRec *rec) {
+    switch (h->src.type) {
+        case src_Type1:
+            if (h->t1r.bench > 0)
+                t1rBenchFont(h, rec->offset);
+            if (h->inst.udvs.cnt > 1)
+                t1rReadInstances(h, rec->offset);
+            else
+                t1rReadFont(h, rec->offset);
+            break;
+        case src_OTF:
+            h->cfr.flags |= CFR_NO_ENCODING;
+            /* Fall through */
+        case src_CFF:
+            cfrReadFont(h, rec->offset, rec->iTTC);
+            break;
+        case src_TrueType:
+            if (h->ttr.bench > 0)
+                ttrBenchFont(h, rec->offset, rec->iTTC);
+            ttrReadFont(h, rec->offset, rec->iTTC);
+            break;
+        case src_SVG:
+            svrReadFont(h, rec->offset);
+            break;
+        case src_UFO:
+            ufoReadFont(h, rec->offset);
+            break;
+    }
+}
+
+/* Read font other than Type 1 once for each -U instance, reading it again
+   for each. */
+static void readFontInstances(txCtx h, FontRec *rec) {
+    short srcFlags = h->src.stm.flags;
+    char *U = h->arg.U;
+    long i;
+
+    for (i = 0; i < h->inst.udvs.cnt; i++) {
+        h->arg.U = h->inst.udvs.array[i];
+        if (i + 1 < h->inst.udvs.cnt)
+            h->src.stm.flags |= STM_DONT_CLOSE;
+        else
+            h->src.stm.flags = srcFlags;
+        if (h->seg.refill != NULL) {
+            /* Prep source filter */
+            h->seg.left = 0;
+            h->src.next = h->src.end;
+        }
+        readFont(h, rec);
+    }
+    h->arg.U = U;
+}
+
 /* Process file. */
 static void doFile(txCtx h, char *srcname) {
     long i;
@@ -417,6 +738,7 @@ static void doFile(txCtx h, char *srcname) {
     buildFontList(h);
 
     /* Process font list */
+    h->cfr.flags &= ~CFR_SAME_SOURCE;
     for (i = 0; i < h->fonts.cnt; i++) {
         FontRec *rec = &h->fonts.array[i];
 
@@ -431,31 +753,15 @@ static void doFile(txCtx h, char *srcname) {
             h->src.next = h->src.end;
         }
 
-        /* Process font according to type */
-        switch (h->src.type) {
-            case src_Type1:
-                t1rReadFont(h, rec->offset);
-                break;
-            case src_OTF:
-                h->cfr.flags |= CFR_NO_ENCODING;
-                /* Fall through */
-            case src_CFF:
-                cfrReadFont(h, rec->offset, rec->iTTC);
-                break;
-            case src_TrueType:
-                ttrReadFont(h, rec->offset, rec->iTTC);
-                break;
-            case src_SVG:
-                svrReadFont(h, rec->offset);
-                break;
-            case src_UFO:
-                ufoReadFont(h, rec->offset);
-                break;
-        }
+        if (h->inst.udvs.cnt > 1 && h->src.type != src_Type1)
+            readFontInstances(h, rec);
+        else
+            readFont(h, rec);
     }
 
     h->arg.i = NULL;
     h->flags |= DONE_FILE;
+    h->inst.reset = 1;
 }
 
 /* Process multi-file set. Return index of last used arg. */
@@ -503,14 +809,161 @@ static void doSingleFileSet(txCtx h, char *srcname) {
     h->dst.endset(h);
 }
 
+/* ---------------------------- Parallel File Sets -------------------------- */
+
+/* An auto-file set (-a) may be processed by several worker processes (-j)
+   with ctuRunJobs(). The file arguments are collected first, each with the
+   -sd/-sr/-dd options in effect at its point in the argument list. A worker
+   processes the files it takes one after another, as in a serial run, and
+   the console output of the files is printed in argument order. A file whose
+   destination is the same as that of an earlier file in the current run of
+   workers starts a new run, so the last one wins as when processed
+   serially. */
+
+typedef struct { /* File of an auto-file set */
+    char *srcname;          /* Source filename argument */
+    char *sd;               /* -sd/-sr/-dd in effect for the file */
+    char *sr;
+    char *dd;
+    char dst[FILENAME_MAX]; /* Destination filename */
+} AutoFile;
+
+typedef struct { /* Result of processing a file */
+    int done;    /* File processed */
+    double secs; /* Elapsed wall clock time */
+} AutoFileResult;
+
+typedef struct { /* ctuRunJobs() context */
+    txCtx h;
+    AutoFile *files;
+    int inWorker; /* Running in a worker process */
+    int prepared; /* Worker has been prepared */
+} AutoFileRun;
+
+/* [ctuRunJobs callback] Process file "index" of the run. */
+static void CTL_CDECL autoFileJob(long index, void *result, void *ctx) {
+    AutoFileRun *run = ctx;
+    txCtx h = run->h;
+    AutoFile *file = &run->files[index];
+    AutoFileResult *res = result;
+    double start = ctuWallTime();
+    jmp_buf env;
+
+    if (run->inWorker) {
+        if (!run->prepared) {
+            stmRenewTmp(h); /* Worker's own tmp files */
+            run->prepared = 1;
+        }
+        /* fatal() returns here, and not to a -batch command loop. The worker
+           then ends without closing the streams it shares with the parent,
+           as exit() could move the parent's batch file position. */
+        h->batchEnv = &env;
+        if (setjmp(env) != 0) {
+            fflush(stdout);
+            fflush(stderr);
+            _Exit(EXIT_FAILURE);
+        }
+    }
+    h->file.sd = file->sd;
+    h->file.sr = file->sr;
+    h->file.dd = file->dd;
+    doSingleFileSet(h, file->srcname);
+    if (run->inWorker)
+        h->batchEnv = NULL;
+    res->secs = ctuWallTime() - start;
+    res->done = 1;
+}
+
+/* Process the files of an auto-file set in parallel and print a per-file
+   timing summary. */
+static void doParallelFiles(txCtx h, AutoFile *files, long cnt) {
+    AutoFileRun run;
+    AutoFileResult *results = memNew(h, cnt * sizeof(AutoFileResult));
+    char *sd = h->file.sd;
+    char *sr = h->file.sr;
+    char *dd = h->file.dd;
+    double start = ctuWallTime();
+    long failed = 0;
+    long first;
+    long i;
+
+    memset(results, 0, cnt * sizeof(AutoFileResult));
+    run.h = h;
+    run.inWorker = 1;
+    for (first = 0; first < cnt;) {
+        long last;
+
+        /* End the run before a file with the same destination as one in it */
+        for (last = first + 1; last < cnt; last++) {
+            for (i = first; i < last; i++)
+                if (strcmp(files[i].dst, files[last].dst) == 0)
+                    break;
+            if (i < last)
+                break;
+        }
+
+        run.files = &files[first];
+        run.prepared = 0;
+        if (run.inWorker &&
+            ctuRunJobs(last - first, (int)h->file.workers, CTU_JOBS_KEEP_GOING,
+                       autoFileJob, sizeof(AutoFileResult), &results[first],
+                       &run) < 0) {
+            if (errno != ENOSYS)
+                fprintf(stderr, "%s: can't start worker <%s>, processing "
+                        "files serially\n", h->progname, strerror(errno));
+            run.inWorker = 0;
+        }
+        if (!run.inWorker)
+            for (i = first; i < last; i++)
+                autoFileJob(i - first, &results[i], &run);
+        first = last;
+    }
+    h->file.sd = sd;
+    h->file.sr = sr;
+    h->file.dd = dd;
+
+    for (i = 0; i < cnt; i++) {
+        fprintf(stderr, "%s: [%ld/%ld] %s %s in %.3f sec\n", h->progname,
+                i + 1, cnt, results[i].done ? "processed" : "failed",
+                files[i].srcname, results[i].secs);
+        if (!results[i].done)
+            failed++;
+    }
+    start = ctuWallTime() - start;
+    fprintf(stderr, "%s: processed %ld of %ld files in %.3f sec "
+            "(%.2f files/sec, %ld workers)\n", h->progname,
+            cnt - failed, cnt, start,
+            start > 0 ? (cnt - failed) / start : 0.0, h->file.workers);
+
+    memFree(h, results);
+    h->flags |= DONE_FILE;
+    if (failed > 0)
+        fatal(h, "%ld of %ld files failed", failed, cnt);
+}
+
 /* Process auto-file set. Return index of last used arg. */
 static int doAutoFileSet(txCtx h, int argc, char *argv[], int i) {
     int filecnt = 0;
+    /* -A destinations depend on the font data, so duplicates can't be found
+       before the files are read and the files are processed serially */
+    int parallel = h->file.workers > 1 && (h->flags & AUTO_FILE_FROM_FILE);
+    dnaDCL(AutoFile, files);
+
+    if (parallel)
+        dnaINIT(h->ctx.dna, files, 64, 256);
 
     for (; i < argc; i++)
         switch (getOptionIndex(argv[i])) {
             case opt_None:
-                doSingleFileSet(h, argv[i]);
+                if (parallel) {
+                    AutoFile *file = dnaNEXT(files);
+                    file->srcname = argv[i];
+                    file->sd = h->file.sd;
+                    file->sr = h->file.sr;
+                    file->dd = h->file.dd;
+                    dstFileMakeAutoName(h, file->dst, argv[i]);
+                } else
+                    doSingleFileSet(h, argv[i]);
                 filecnt++;
                 break;
             case opt_sd:
@@ -535,6 +988,10 @@ static int doAutoFileSet(txCtx h, int argc, char *argv[], int i) {
 finish:
     if (filecnt == 0)
         fatal(h, "empty list (-a/-A)");
+    if (parallel) {
+        doParallelFiles(h, files.array, files.cnt);
+        dnaFREE(files);
+    }
 
     return i - 1;
 }
@@ -593,6 +1050,18 @@ static void parseArgs(txCtx h, int argc, char *argv[]) {
             case opt_cef:
                 setMode(h, mode_cef);
                 break;
+            case opt_cefsplit:
+                if (h->mode != mode_cef)
+                    goto wrongmode;
+                else if (!argsleft)
+                    goto noarg;
+                else {
+                    char *q;
+                    h->arg.cef.split = strtol(argv[++i], &q, 0);
+                    if (*q != '\0' || h->arg.cef.split < 1)
+                        goto badarg;
+                }
+                break;
             case opt_cefsvg:
                 if (h->mode != mode_cef)
                     goto wrongmode;
@@ -615,6 +1084,8 @@ static void parseArgs(txCtx h, int argc, char *argv[]) {
                 break;
             case opt_bc:
                 goto bc_gone;
+            case opt_batch:
+                fatal(h, "option must be used alone (-batch)");
             case opt_dcf:
                 setMode(h, mode_dcf);
                 break;
@@ -1221,6 +1692,11 @@ static void parseArgs(txCtx h, int argc, char *argv[]) {
                 if (!argsleft)
                     goto noarg;
                 h->arg.U = argv[++i];
+                if (h->inst.reset) {
+                    h->inst.udvs.cnt = 0;
+                    h->inst.reset = 0;
+                }
+                *dnaNEXT(h->inst.udvs) = h->arg.U;
                 break;
 
             case opt_UNC:
@@ -1292,6 +1768,16 @@ static void parseArgs(txCtx h, int argc, char *argv[]) {
                     goto noarg;
                 h->file.dd = argv[++i];
                 break;
+            case opt_j:
+                if (!argsleft)
+                    goto noarg;
+                else {
+                    char *q;
+                    h->file.workers = strtol(argv[++i], &q, 0);
+                    if (*q != '\0' || h->file.workers < 1)
+                        goto badarg;
+                }
+                break;
             case opt_sd:
                 if (!argsleft)
                     goto noarg;
@@ -1319,6 +1805,30 @@ static void parseArgs(txCtx h, int argc, char *argv[]) {
             case opt_t:
                 h->t1r.flags |= T1R_DUMP_TOKENS;
                 break;
+            case opt_bench:
+                if (!argsleft)
+                    goto noarg;
+                else {
+                    char *q;
+                    h->cfr.bench = strtol(argv[++i], &q, 0);
+                    if (*q != '\0' || h->cfr.bench < 1)
+                        goto badarg;
+                    h->ttr.bench = h->cfr.bench;
+                    h->t1r.bench = h->cfr.bench;
+                    h->t1w.bench = h->cfr.bench;
+                    h->cef.bench = h->cfr.bench;
+                }
+                break;
+            case opt_cache:
+                if (!argsleft)
+                    goto noarg;
+                else {
+                    char *q;
+                    h->cfr.cacheKB = strtol(argv[++i], &q, 0);
+                    if (*q != '\0' || h->cfr.cacheKB < 0)
+                        goto badarg;
+                }
+                break;
             case opt_m: /* Memory failure simulator */
                 if (!argsleft)
                     goto noarg;
@@ -1368,8 +1878,11 @@ static void parseArgs(txCtx h, int argc, char *argv[]) {
         }
     }
 
-    if (!(h->flags & DONE_FILE))
+    if (!(h->flags & DONE_FILE)) {
+        if (h->batchEnv != NULL)
+            fatal(h, "no source file in batch command");
         doSingleFileSet(h, "-");
+    }
     return;
 
 wrongmode:
@@ -1420,12 +1933,18 @@ static void txNew(txCtx h, char *progname) {
 
     h->src.print_file = 0;
     h->t1r.ctx = NULL;
+    h->t1r.bench = 0;
     h->cfr.ctx = NULL;
+    h->cfr.cacheKB = 0;
+    h->cfr.bench = 0;
     h->ttr.ctx = NULL;
     h->ttr.flags = 0;
+    h->ttr.bench = 0;
+    h->t1w.bench = 0;
     h->cfw.ctx = NULL;
     h->cfw.maxNumSubrs = 0; /* 0 is translated to the MAX_NUMBER_SUBRS defined in the cffWrite module. */
     h->cef.ctx = NULL;
+    h->cef.bench = 0;
     h->abf.ctx = NULL;
     h->pdw.ctx = NULL;
     h->t1w.ctx = NULL;
@@ -1475,6 +1994,8 @@ static void txNew(txCtx h, char *progname) {
     dnaINIT(h->ctx.dna, h->fd.fdIndices, 16, 16);
     dnaINIT(h->ctx.dna, h->cmap.segment, 1, 1);
     dnaINIT(h->ctx.dna, h->dcf.glyph, 256, 768);
+    dnaINIT(h->ctx.dna, h->inst.udvs, 4, 16);
+    h->inst.reset = 0;
 
     setMode(h, mode_dump);
 
@@ -1508,6 +2029,7 @@ static void txFree(txCtx h) {
     dnaFREE(h->dcf.local);
     dnaFREE(h->dcf.varRegionInfo);
     dnaFREE(h->dcf.glyph);
+    dnaFREE(h->inst.udvs);
     dnaFREE(h->cmap.encoding);
     dnaFREE(h->fd.fdIndices);
     dnaFREE(h->cmap.segment);
@@ -1539,6 +2061,172 @@ static void txFree(txCtx h) {
     free(h);
 }
 
+/* ------------------------------- Batch Mode ------------------------------ */
+
+/* In batch mode (-batch) tx reads one command per line from a control file
+   or stdin and runs each as if it were the argument list of a separate tx
+   invocation, while keeping the context and the library contexts created by
+   earlier commands. A command that fails is reported and its context is
+   replaced by a new one before the next command is run. */
+
+/* Allocate and initialize context. */
+static txCtx newCtx(char *progname) {
+    txCtx h = malloc(sizeof(struct txCtx_));
+    if (h == NULL) {
+        fprintf(stderr, "%s: out of memory\n", progname);
+        exit(EXIT_FAILURE);
+    }
+    memset(h, 0, sizeof(struct txCtx_));
+
+    h->app = APP_TX;
+    h->appSpecificInfo = NULL; /* unused in tx.c, used in rotateFont.c & mergeFonts.c */
+    h->appSpecificFree = txFree;
+
+    txNew(h, progname);
+    return h;
+}
+
+/* Restore option state from init, a copy of the context as txNew() left it,
+   so that a batch command starts out like a new tx run. The library contexts,
+   streams and dynamic arrays created by earlier commands are kept, so only the
+   option parts of the context are restored; the mode-specific options are then
+   reset by setMode(). */
+static void resetCmd(txCtx h, const struct txCtx_ *init) {
+    h->flags = init->flags;
+    h->arg = init->arg;
+    h->file = init->file;
+    h->failmem = init->failmem;
+    h->src.print_file = init->src.print_file;
+    h->fd.fdIndices.cnt = 0;
+    h->inst.udvs.cnt = 0;
+    h->inst.reset = 0;
+
+    /* Source library options */
+    h->t1r.flags = init->t1r.flags;
+    h->t1r.bench = init->t1r.bench;
+    h->cfr.flags = init->cfr.flags;
+    h->cfr.cacheKB = init->cfr.cacheKB;
+    h->cfr.bench = init->cfr.bench;
+    h->ttr.flags = init->ttr.flags;
+    h->ttr.bench = init->ttr.bench;
+    h->svr.flags = init->svr.flags;
+    h->ufr.flags = init->ufr.flags;
+    h->ufr.altLayerDir = init->ufr.altLayerDir;
+
+    /* Destination library options not reset by setMode() */
+    h->cfw.maxNumSubrs = init->cfw.maxNumSubrs;
+    h->t1w.bench = init->t1w.bench;
+    h->cef.bench = init->cef.bench;
+    h->svw.flags = init->svw.flags;
+    h->ufow.flags = init->ufow.flags;
+
+    setMode(h, mode_dump);
+    h->flags = init->flags;
+}
+
+/* Read next line of control file into *buf, growing it as needed. Return 0
+   at end of file. */
+static int readCmdLine(FILE *fp, char **buf, size_t *size) {
+    size_t length = 0;
+
+    for (;;) {
+        if (*size - length < 2) {
+            char *p = realloc(*buf, *size * 2);
+            if (p == NULL)
+                return 0;
+            *buf = p;
+            *size *= 2;
+        }
+        if (fgets(*buf + length, (int)(*size - length), fp) == NULL)
+            return length > 0;
+        length += strlen(*buf + length);
+        if (length > 0 && (*buf)[length - 1] == '\n')
+            return 1;
+    }
+}
+
+/* Run batch command in h->script.args. Return 1 if it failed. */
+static int runCmd(txCtx *ph, const struct txCtx_ *init, long cnt) {
+    txCtx h = *ph;
+    jmp_buf env;
+    double start = ctuWallTime();
+
+    resetCmd(h, init);
+    h->batchEnv = &env;
+    if (setjmp(env) == 0) {
+        parseArgs(h, (int)h->script.args.cnt, h->script.args.array);
+        h->batchEnv = NULL;
+        fflush(stdout);
+        fprintf(stderr, "%s: [%ld] done in %.3f ms\n", h->progname, cnt,
+                (ctuWallTime() - start) * 1000);
+        fflush(stderr);
+        return 0;
+    } else {
+        /* fatal() called; discard context as it may be inconsistent */
+        char *progname = h->progname;
+        h->batchEnv = NULL;
+        fflush(stdout);
+        fprintf(stderr, "%s: [%ld] failed in %.3f ms\n", progname, cnt,
+                (ctuWallTime() - start) * 1000);
+        fflush(stderr);
+        txFree(h);
+        *ph = newCtx(progname);
+        return 1;
+    }
+}
+
+/* Run commands from control file (- for stdin). Return exit status. */
+static int runBatch(txCtx *ph, char *filename) {
+    struct txCtx_ *init;
+    FILE *fp;
+    char *line;
+    size_t size = 256;
+    long cnt = 0;
+    long failed = 0;
+    double start = ctuWallTime();
+    double secs;
+
+    if (strcmp(filename, "-") == 0)
+        fp = stdin;
+    else if ((fp = fopen(filename, "r")) == NULL)
+        fileError(*ph, filename);
+
+    /* Save initial option state */
+    init = malloc(sizeof(struct txCtx_));
+    line = malloc(size);
+    if (init == NULL || line == NULL)
+        fatal(*ph, "out of memory");
+    memcpy(init, *ph, sizeof(struct txCtx_));
+
+    while (readCmdLine(fp, &line, &size)) {
+        txCtx h = *ph;
+        size_t length = strlen(line);
+
+        /* Split line into args */
+        memFree(h, h->script.buf);
+        h->script.buf = memNew(h, length + 1);
+        memcpy(h->script.buf, line, length);
+        h->script.buf[length] = '\n'; /* Ensure termination */
+        h->script.args.cnt = 0;
+        splitArgs(h, length + 1);
+        if (h->script.args.cnt == 0)
+            continue; /* Blank or comment line */
+
+        failed += runCmd(ph, init, ++cnt);
+    }
+
+    free(line);
+    free(init);
+    if (fp != stdin)
+        fclose(fp);
+
+    secs = ctuWallTime() - start;
+    fprintf(stderr, "%s: ran %ld commands (%ld failed) in %.3f sec "
+            "(%.3f ms/command)\n", (*ph)->progname, cnt, failed,
+            secs, cnt > 0 ? secs * 1000 / cnt : 0.0);
+    return failed > 0 ? EXIT_FAILURE : 0;
+}
+
 /* Main program. */
 int CTL_CDECL main(int argc, char *argv[]) {
     txCtx h;
@@ -1565,20 +2253,17 @@ int CTL_CDECL main(int argc, char *argv[]) {
     ++argv;
 
     /* Allocate program context */
-    h = malloc(sizeof(struct txCtx_));
-    if (h == NULL) {
-        fprintf(stderr, "%s: out of memory\n", progname);
-        return EXIT_FAILURE;
-    }
-    memset(h, 0, sizeof(struct txCtx_));
-
-    h->app = APP_TX;
-    h->appSpecificInfo = NULL; /* unused in tx.c, used in rotateFont.c & mergeFonts.c */
-    h->appSpecificFree = txFree;
-
-    txNew(h, progname);
-
-    if (argc > 1 && getOptionIndex(argv[argc - 2]) == opt_s) {
+    h = newCtx(progname);
+
+    if (argc > 0 && getOptionIndex(argv[0]) == opt_batch) {
+        /* Batch mode */
+        int status;
+        if (argc != 2)
+            fatal(h, "option must be used alone with one argument (-batch)");
+        status = runBatch(&h, argv[1]);
+        txFree(h);
+        return status;
+    } else if (argc > 1 && getOptionIndex(argv[argc - 2]) == opt_s) {
         /* Option list ends with script option */
         int i;
 
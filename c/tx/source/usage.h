@@ -43,6 +43,8 @@
 "\n"
 "-t              dump PostScript tokens from Type 1/CID font\n"
 "-m <arg>        simulate memory allocation failure\n"
+"-cache <KB>     cache decoded CFF charstrings (up to <KB> kilobytes)\n"
+"-bench <n>      time decoding glyphs (Type 1: parsing; -t1: writing) <n> times\n"
 "-N              print filename and FontName to stderr before processing\n"
 "-pg             preserve GIDs when subsetting\n"
 "-n              remove hints\n"
@@ -59,9 +61,11 @@
 "-sr <srcroot>   read files from <srcroot> (combine with above options)\n"
 "-sd <srcdir>    read files from <srcdir> (combine with above options)\n"
 "-dd <dstdir>    write files to <dstdir> (combine with above options)\n"
+"-j <n>          process -a files in <n> parallel worker processes\n"
 "\n"
 "[other options]\n"
 "-s <script>     read options from <script>\n"
+"-batch <file>   run one command per line of <file> (- for stdin)\n"
 "-u              print usage\n"
 "-h              print general help\n"
 "-v              print component versions\n"
@@ -1,12 +1,15 @@
 import glob
 import os
 import pytest
+import re
+import shutil
 import subprocess
 
 from runner import main as runner
 from differ import main as differ, SPLIT_MARKER
 from test_utils import (get_input_path, get_expected_path, get_temp_file_path,
                         generate_ttx_dump, generate_spot_dumptables)
+from afdko.fdkutils import get_temp_dir_path
 
 TOOL = 'makeotfexe'
 CMD = ['-t', TOOL]
@@ -774,3 +777,176 @@ def test_heap_after_free_bug1349():
     output_dump = generate_ttx_dump(output_filename, ['name'])
     assert differ([output_dump, get_expected_path("bug1349.ttx"),
                    '-s', '<ttFont sfntVersion='])
+
+
+@pytest.mark.parametrize('args', [[], ['r']])
+def test_memory_output(args):
+    """
+    Fonts assembled in memory with -memOut must match those written
+    incrementally to the output file.
+    """
+    input_filename = get_input_path("font.pfa")
+    file_path = get_temp_file_path()
+    mem_path = get_temp_file_path()
+    runner(CMD + ['-o', 'f', f'_{input_filename}',
+                        'o', f'_{file_path}'] + args)
+    runner(CMD + ['-o', 'f', f'_{input_filename}',
+                        'o', f'_{mem_path}', 'memOut'] + args)
+    file_ttx = generate_ttx_dump(file_path)
+    mem_ttx = generate_ttx_dump(mem_path)
+    assert differ([file_ttx, mem_ttx,
+                   '-s',
+                   '<ttFont sfntVersion' + SPLIT_MARKER +
+                   '    <checkSumAdjustment value=' + SPLIT_MARKER +
+                   '    <created value=' + SPLIT_MARKER +
+                   '    <modified value='])
+
+
+def test_cff_cache():
+    """
+    A second build of the same source font with a different feature file
+    reuses the cached CFF data and still compiles the new features.
+    """
+    input_filename = get_input_path('bug155/font.pfa')
+    cache_dir = get_temp_dir_path()
+    for i, caret_format in enumerate(['bypos', 'byindex']):
+        feat_filename = get_input_path(f'bug155/caret-{caret_format}.fea')
+        actual_path = get_temp_file_path()
+        stderr_path = runner(CMD + ['-s', '-e', '-o',
+                                    'f', f'_{input_filename}',
+                                    'ff', f'_{feat_filename}',
+                                    'o', f'_{actual_path}',
+                                    'cache', f'_{cache_dir}', 'time'])
+        with open(stderr_path, 'rb') as f:
+            output = f.read()
+        assert (b'CFF cache hit' in output) is (i == 1)
+        assert b'feature compilation:' in output
+        assert b'glyph name references:' in output
+        actual_ttx = generate_ttx_dump(actual_path, ['GDEF'])
+        expected_ttx = get_expected_path(f'bug155/caret-{caret_format}.ttx')
+        assert differ([expected_ttx, actual_ttx, '-l', '2'])
+
+
+@pytest.mark.parametrize('workers', ['1', '2'])
+def test_batch_build(workers):
+    input_filename = get_input_path('font.pfa')
+    actual_paths = [get_temp_file_path() for i in range(3)]
+    batch_path = get_temp_file_path()
+    with open(batch_path, 'w') as f:
+        f.write('# one font per line\n')
+        for path in actual_paths:
+            f.write(f'-f "{input_filename}" -o "{path}"\n')
+    stderr_path = runner(CMD + ['-s', '-e', '-o',
+                                'batch', f'_{batch_path}',
+                                'workers', f'_{workers}'])
+    with open(stderr_path, 'rb') as f:
+        output = f.read()
+    assert b'built 3 of 3 fonts' in output
+    expected_ttx = get_expected_path('font_dev.ttx')
+    for path in actual_paths:
+        actual_ttx = generate_ttx_dump(path)
+        assert differ([expected_ttx, actual_ttx,
+                       '-s',
+                       '<ttFont sfntVersion' + SPLIT_MARKER +
+                       '    <checkSumAdjustment value=' + SPLIT_MARKER +
+                       '    <checkSumAdjustment value=' + SPLIT_MARKER +
+                       '    <created value=' + SPLIT_MARKER +
+                       '    <modified value=',
+                       '-r', r'^\s+Version.*;hotconv.*;makeotfexe'])
+
+
+@pytest.mark.parametrize('workers', ['1', '2'])
+def test_batch_build_failure(workers):
+    """
+    A font that fails to build is reported, and the fonts after it in the
+    batch are still built.
+    """
+    input_filename = get_input_path('font.pfa')
+    actual_paths = [get_temp_file_path() for i in range(3)]
+    batch_path = get_temp_file_path()
+    with open(batch_path, 'w') as f:
+        for i, path in enumerate(actual_paths):
+            font_path = input_filename if i != 1 else batch_path + '.pfa'
+            f.write(f'-f "{font_path}" -o "{path}"\n')
+    result = subprocess.run([TOOL, '-batch', batch_path, '-workers', workers],
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                            timeout=60)
+    assert result.returncode == 1
+    assert b'[2/3] failed' in result.stdout
+    assert b'built 2 of 3 fonts' in result.stdout
+    assert b'1 of 3 batch builds failed' in result.stdout
+    assert [os.path.getsize(path) > 0 for path in actual_paths] == [
+        True, False, True]
+
+
+def test_compiled_goadb_index():
+    """
+    The first build with '-gfi' compiles the GOADB into an index file next to
+    it; the second build loads that index. Both give the same font as '-gf'.
+    """
+    input_filename = "bug617/font.pfa"
+    goadb_path = os.path.join(get_temp_dir_path(), 'goadb.txt')
+    shutil.copy(get_input_path('bug617/goadb.txt'), goadb_path)
+    expected_ttx = get_expected_path('bug617/no_gs_opt.ttx')
+    for i in range(2):
+        actual_path = get_temp_file_path()
+        runner(CMD + ['-o', 'f', f'_{get_input_path(input_filename)}',
+                      'gfi', f'_{goadb_path}',
+                      'o', f'_{actual_path}', 'r'])
+        assert os.path.exists(goadb_path + '.idx')
+        actual_ttx = generate_ttx_dump(actual_path, ['head', 'CFF '])
+        assert differ([expected_ttx, actual_ttx,
+                       '-s',
+                       '<ttFont sfntVersion' + SPLIT_MARKER +
+                       '    <checkSumAdjustment value=' + SPLIT_MARKER +
+                       '    <checkSumAdjustment value=' + SPLIT_MARKER +
+                       '    <created value=' + SPLIT_MARKER +
+                       '    <modified value='])
+
+
+def test_compiled_goadb_index_stale():
+    """
+    The GOADB index is rebuilt when the text file changes, even if the new
+    file has the same size and its modification time is in the same second.
+    '-bench' times lookups of every name through the index.
+    """
+    input_filename = get_input_path('bug617/font.pfa')
+    goadb_path = os.path.join(get_temp_dir_path(), 'goadb.txt')
+    shutil.copy(get_input_path('bug617/goadb.txt'), goadb_path)
+    outputs = []
+    for i in range(3):
+        if i == 2:
+            st = os.stat(goadb_path)
+            with open(goadb_path) as f:
+                data = f.read()
+            with open(goadb_path, 'w') as f:
+                f.write(data.replace('a\ta', 'b\ta'))
+            os.utime(goadb_path, ns=(st.st_atime_ns, st.st_mtime_ns + 1))
+            assert os.path.getsize(goadb_path) == st.st_size
+        stderr_path = runner(CMD + ['-s', '-e', '-o',
+                                    'f', f'_{input_filename}',
+                                    'gfi', f'_{goadb_path}',
+                                    'o', f'_{get_temp_file_path()}',
+                                    'r', 'time', 'bench'])
+        with open(stderr_path, 'rb') as f:
+            outputs.append(f.read())
+    assert [b'2 names loaded from index' in output for output in outputs] == [
+        False, True, False]
+    for output in outputs:
+        assert re.search(rb'GlyphOrderAndAliasDB: \d+ lookups in', output)
+
+
+def test_bench_name_lookups():
+    """
+    '-bench' times glyph name lookups in the AGL and in the font, both
+    through the name hashes and by binary search.
+    """
+    stderr_path = runner(CMD + ['-s', '-e', '-o',
+                                'f', f'_{get_input_path("font.pfa")}',
+                                'o', f'_{get_temp_file_path()}', 'bench'])
+    with open(stderr_path, 'rb') as f:
+        output = f.read()
+    for glyph_set in (b'AGL', b'font'):
+        for method in (b'hash', b'bsearch'):
+            assert re.search(rb'glyph name lookup \(' + glyph_set + b', ' +
+                             method + rb'\): \d+ in', output)
@@ -1,5 +1,8 @@
 import pytest
+import random
+import re
 import subprocess
+import sys
 
 from runner import main as runner
 from differ import main as differ
@@ -83,3 +86,133 @@ def test_camel_case():
     expected_path = generate_ps_dump(expected_path)
 
     assert differ([expected_path, actual_path, '-s', r'%ADOt1write:'])
+
+
+@pytest.mark.parametrize('aliases', [True, False])
+def test_parallel_decode(aliases):
+    opts = []
+    fonts = []
+    if aliases:
+        opts = ['-cid', get_input_path('cidfontinfo.txt')]
+    for i in (1, 2, 3):
+        if aliases:
+            fonts.append(get_input_path(f'alias{i}.txt'))
+        fonts.append(get_input_path(f'font{i}.pfa'))
+    serial_path = get_temp_file_path()
+    parallel_path = get_temp_file_path()
+    serial = subprocess.run([TOOL] + opts + [serial_path] + fonts,
+                            capture_output=True)
+    parallel = subprocess.run([TOOL, '-j', '2'] + opts + [parallel_path] +
+                              fonts, capture_output=True)
+    assert serial.returncode == parallel.returncode == 0
+    assert serial.stderr == parallel.stderr
+    with open(serial_path, 'rb') as f1, open(parallel_path, 'rb') as f2:
+        assert f1.read() == f2.read()
+
+
+def test_parallel_decode_several_files_per_worker():
+    # 5 files decoded by 2 workers, so each worker decodes more than one
+    fonts = [get_input_path(f'font{i}.pfa') for i in (1, 2, 3, 2, 3, 1)]
+    serial_path = get_temp_file_path()
+    parallel_path = get_temp_file_path()
+    serial = subprocess.run([TOOL, serial_path] + fonts, capture_output=True,
+                            universal_newlines=True)
+    parallel = subprocess.run([TOOL, '-time', '-j', '2', parallel_path] +
+                              fonts, capture_output=True,
+                              universal_newlines=True)
+    assert serial.returncode == parallel.returncode == 0
+    if sys.platform != 'win32':
+        assert 'decoded 5 source fonts in' in parallel.stderr
+        assert 'failed' not in parallel.stderr
+    assert serial.stderr in parallel.stderr
+    with open(serial_path, 'rb') as f1, open(parallel_path, 'rb') as f2:
+        assert f1.read() == f2.read()
+
+
+@pytest.mark.parametrize('workers', ['1', '2'])
+def test_time_option(workers):
+    actual_path = get_temp_file_path()
+    proc = subprocess.run([TOOL, '-time', '-j', workers, actual_path] +
+                          [get_input_path(f'font{i}.pfa') for i in (1, 2, 3)],
+                          capture_output=True, universal_newlines=True)
+    assert proc.returncode == 0
+    if workers == '2' and sys.platform != 'win32':
+        assert 'decoded 2 source fonts in' in proc.stderr
+        assert 'merged 3 source fonts in' in proc.stderr
+    else:
+        assert 'read and merged 3 source fonts in' in proc.stderr
+    assert f'wrote {actual_path} in' in proc.stderr
+
+
+@pytest.fixture(scope='module')
+def synthetic_font():
+    """Bare CFF font of 60000 glyphs named g00000-g59999, plus .notdef."""
+    from fontTools.fontBuilder import FontBuilder
+    from fontTools.misc.psCharStrings import T2CharString
+    names = ['.notdef'] + [f'g{i:05d}' for i in range(60000)]
+    fb = FontBuilder(1000, isTTF=False)
+    fb.setupGlyphOrder(names)
+    charstrings = {
+        name: T2CharString(program=[500, 100, 100, 'rmoveto', 100, 0,
+                                    'rlineto', 0, 100 + i % 500, 'rlineto',
+                                    'endchar'])
+        for i, name in enumerate(names)}
+    fb.setupCFF('Synthetic', {}, charstrings, {})
+    font_path = get_temp_file_path()
+    with open(font_path, 'wb') as f:
+        f.write(fb.font['CFF '].compile(fb.font))
+    return font_path
+
+
+def alias_sources():
+    """Indexes of the synthetic font's glyphs g00000-g59999, shuffled."""
+    src = list(range(60000))
+    random.Random(1).shuffle(src)
+    return src
+
+
+def write_alias_file(dst_names):
+    """Map the synthetic font's glyphs, in shuffled order, to dst_names."""
+    alias_path = get_temp_file_path()
+    with open(alias_path, 'w') as f:
+        f.write('mergefonts\n')
+        f.write(f'{dst_names[0]} .notdef\n')
+        for dst, i in zip(dst_names[1:], alias_sources()):
+            f.write(f'{dst} g{i:05d}\n')
+    return alias_path
+
+
+@pytest.mark.parametrize('to_cid', [True, False])
+def test_alias_map_60k(synthetic_font, to_cid):
+    if to_cid:
+        opts = ['-cid', get_input_path('cidfontinfo.txt')]
+        dst_names = [str(i) for i in range(60001)]
+        sources = [write_alias_file(dst_names), synthetic_font]
+    else:
+        # the second source only has glyphs that are already merged
+        opts = []
+        dst_names = ['.notdef'] + [f'n{i:05d}' for i in range(60000)]
+        sources = [write_alias_file(dst_names), synthetic_font] * 2
+    actual_path = get_temp_file_path()
+    proc = subprocess.run([TOOL, '-time'] + opts + [actual_path] + sources,
+                          capture_output=True, universal_newlines=True)
+    assert proc.returncode == 0
+    lookups = 60001 * (len(sources) // 2)
+    assert (f'looked up {lookups} glyph aliases ({lookups} in alias maps'
+            in proc.stderr)
+    mtx = subprocess.check_output(['tx', '-mtx', actual_path],
+                                  stderr=subprocess.DEVNULL,
+                                  universal_newlines=True)
+    glyphs = [line for line in mtx.splitlines() if line.startswith('glyph[')]
+    assert len(glyphs) == 60001
+    # each destination glyph must have the outline of its aliased source
+    # glyph, whose height is 100 + (source glyph index) % 500
+    heights = {dst_names[0]: 100}
+    for dst, i in zip(dst_names[1:], alias_sources()):
+        heights[dst] = 100 + (i + 1) % 500
+    for line in glyphs:
+        match = re.match(r'glyph\[\d+\] \{([^,]+),[^,]+,500,'
+                         r'\{100,100,200,(\d+)\}\}$', line)
+        assert match, line
+        assert int(match.group(2)) == 100 + heights.pop(match.group(1)), line
+    assert not heights
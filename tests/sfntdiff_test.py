@@ -1,8 +1,10 @@
 import os
+import shutil
 import subprocess
 import time
 
 import pytest
+from afdko.fdkutils import get_temp_dir_path
 from differ import main as differ
 from runner import main as runner
 from test_utils import get_expected_path, get_input_path
@@ -25,7 +27,7 @@ def test_exit_known_option(arg):
     assert subprocess.call([TOOL, arg]) == 0
 
 
-@pytest.mark.parametrize('arg', ['-j', '--bogus'])
+@pytest.mark.parametrize('arg', ['-k', '--bogus'])
 def test_exit_unknown_option(arg):
     assert subprocess.call([TOOL, arg]) == 1
 
@@ -47,6 +49,38 @@ def test_diff(args, txt_filename):
     assert differ([expected_path, actual_path, '-l', '1-4'])
 
 
+@pytest.mark.parametrize('level', ['0', '1', '2', '3', '4'])
+def test_diff_identical(level):
+    # identical tables are skipped, so only the report header is printed
+    font_path = get_input_path('regular.otf')
+    output = subprocess.check_output([TOOL, '-d', level, font_path,
+                                      font_path])
+    assert len(output.splitlines()) == 4
+
+
+@pytest.mark.parametrize('level', ['0', '3'])
+def test_diff_dirs_parallel(level):
+    dir1 = get_temp_dir_path()
+    dir2 = get_temp_dir_path()
+    pairs = [('regular.otf', 'bold.otf'), ('bold.otf', 'bold.otf'),
+             ('SourceSerifPro-It.otf', 'SourceSerifPro-It.ttf'),
+             ('not_a_font_1.otf', 'not_a_font_2.otf'),
+             ('regular.otf', 'regular.otf')]
+    for i, (name1, name2) in enumerate(pairs):
+        shutil.copy(get_input_path(name1), os.path.join(dir1, f'{i}.otf'))
+        shutil.copy(get_input_path(name2), os.path.join(dir2, f'{i}.otf'))
+    serial = subprocess.run([TOOL, '-d', level, dir1, dir2],
+                            capture_output=True)
+    parallel = subprocess.run([TOOL, '-j', '3', '-d', level, dir1, dir2],
+                              capture_output=True)
+    assert parallel.returncode == serial.returncode == 0
+    # skip the time stamp
+    assert (parallel.stdout.split(b'\n', 1)[1] ==
+            serial.stdout.split(b'\n', 1)[1])
+    assert parallel.stderr.startswith(serial.stderr)
+    assert b'compared 5 file pairs' in parallel.stderr
+
+
 def test_diff_otf_vs_ttf_bug626():
     actual_path = runner(CMD + ['-s', '-f', 'SourceSerifPro-It.otf',
                                             'SourceSerifPro-It.ttf'])
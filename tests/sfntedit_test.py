@@ -1,6 +1,10 @@
+import os
 import pytest
+import shutil
 import subprocess
 
+from afdko.fdkutils import get_temp_dir_path
+
 from runner import main as runner
 from differ import main as differ
 from test_utils import (get_input_path, get_expected_path, get_temp_file_path,
@@ -108,3 +112,39 @@ def test_missing_file_add_bug_1658():
     with open(stderr_path, 'rb') as f:
         output = f.read()
     assert b'[FATAL]: file error <No such file or directory> [non_existing_GDEF_file]' in output  # noqa: E501
+
+
+def test_batch_mode():
+    # -b edits each source file in place and reports the throughput
+    temp_dir = get_temp_dir_path()
+    font_names = [LIGHT, ITALIC]
+    expected_paths = []
+    for font_name in font_names:
+        font_path = get_input_path(font_name)
+        shutil.copy(font_path, temp_dir)
+        expected_path = get_temp_file_path()
+        runner(CMD + ['-o', 'd', '_GSUB', '-f', font_path, expected_path])
+        expected_paths.append(expected_path)
+    output = subprocess.check_output([TOOL, '-d', 'GSUB', '-b'] + font_names,
+                                     cwd=temp_dir, stderr=subprocess.STDOUT)
+    assert b'[MESSAGE]: processed 2 fonts' in output
+    for font_name, expected_path in zip(font_names, expected_paths):
+        actual_path = os.path.join(temp_dir, font_name)
+        assert not font_has_table(actual_path, 'GSUB')
+        assert differ([expected_path, actual_path, '-m', 'bin'])
+    assert not os.path.exists(os.path.join(temp_dir, 'sfntedit.tmp'))
+
+
+@pytest.mark.parametrize('batch', [False, True])
+def test_script_reports_throughput_only_in_batch_mode(batch):
+    temp_dir = get_temp_dir_path()
+    shutil.copy(get_input_path(LIGHT), temp_dir)
+    if batch:
+        command = f'-d GSUB -b {LIGHT}\n'
+    else:
+        command = f'-d GSUB {LIGHT} out.otf\n'
+    with open(os.path.join(temp_dir, 'edit.scr'), 'w') as f:
+        f.write(command)
+    output = subprocess.check_output([TOOL, '-X', 'edit.scr'], cwd=temp_dir,
+                                     stderr=subprocess.STDOUT)
+    assert (b'[MESSAGE]: processed 1 fonts' in output) is batch
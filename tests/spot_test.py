@@ -1,11 +1,13 @@
+import os
 import pytest
 import re
 import subprocess
 import time
 
+from afdko.fdkutils import get_temp_file_path
 from runner import main as runner
 from differ import main as differ, SPLIT_MARKER
-from test_utils import get_expected_path
+from test_utils import get_expected_path, get_input_path
 
 TOOL = 'spot'
 CMD = ['-t', TOOL]
@@ -122,6 +124,76 @@ def test_full_unicode_ranges_bug813():
     assert differ([expected_path, actual_path])
 
 
+@pytest.mark.parametrize('workers', ['1', '3'])
+@pytest.mark.parametrize('table', ['GPOS=7', 'GSUB=7', 'hmtx', 'post'])
+def test_batch_font_list(workers, table):
+    fonts = [get_input_path(name) for name in (
+        'black.otf', 'SourceCodePro-Regular.otf', 'long_glyph_name.ttf',
+        'black.ttf', 'AdobeBlack2VF.otf', 'long_glyph_name.otf')]
+    list_path = get_temp_file_path()
+    with open(list_path, 'w') as list_file:
+        list_file.write('# batch\n\n' + '\n'.join(fonts[2:]) + '\n')
+    serial = b''.join(
+        subprocess.run([TOOL, '-t', table, font],
+                       capture_output=True).stdout for font in fonts)
+    batch = subprocess.run([TOOL, '-j', workers, '-t', table, '-L',
+                            list_path] + fonts[:2], capture_output=True)
+    assert batch.returncode == 0
+    assert batch.stdout == serial
+    stderr = batch.stderr.decode()
+    for font in fonts:
+        assert f'{font} (' in stderr
+    assert f'processed {len(fonts)} fonts' in stderr
+
+
+@pytest.mark.parametrize('table', ['GPOS=8', 'CFF_=7', 'glyf=6'])
+def test_batch_proofs(table):
+    """Proofs made by -j workers must match those of a serial run."""
+    fonts = [get_input_path(name) for name in (
+        'black.otf', 'SourceCodePro-Regular.otf', 'black.ttf',
+        'long_glyph_name.otf', 'AdobeBlack2VF.otf', 'long_glyph_name.ttf')]
+    date = re.compile(rb'\(\w{3} \w{3} [ \d]\d \d\d:\d\d:\d\d \d{4}\)')
+    outputs = [subprocess.run([TOOL] + workers + ['-t', table] + fonts,
+                              capture_output=True) for workers in
+               ([], ['-j', '3'])]
+    assert outputs[1].returncode == 0
+    assert b'%!PS' in outputs[0].stdout
+    assert (date.sub(b'()', outputs[1].stdout) ==
+            date.sub(b'()', outputs[0].stdout))
+
+
+def test_batch_missing_font_list():
+    list_path = os.path.join(os.path.dirname(get_temp_file_path()), 'none')
+    assert subprocess.call([TOOL, '-L', list_path]) == 1
+
+
+@pytest.mark.parametrize('font_name', ['SourceCodePro-Regular.otf',
+                                       'black.ttf'])
+def test_glyph_procedures_policy(font_name):
+    """Policy 8 defines glyph outlines drawn more than once as procedures.
+    Expanding each call must give back the default proof output."""
+    font_path = get_input_path(font_name)
+    date = re.compile(rb'\(\w{3} \w{3} [ \d]\d \d\d:\d\d:\d\d \d{4}\)')
+    outputs = [date.sub(b'()', subprocess.run(
+        [TOOL] + policy + ['-t', 'GPOS=8', font_path],
+        capture_output=True).stdout) for policy in ([], ['-p8'])]
+    assert b'}bind def _G' in outputs[1]
+    expanded = []
+    for page in outputs[1].split(b'%%Page:'):
+        procs = {}
+
+        def define(match):
+            procs[match.group(1)] = match.group(2)
+            return match.group(2)
+
+        page = re.sub(rb'/(_G\d+)\{\n(.*?)\}bind def \1\n', define, page,
+                      flags=re.S)
+        expanded.append(re.sub(rb'^(_G\d+)\n',
+                               lambda match: procs[match.group(1)], page,
+                               flags=re.M))
+    assert b'%%Page:'.join(expanded) == outputs[0]
+
+
 @pytest.mark.parametrize('args, input_filename', [
     (['t', '_glyf=6'], 'black.ttf'),
     (['t', '_glyf=7'], 'black.ttf'),
@@ -1,6 +1,8 @@
 import os
 import pytest
 import re
+import shutil
+import struct
 import subprocess
 import time
 
@@ -130,7 +132,8 @@ def test_option_error_wrong_mode(args):
 
 @pytest.mark.parametrize('arg', [
     '-a', '-e', '-f', '-g', '-i', '-m', '-o', '-p', '-A', '-P', '-U', '-maxs',
-    '-usefd', '-fd', '-dd', '-sd', '-sr', ['-cef', '-F'], ['-dcf', '-T']
+    '-usefd', '-fd', '-dd', '-sd', '-sr', '-j', '-cache', '-bench',
+    ['-cef', '-F'], ['-cef', '-cefsplit'], ['-dcf', '-T']
 ])
 def test_option_error_no_args_left(arg):
     if isinstance(arg, list):
@@ -142,7 +145,9 @@ def test_option_error_no_args_left(arg):
 
 @pytest.mark.parametrize('args', [
     ['-maxs', 'X'], ['-m', 'X'], ['-e', 'X'], ['-e', '5'],
-    ['-usefd', 'X'], ['-usefd', '-1']
+    ['-usefd', 'X'], ['-usefd', '-1'], ['-j', 'X'], ['-j', '0'],
+    ['-cache', 'X'], ['-cache', '-1'], ['-bench', 'X'], ['-bench', '0'],
+    ['-cef', '-cefsplit', 'X'], ['-cef', '-cefsplit', '0']
 ])
 def test_option_error_bad_arg(args):
     assert subprocess.call([TOOL, '-t1'] + args) == 1
@@ -233,6 +238,275 @@ def test_a_options(arg, filename):
     os.remove(output_path)
 
 
+@pytest.mark.parametrize('mode', ['-t1', '-dump', '-mtx', '-svg'])
+def test_a_option_parallel(mode):
+    filenames = ['type1.pfa', 'font.otf', 'cff2_vf.otf', 'cid.otf']
+    input_paths = [get_input_path(name) for name in filenames]
+    serial_dir = get_temp_dir_path()
+    parallel_dir = get_temp_dir_path()
+    subprocess.call([TOOL, mode, '-dd', serial_dir, '-a'] + input_paths)
+    stderr_path = get_temp_file_path()
+    with open(stderr_path, 'w') as f:
+        assert subprocess.call([TOOL, mode, '-j', '3', '-dd', parallel_dir,
+                                '-a'] + input_paths, stderr=f) == 0
+    with open(stderr_path) as f:
+        assert 'processed 4 of 4 files' in f.read()
+    for name in filenames:
+        out_name = f'{os.path.splitext(name)[0]}.{mode[1:]}'
+        with open(os.path.join(serial_dir, out_name), 'rb') as f1, \
+                open(os.path.join(parallel_dir, out_name), 'rb') as f2:
+            assert f1.read() == f2.read()
+
+
+def test_a_option_parallel_same_dst():
+    # Both sources map to font.svg. The first takes much longer to process,
+    # so without ordering its output would replace that of the second,
+    # which must win as when processed serially.
+    slow_dir = get_temp_dir_path()
+    fast_dir = get_temp_dir_path()
+    shutil.copy(get_input_path('FDArrayTest257FontDicts.otf'),
+                os.path.join(slow_dir, 'font.otf'))
+    shutil.copy(get_input_path('type1.pfa'), os.path.join(fast_dir, 'font.pfa'))
+    input_paths = [os.path.join(slow_dir, 'font.otf'),
+                   os.path.join(fast_dir, 'font.pfa'),
+                   get_input_path('cid.otf')]
+    serial_dir = get_temp_dir_path()
+    parallel_dir = get_temp_dir_path()
+    subprocess.call([TOOL, '-svg', '-dd', serial_dir, '-a'] + input_paths)
+    assert subprocess.call([TOOL, '-svg', '-j', '3', '-dd', parallel_dir,
+                            '-a'] + input_paths) == 0
+    assert sorted(os.listdir(parallel_dir)) == ['cid.svg', 'font.svg']
+    for name in ['cid.svg', 'font.svg']:
+        with open(os.path.join(serial_dir, name), 'rb') as f1, \
+                open(os.path.join(parallel_dir, name), 'rb') as f2:
+            assert f1.read() == f2.read()
+
+
+def test_a_option_parallel_error():
+    input_path = get_input_path('type1.pfa')
+    bad_path = get_input_path('nonexistent.pfa')
+    out_dir = get_temp_dir_path()
+    assert subprocess.call([TOOL, '-t1', '-j', '2', '-dd', out_dir,
+                            '-a', input_path, bad_path]) == 1
+    assert os.path.exists(os.path.join(out_dir, 'type1.t1'))
+
+
+def test_a_option_parallel_error_in_batch():
+    # A file that fails in a -j worker ends only that worker; the batch goes
+    # on in the parent with the next command, which is run once.
+    font_path = get_input_path('font.otf')
+    out_dir = get_temp_dir_path()
+    lines = [f'-t1 -j 2 -dd "{out_dir}" -a "{get_input_path("type1.pfa")}" '
+             f'"{get_input_path("nonexistent.pfa")}"',
+             f'-dump -0 "{font_path}"']
+    proc = subprocess.run([TOOL, '-batch', '-'], input='\n'.join(lines).encode(),
+                          capture_output=True)
+    assert proc.returncode == 1
+    assert proc.stdout == subprocess.check_output([TOOL, '-dump', '-0',
+                                                   font_path])
+    assert b'[2/2] failed' in proc.stderr
+    assert b'ran 2 commands (1 failed)' in proc.stderr
+    assert os.path.exists(os.path.join(out_dir, 'type1.t1'))
+
+
+def test_batch_mode():
+    font_path = get_input_path('font.otf')
+    pfa_path = get_input_path('type1.pfa')
+    t1_path = get_temp_file_path()
+    commands = [['-dump', '-0', font_path],
+                ['-mtx', '-3', pfa_path],
+                ['-t1', '-o', t1_path, font_path]]
+    expected = b''.join(subprocess.check_output([TOOL] + args)
+                        for args in commands[:2])
+    expected_t1_path = get_temp_file_path()
+    subprocess.check_call([TOOL, '-t1', '-o', expected_t1_path, font_path])
+
+    lines = [' '.join(f'"{arg}"' for arg in args) for args in commands]
+    lines.insert(1, '# comment')
+    lines.insert(2, f'-dump {get_input_path("nonexistent.otf")}')
+    proc = subprocess.run([TOOL, '-batch', '-'], input='\n'.join(lines).encode(),
+                          capture_output=True)
+    assert proc.returncode == 1
+    assert proc.stdout == expected
+    assert b'[2] failed' in proc.stderr
+    assert b'ran 4 commands (1 failed)' in proc.stderr
+    with open(t1_path, 'rb') as f1, open(expected_t1_path, 'rb') as f2:
+        assert f1.read() == f2.read()
+
+
+def test_batch_mode_many_commands():
+    # Every command is run twice, so later ones reuse the library contexts of
+    # earlier commands for the same mode and font format
+    fonts = ['font.otf', 'type1.pfa', 'font.ttf', 'cid.otf', 'cff2_vf.otf',
+             'zx.pfb', 'AdobeVFPrototype.ttf']
+    modes = [['-dump', '-0'], ['-dump', '-4'], ['-mtx', '-3'], ['-path'],
+             ['-t1'], ['-cff']]
+    commands = []
+    for mode in modes:
+        for font in fonts:
+            args = mode + [get_input_path(font)]
+            if mode[0] in ('-t1', '-cff'):
+                args += [get_temp_file_path()]
+            commands.append(args)
+    commands += [args[:-1] + [get_temp_file_path()]
+                 if args[0] in ('-t1', '-cff') else args
+                 for args in commands]
+
+    expected = []
+    for args in commands:
+        proc = subprocess.run([TOOL] + args, capture_output=True)
+        assert proc.returncode == 0
+        if args[0] in ('-t1', '-cff'):
+            with open(args[-1], 'rb') as f:
+                expected.append(f.read())
+        else:
+            expected.append(proc.stdout)
+
+    control_path = get_temp_file_path()
+    with open(control_path, 'w') as f:
+        for args in commands:
+            f.write(' '.join(f'"{arg}"' for arg in args) + '\n')
+    proc = subprocess.run([TOOL, '-batch', control_path], capture_output=True)
+    assert proc.returncode == 0
+    stdout = b''.join(data for args, data in zip(commands, expected)
+                      if args[0] not in ('-t1', '-cff'))
+    assert proc.stdout == stdout
+    for args, data in zip(commands, expected):
+        if args[0] in ('-t1', '-cff'):
+            with open(args[-1], 'rb') as f:
+                assert f.read() == data, args
+    stderr = proc.stderr.decode()
+    assert re.findall(r'^tx: \[(\d+)\] done in [\d.]+ ms$', stderr,
+                      re.MULTILINE) == [str(i + 1)
+                                        for i in range(len(commands))]
+    assert f'ran {len(commands)} commands (0 failed) in' in stderr
+
+
+def _glyph_cache_stats(args, size):
+    """Run tx with and without -cache <size>, check that the cache leaves
+    the output unchanged, and return the counters tx reports for each font
+    as (hits, misses, evictions, glyphs) tuples."""
+    expected = subprocess.check_output([TOOL] + args)
+    proc = subprocess.run([TOOL, '-cache', size] + args, capture_output=True,
+                          universal_newlines=True)
+    assert proc.returncode == 0
+    assert proc.stdout == expected.decode()
+    return [tuple(int(n) for n in m) for m in re.findall(
+        r'glyph cache: (\d+) hits, (\d+) misses \([\d.]+% hit rate\), '
+        r'(\d+) evictions, (\d+) glyphs in \d+ bytes', proc.stderr)]
+
+
+GLYPHS_TWICE = ['-g', '0-3,0-3,1']  # 9 requests for 4 glyphs
+
+
+@pytest.mark.parametrize('args, stats', [
+    (['-mtx'] + GLYPHS_TWICE + ['font.otf'], [(5, 4, 0, 4)]),
+    (['-dump', '-6'] + GLYPHS_TWICE + ['cid.otf'], [(5, 4, 0, 4)]),
+    (['-dump', '-6'] + GLYPHS_TWICE + ['cff2_vf.otf'], [(5, 4, 0, 4)]),
+    (['-mtx', '-3'] + GLYPHS_TWICE + ['seac.otf'], [(5, 4, 0, 4)]),
+    # the members of shared_cff.ttc share one CFF table, so only the first
+    # member's glyphs are decoded
+    (['-mtx', '-y', 'shared_cff.ttc'],
+     [(0, 5, 0, 5), (5, 0, 0, 5), (5, 0, 0, 5)]),
+])
+def test_glyph_cache(args, stats):
+    args = args[:-1] + [get_input_path(args[-1])]
+    assert _glyph_cache_stats(args, '64') == stats
+
+
+@pytest.mark.parametrize('font_filename', ['cid.otf', 'cff2_vf.otf'])
+def test_glyph_cache_evictions(font_filename):
+    # a 1 KB cache can't hold these glyphs, so some are decoded again
+    args = ['-dump', '-6'] + GLYPHS_TWICE + [get_input_path(font_filename)]
+    [(hits, misses, evictions, glyphs)] = _glyph_cache_stats(args, '1')
+    assert hits + misses == 9
+    assert misses > 4
+    assert evictions > 0
+    assert glyphs < 4
+
+
+@pytest.mark.parametrize('args, reports', [
+    # CFF2, with blending at the -U instance
+    (['-mtx', '-U', '500,500', 'CJK-VarTest.otf'],
+     [r'decoded 2 glyphs 3 times in']),
+    (['-mtx', '-U', '900,0', 'AdobeVFPrototype_mod.otf'],
+     [r'decoded 313 glyphs 3 times in']),
+    # TrueType, with gvar deltas applied at the -U instance
+    (['-mtx', '-U', '600,40', 'AdobeVFPrototype.ttf'],
+     [r'decoded 313 glyphs 3 times in']),
+    # Type 1 parse
+    (['-dump', '-6', 'type1.pfa'],
+     [r'parsed 0\.00 MB font \(5 glyphs\) 3 times in .* MB/sec\)']),
+    (['-dump', '-6', 'type1.pfb'],
+     [r'parsed 0\.00 MB font \(5 glyphs\) 3 times in .* MB/sec\)']),
+    (['-dump', '-6', 'zy.pfb'],
+     [r'parsed 0\.09 MB font \(230 glyphs\) 3 times in .* MB/sec\)']),
+    (['-dump', '-6', 'cidfont-noPSname.ps'],
+     [r'parsed 0\.01 MB font \(4 glyphs\) 3 times in .* MB/sec\)']),
+    # multiple master instances, made by parsing and by t1rSetInstance()
+    (['-mtx', '-U', '400,600', 'zx.pfb'],
+     [r'parsed 0\.07 MB font \(230 glyphs\) 3 times in',
+      r'made 3 instances of 230 glyphs by parsing in .* instances/sec\)',
+      r'made 3 instances of 230 glyphs by t1rSetInstance in '
+      r'.* instances/sec\)']),
+    (['-mtx', '-U', '1000,1000', 'zy.pfb'],
+     [r'parsed 0\.09 MB font \(230 glyphs\) 3 times in',
+      r'made 3 instances of 230 glyphs by parsing in .* instances/sec\)',
+      r'made 3 instances of 230 glyphs by t1rSetInstance in '
+      r'.* instances/sec\)']),
+    # Type 1 write, after the source library's own benchmark if any
+    (['-t1', 'type1.pfa'],
+     [r'parsed 0\.00 MB font \(5 glyphs\) 3 times in',
+      r'wrote 0\.00 MB font 3 times in .* MB/sec\)']),
+    (['-t1', 'cid.otf'],
+     [r'decoded 4 glyphs 3 times in',
+      r'wrote 0\.01 MB font 3 times in .* MB/sec\)']),
+    (['-t1', '-decid', '-fd', '1', 'cidkeyed-with-multiple-fdicts.ufo'],
+     [r'wrote 0\.01 MB font 3 times in .* MB/sec\)']),
+    (['-t1', '-1', '-c', 'SourceSansPro-Regular-cff2-unused-post.otf'],
+     [r'decoded 2 glyphs 3 times in',
+      r'wrote 0\.00 MB font 3 times in .* MB/sec\)']),
+    (['-t1', '-e', '0', 'AdobeVFPrototype.ttf'],
+     [r'decoded 313 glyphs 3 times in',
+      r'wrote 0\.09 MB font 3 times in .* MB/sec\)']),
+])
+def test_bench_option(args, reports):
+    """-bench 3 leaves the output unchanged and reports, in order, what it
+    ran with the repetition and glyph counts of the font."""
+    args = args[:-1] + [get_input_path(args[-1])]
+    expected = subprocess.check_output([TOOL] + args)
+    proc = subprocess.run([TOOL, '-bench', '3'] + args, capture_output=True)
+    assert proc.returncode == 0
+    assert proc.stdout == expected
+    found = re.findall(r'^tx: ((?:decoded|parsed|made|wrote) .*)$',
+                       proc.stderr.decode(), re.MULTILINE)
+    assert len(found) == len(reports)
+    for line, report in zip(found, reports):
+        assert re.match(report, line)
+
+
+@pytest.mark.parametrize('font_filename, mode', [
+    ('zx.pfb', '-3'), ('zy.pfb', '-3'), ('zy.pfb', '-t1'), ('zy.pfb', '-mtx'),
+    ('cff2_vf.otf', '-3'), ('AdobeVFPrototype.ttf', '-3')])
+def test_U_option_repeated(font_filename, mode):
+    """Repeated -U makes one font per instance. A multiple master Type 1
+    font is switched from the first instance to the others with
+    t1rSetInstance(), so its dicts and glyphs must match those of the font
+    parsed directly at each instance."""
+    font_path = get_input_path(font_filename)
+    mode_args = ['-dump', mode] if mode == '-3' else [mode]
+    instances = ['400,600', '50,900', '1000,1000']
+    outputs = [subprocess.check_output([TOOL] + mode_args + ['-U', uds,
+                                                             font_path])
+               for uds in instances]
+    assert len(set(outputs)) == len(instances)
+    args = list(mode_args)
+    for uds in instances:
+        args += ['-U', uds]
+    assert subprocess.check_output([TOOL] + args + [font_path]) == \
+        b''.join(outputs)
+
+
 def test_o_option():
     input_path = get_input_path('ufo3.ufo')
     expected_path = get_expected_path('ufo3.pfa')
@@ -373,6 +647,70 @@ def test_cef_cefsvg():
     assert differ([expected_path, output_path])
 
 
+@pytest.mark.parametrize('bench', [False, True])
+@pytest.mark.parametrize('font_name', ['type1.pfa', 'font.ttf', 'cid.otf'])
+def test_cef_split(font_name, bench):
+    # Each part made from the held font must be the same as the font made
+    # from that part's glyphs alone, also after -bench has made the parts
+    # by reparsing and from the held font
+    font_path = get_input_path(font_name)
+    output = subprocess.check_output([TOOL, '-mtx', '-0', font_path])
+    num_glyphs = output.count(b'\nglyph[')
+    out_dir = get_temp_dir_path()
+    split_path = os.path.join(out_dir, 'split.cef')
+    bench_args = ['-bench', '2'] if bench else []
+    proc = subprocess.run([TOOL, '-cef', '-cefsplit', '3'] + bench_args +
+                          [font_path, split_path], capture_output=True,
+                          universal_newlines=True)
+    assert proc.returncode == 0
+    found = re.findall(r'^tx: made 6 subsets \(3 parts 2 times\) '
+                       r'(by parsing|from the held font) in .* subsets/sec\)$',
+                       proc.stderr, re.MULTILINE)
+    assert found == (['by parsing', 'from the held font'] if bench else [])
+    for i in range(3):
+        first = i * num_glyphs // 3
+        last = (i + 1) * num_glyphs // 3 - 1
+        part_path = os.path.join(out_dir, f'part{i + 1}.cef')
+        subprocess.check_output([TOOL, '-cef', '-g', f'{first}-{last}',
+                                 font_path, part_path])
+        with open(f'{split_path}.{i + 1}', 'rb') as f1, \
+                open(part_path, 'rb') as f2:
+            assert f1.read() == f2.read()
+
+
+def _sfnt_checksum(data):
+    data += b'\0' * (-len(data) % 4)
+    return sum(struct.unpack(f'>{len(data) // 4}L', data)) & 0xffffffff
+
+
+@pytest.mark.parametrize('args', [
+    ['font.otf'], ['cid.otf'], ['font.ttf'], ['AdobeVFPrototype.ttf'],
+    ['-g', '2-9', 'cid.otf'], ['-cefsplit', '2', 'type1.pfa'],
+])
+def test_cef_sfnt_checksums(args):
+    # tx -cef is written by cfembed through sfntwrite, which checksums the
+    # tables as they are written; check the directory against the data
+    out_dir = get_temp_dir_path()
+    output_path = os.path.join(out_dir, 'font.cef')
+    subprocess.check_output([TOOL, '-cef'] + args[:-1] +
+                            [get_input_path(args[-1]), output_path])
+    paths = [output_path]
+    if '-cefsplit' in args:
+        paths = [f'{output_path}.{i + 1}' for i in range(int(args[-2]))]
+    for path in paths:
+        with open(path, 'rb') as f:
+            data = f.read()
+        num_tables = struct.unpack('>H', data[4:6])[0]
+        tags = []
+        for i in range(num_tables):
+            tag, checksum, offset, length = struct.unpack(
+                '>4sLLL', data[12 + 16 * i:28 + 16 * i])
+            assert checksum == _sfnt_checksum(data[offset:offset + length])
+            tags.append(tag)
+        # cfembed writes no head table, so there is no checkSumAdjustment
+        assert tags == [b'CFF ', b'cmap']
+
+
 @pytest.mark.parametrize('file_ext', [
     'pfa', 'pfabin', 'pfb', 'lwfn', 'bidf'])  # TODO: 'bidf85'
 def test_type1_inputs(file_ext):
@@ -951,6 +1289,27 @@ def test_ttread_varinst():
     assert differ([expected_path, save_path, '-s', '## Filename'])
 
 
+@pytest.mark.parametrize('args', [[], ['-U', '900,0']])
+def test_ttread_lazy_subset(args):
+    # glyphs of a -g subset are read on demand; each must match the same
+    # glyph read with the rest of the font. Glyph 312 is past the hmtx long
+    # metrics and glyph 19 is a compound glyph.
+    font_path = get_input_path('AdobeVFPrototype.ttf')
+
+    def glyphs(output):
+        return {block.split(b' ')[0]: block.strip()
+                for block in output.split(b'\nglyph')[1:]}
+
+    full = subprocess.check_output([TOOL, '-dump', '-6'] + args + [font_path])
+    subset = subprocess.check_output(
+        [TOOL, '-dump', '-6', '-g', '312,19,3,0'] + args + [font_path])
+    subset = glyphs(subset)
+    assert sorted(subset) == [b'[0]', b'[19]', b'[312]', b'[3]']
+    full = glyphs(full)
+    for tag, block in subset.items():
+        assert block == full[tag]
+
+
 def test_unused_post2_names():
     font_path = get_input_path('SourceSansPro-Regular-cff2-unused-post.otf')
     save_path = get_temp_file_path()